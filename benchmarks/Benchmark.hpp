@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_BENCHMARK_HPP
+#define ILLUSION_BENCHMARK_HPP
+
+#include <Illusion/Core/Logger.hpp>
+#include <Illusion/Core/Timer.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Some tiny helpers which are shared by all benchmarks. There is no benchmarking library in the  //
+// externals, so we simply run each measured function several times and report the fastest run.   //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Illusion::Benchmark {
+
+// Executes the given function repetitions times and returns the fastest run in seconds. The first
+// call is not measured, it is used to warm up caches and allocators.
+template <typename F>
+double measure(F&& f, uint32_t repetitions = 5) {
+  f();
+
+  double best = std::numeric_limits<double>::max();
+  for (uint32_t i(0); i < repetitions; ++i) {
+    Core::Timer timer;
+    f();
+    best = std::min(best, timer.getElapsed());
+  }
+
+  return best;
+}
+
+// Prints one line of a result table. The throughput is computed from the given number of items
+// which have been processed in the given time.
+inline void print(std::string const& name, double seconds, double items = 0.0) {
+  auto& os = Core::Logger::message();
+  os << std::left << std::setw(50) << name << std::right << std::setw(12) << std::fixed
+     << std::setprecision(3) << seconds * 1000.0 << " ms";
+  if (items > 0.0) {
+    os << std::setw(14) << std::setprecision(2) << items / seconds / 1000000.0 << " M items/s";
+  }
+  os << std::endl;
+}
+
+} // namespace Illusion::Benchmark
+
+#endif // ILLUSION_BENCHMARK_HPP
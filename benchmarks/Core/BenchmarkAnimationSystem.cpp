@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/AnimationSystem.hpp>
+
+#include <vector>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark animates 100.000 Float Properties with mixed easing directions. The reference   //
+// is an array of animation structs which are updated one after another with the same algorithm   //
+// as AnimatedProperty::update(). This is compared to the batched AnimationSystem - once with     //
+// all animations running and once with all of them still waiting for their delay to pass.        //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const size_t ANIMATION_COUNT = 100000;
+const size_t FRAME_COUNT     = 10;
+const double FRAME_TIME      = 1.0 / 60.0;
+
+// An AnimatedProperty<float> can not be instantiated, as its operator=(T const&) accesses members
+// of T. Therefore this mimics its update() for the reference measurement.
+struct Animation {
+  Core::Float*             mTarget;
+  Core::AnimationDirection mDirection;
+  float                    mStart;
+  float                    mEnd;
+  double                   mDuration;
+  double                   mExponent = 0.0;
+  double                   mDelay    = 0.0;
+  double                   mState    = 0.0;
+
+  float easeIn(double t, double s, double e) const {
+    return static_cast<float>(s + (t * t * ((mExponent + 1) * t - mExponent)) * (e - s));
+  }
+
+  float easeOut(double t, double s, double e) const {
+    return static_cast<float>(
+        s + ((t - 1) * (t - 1) * ((mExponent + 1) * (t - 1) + mExponent) + 1) * (e - s));
+  }
+
+  void update(double time) {
+    if (mState >= 1.0) {
+      return;
+    }
+
+    if (mDelay > 0) {
+      mDelay -= time;
+      return;
+    }
+
+    mState   = std::min(mState + time / mDuration, 1.0);
+    double m = mStart + (mEnd - mStart) * 0.5;
+
+    switch (mDirection) {
+      case Core::AnimationDirection::eLinear:
+        mTarget->set(static_cast<float>(mStart + mState * (mEnd - mStart)));
+        break;
+      case Core::AnimationDirection::eIn:
+        mTarget->set(easeIn(mState, mStart, mEnd));
+        break;
+      case Core::AnimationDirection::eOut:
+        mTarget->set(easeOut(mState, mStart, mEnd));
+        break;
+      case Core::AnimationDirection::eInOut:
+        mTarget->set(
+            mState < 0.5 ? easeIn(mState * 2, mStart, m) : easeOut(mState * 2 - 1, m, mEnd));
+        break;
+      case Core::AnimationDirection::eOutIn:
+        mTarget->set(
+            mState < 0.5 ? easeOut(mState * 2, mStart, m) : easeIn(mState * 2 - 1, m, mEnd));
+        break;
+    }
+  }
+};
+
+Core::AnimationDirection getDirection(size_t i) {
+  return static_cast<Core::AnimationDirection>(i % 5);
+}
+
+} // namespace
+
+int main() {
+  std::vector<Core::Float> properties(ANIMATION_COUNT);
+
+  // The animations last much longer than the measured frames, so that all of them stay active
+  // during the entire benchmark. In the second run, all animations are still waiting for their
+  // delay to pass; in this case no Property has to be set at all.
+  for (double delay : {0.0, 1000.0}) {
+    std::string suffix = delay > 0.0 ? " (waiting)" : " (running)";
+
+    std::vector<Animation> animations(ANIMATION_COUNT);
+    for (size_t i(0); i < ANIMATION_COUNT; ++i) {
+      animations[i] = {&properties[i], getDirection(i), 0.f, 1.f, 1000.0, 0.0, delay};
+    }
+
+    Benchmark::print("Individual updates" + suffix,
+        Benchmark::measure([&]() {
+          for (size_t f(0); f < FRAME_COUNT; ++f) {
+            for (auto& animation : animations) {
+              animation.update(FRAME_TIME);
+            }
+          }
+        }) / FRAME_COUNT,
+        ANIMATION_COUNT);
+
+    Core::AnimationSystem system;
+    for (size_t i(0); i < ANIMATION_COUNT; ++i) {
+      properties[i].set(0.f);
+      system.animate(properties[i], 1.f, 1000.0, getDirection(i), Core::AnimationLoop::eNone, 0.0,
+          delay);
+    }
+
+    Benchmark::print("AnimationSystem" + suffix,
+        Benchmark::measure([&]() {
+          for (size_t f(0); f < FRAME_COUNT; ++f) {
+            system.update(FRAME_TIME);
+          }
+        }) / FRAME_COUNT,
+        ANIMATION_COUNT);
+  }
+
+  // Print one of the results so that the compiler cannot optimize the updates away.
+  Core::Logger::debug() << "Value: " << properties[ANIMATION_COUNT / 2].get() << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/BitHash.hpp>
+
+#include <map>
+#include <unordered_map>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark compares the packed Core::BitHash with its previous implementation, which was   //
+// derived from std::vector<bool> and pushed one bit at a time. The keys are built similar to the //
+// pipeline keys of the CommandBuffer: a GraphicsState hash, some ShaderModule handles, the       //
+// RenderPass and the subpass index. The old keys are looked up in a std::map, the new ones in a  //
+// std::unordered_map.                                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint32_t PIPELINE_COUNT = 256;
+const uint32_t LOOKUP_COUNT   = 10000;
+
+// This is how the BitHash used to be implemented.
+class LegacyBitHash : public std::vector<bool> {
+ public:
+  template <uint32_t bitCount, typename T>
+  void push(T const& value) {
+    uint64_t mask(1);
+    uint64_t castedValue(0);
+
+    std::memcpy(&castedValue, &value, sizeof(T));
+
+    for (uint32_t i(0); i < bitCount; ++i) {
+      push_back((castedValue & mask));
+      mask = mask << 1;
+    }
+  }
+};
+
+// Pushes roughly the same amount of data as GraphicsState::getHash() and
+// CommandBuffer::getPipelineHandle() do for a typical pipeline. Only the pipeline index makes the
+// keys differ, similar to different shaders with the same state.
+template <typename H>
+H createKey(uint32_t pipeline) {
+  H hash;
+
+  hash.template push<1>(false);
+  hash.template push<4>(3u);
+  for (uint32_t i(0); i < 2; ++i) {
+    hash.template push<1>(true);
+    hash.template push<5>(6u);
+    hash.template push<5>(7u);
+    hash.template push<3>(0u);
+    hash.template push<5>(1u);
+    hash.template push<5>(0u);
+    hash.template push<3>(0u);
+    hash.template push<4>(15u);
+  }
+  for (uint32_t i(0); i < 20; ++i) {
+    hash.template push<3>(i);
+  }
+  for (uint32_t i(0); i < 3; ++i) {
+    hash.template push<32>(i);
+    hash.template push<32>(48u);
+    hash.template push<1>(0u);
+  }
+  for (uint32_t i(0); i < 4; ++i) {
+    hash.template push<32>(i);
+    hash.template push<32>(0u);
+    hash.template push<32>(106u);
+    hash.template push<32>(i * 16);
+  }
+  hash.template push<32>(1u);
+  hash.template push<32>(1u);
+
+  // The ShaderModules, the RenderPass and the subpass.
+  hash.template push<64>(uint64_t(0x7f0000001000) + pipeline * 64);
+  hash.template push<64>(uint64_t(0x7f0000002000) + pipeline * 64);
+  hash.template push<64>(uint64_t(0x7f0000003000));
+  hash.template push<32>(0u);
+
+  return hash;
+}
+
+} // namespace
+
+int main() {
+  uint32_t found = 0;
+
+  Benchmark::print("LegacyBitHash construction",
+      Benchmark::measure([&]() {
+        for (uint32_t i(0); i < LOOKUP_COUNT; ++i) {
+          found += createKey<LegacyBitHash>(i % PIPELINE_COUNT).size() > 0;
+        }
+      }),
+      LOOKUP_COUNT);
+
+  Benchmark::print("BitHash construction",
+      Benchmark::measure([&]() {
+        for (uint32_t i(0); i < LOOKUP_COUNT; ++i) {
+          found += createKey<Core::BitHash>(i % PIPELINE_COUNT).size() > 0;
+        }
+      }),
+      LOOKUP_COUNT);
+
+  std::map<LegacyBitHash, uint32_t>           legacyCache;
+  std::unordered_map<Core::BitHash, uint32_t> cache;
+  std::vector<LegacyBitHash>                  legacyKeys;
+  std::vector<Core::BitHash>                  keys;
+
+  for (uint32_t i(0); i < PIPELINE_COUNT; ++i) {
+    legacyKeys.push_back(createKey<LegacyBitHash>(i));
+    keys.push_back(createKey<Core::BitHash>(i));
+    legacyCache[legacyKeys.back()] = i;
+    cache[keys.back()]             = i;
+  }
+
+  // The keys are already constructed, only the lookup is measured.
+  Benchmark::print("LegacyBitHash std::map lookup",
+      Benchmark::measure([&]() {
+        for (uint32_t i(0); i < LOOKUP_COUNT; ++i) {
+          found += legacyCache.find(legacyKeys[i % PIPELINE_COUNT])->second;
+        }
+      }),
+      LOOKUP_COUNT);
+
+  Benchmark::print("BitHash std::unordered_map lookup",
+      Benchmark::measure([&]() {
+        for (uint32_t i(0); i < LOOKUP_COUNT; ++i) {
+          found += cache.find(keys[i % PIPELINE_COUNT])->second;
+        }
+      }),
+      LOOKUP_COUNT);
+
+  // Print the result so that the compiler cannot optimize the lookups away.
+  Core::Logger::debug() << "Found: " << found << std::endl;
+
+  return 0;
+}
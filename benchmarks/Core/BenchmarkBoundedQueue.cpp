@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/BoundedQueue.hpp>
+#include <Illusion/Core/Queue.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark measures the throughput of the mutex based Core::Queue and the lock-free        //
+// Core::BoundedQueue with 1 to N producers and consumers. Each producer pushes the same number   //
+// of values, the consumers pop until all values have been received. For the BoundedQueue, the    //
+// bulk operations are measured as well.                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint32_t VALUE_COUNT = 1000000;
+const uint32_t BULK_SIZE   = 16;
+
+// Pushes the values with the given function and pops them with the other. Both functions return
+// the number of values which have been transferred.
+template <typename Push, typename Pop>
+void run(uint32_t producers, uint32_t consumers, Push const& push, Pop const& pop) {
+  std::vector<std::thread> threads;
+  std::atomic<uint32_t>    received{0};
+
+  for (uint32_t p(0); p < producers; ++p) {
+    threads.emplace_back([&]() {
+      uint32_t count = VALUE_COUNT / producers;
+      for (uint32_t i(0); i < count;) {
+        uint32_t pushed = push(count - i);
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+        i += pushed;
+      }
+    });
+  }
+
+  for (uint32_t c(0); c < consumers; ++c) {
+    threads.emplace_back([&]() {
+      uint32_t total = VALUE_COUNT / producers * producers;
+      while (received < total) {
+        uint32_t popped = pop();
+        if (popped == 0) {
+          std::this_thread::yield();
+        }
+        received += popped;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace
+
+int main() {
+  uint32_t maxThreads = std::max(2u, std::thread::hardware_concurrency());
+
+  for (uint32_t threads(1); threads <= maxThreads; threads *= 2) {
+    std::string suffix =
+        " (" + std::to_string(threads) + " producers, " + std::to_string(threads) + " consumers)";
+
+    Benchmark::print("Queue" + suffix,
+        Benchmark::measure(
+            [&]() {
+              Core::Queue<uint32_t> queue;
+              run(threads, threads,
+                  [&](uint32_t) {
+                    queue.push(42u);
+                    return 1u;
+                  },
+                  [&]() {
+                    uint32_t value;
+                    return queue.pop(value) ? 1u : 0u;
+                  });
+            },
+            3),
+        VALUE_COUNT);
+
+    Benchmark::print("BoundedQueue" + suffix,
+        Benchmark::measure(
+            [&]() {
+              Core::BoundedQueue<uint32_t> queue(1024);
+              run(threads, threads, [&](uint32_t) { return queue.tryPush(42u) ? 1u : 0u; },
+                  [&]() {
+                    uint32_t value;
+                    return queue.tryPop(value) ? 1u : 0u;
+                  });
+            },
+            3),
+        VALUE_COUNT);
+
+    Benchmark::print("BoundedQueue bulk" + suffix,
+        Benchmark::measure(
+            [&]() {
+              Core::BoundedQueue<uint32_t> queue(1024);
+              run(threads, threads,
+                  [&](uint32_t remaining) {
+                    uint32_t values[BULK_SIZE] = {};
+                    return static_cast<uint32_t>(
+                        queue.tryPush(values, std::min(remaining, BULK_SIZE)));
+                  },
+                  [&]() {
+                    uint32_t values[BULK_SIZE];
+                    return static_cast<uint32_t>(queue.tryPop(values, BULK_SIZE));
+                  });
+            },
+            3),
+        VALUE_COUNT);
+  }
+
+  return 0;
+}
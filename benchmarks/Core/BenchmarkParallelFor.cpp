@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/ParallelFor.hpp>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark compares parallelFor() and parallelReduce() with a serial loop for several      //
+// problem sizes. The loop body is a small transformation similar to converting a vertex          //
+// attribute. For small problem sizes, the automatic grain size selection should make the         //
+// parallel versions about as fast as the serial loop.                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+float transform(float value) {
+  return std::sqrt(value * 0.5f + 1.f);
+}
+
+} // namespace
+
+int main() {
+  Core::ThreadPool pool(0, Core::ThreadPool::Scheduling::eWorkStealing);
+
+  Core::Logger::message() << "Using " << pool.getThreadCount() << " threads." << std::endl;
+
+  for (size_t size : {1000, 10000, 100000, 1000000, 10000000}) {
+    std::vector<float> input(size, 1.f);
+    std::vector<float> output(size);
+
+    std::string suffix = " (" + std::to_string(size) + " items)";
+
+    // Small problem sizes are repeated several times as the Timer only has a resolution of one
+    // microsecond. The reported time is per repetition.
+    size_t rounds = 10000000 / size;
+    auto   repeat = [rounds](auto const& f) {
+      return [rounds, &f]() {
+        for (size_t r(0); r < rounds; ++r) {
+          f();
+        }
+      };
+    };
+
+    Benchmark::print("Serial for" + suffix,
+        Benchmark::measure(repeat([&]() {
+          for (size_t i(0); i < size; ++i) {
+            output[i] = transform(input[i]);
+          }
+        })) / rounds,
+        size);
+
+    Benchmark::print("parallelFor" + suffix,
+        Benchmark::measure(repeat([&]() {
+          Core::parallelFor(pool, 0, size, [&](size_t i) { output[i] = transform(input[i]); });
+        })) / rounds,
+        size);
+
+    float serialSum = 0.f;
+    Benchmark::print("Serial reduce" + suffix,
+        Benchmark::measure(repeat([&]() {
+          serialSum = 0.f;
+          for (size_t i(0); i < size; ++i) {
+            serialSum += transform(input[i]);
+          }
+        })) / rounds,
+        size);
+
+    float parallelSum = 0.f;
+    Benchmark::print("parallelReduce" + suffix,
+        Benchmark::measure(repeat([&]() {
+          parallelSum = Core::parallelReduce(pool, 0, size, 0.f,
+              [&](size_t i) { return transform(input[i]); }, std::plus<float>());
+        })) / rounds,
+        size);
+
+    // Print the results so that the compiler cannot optimize the loops away.
+    Core::Logger::debug() << "Sums: " << serialSum << " " << parallelSum << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/Profiler.hpp>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark measures the overhead of profiler zones. Each frame enters 10.000 nested zones  //
+// on the calling thread and is finished with Profiler::nextFrame(). This is done with a disabled //
+// and with an enabled Profiler; the reported throughput is the number of zones per second.       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const size_t ZONE_COUNT  = 10000;
+const size_t FRAME_COUNT = 100;
+
+// The volatile counter prevents the compiler from removing the loops.
+volatile size_t counter = 0;
+
+void runFrames() {
+  for (size_t f(0); f < FRAME_COUNT; ++f) {
+    for (size_t i(0); i < ZONE_COUNT / 2; ++i) {
+      ILLUSION_PROFILE_ZONE("Outer");
+      {
+        ILLUSION_PROFILE_ZONE("Inner");
+        counter = counter + 1;
+      }
+    }
+    Core::Profiler::nextFrame();
+  }
+}
+
+} // namespace
+
+int main() {
+  Core::Profiler::setEnabled(false);
+  Benchmark::print("Disabled profiler", Benchmark::measure(runFrames), ZONE_COUNT * FRAME_COUNT);
+
+  Core::Profiler::setEnabled(true);
+  Benchmark::print("Enabled profiler", Benchmark::measure(runFrames), ZONE_COUNT * FRAME_COUNT);
+
+  return 0;
+}
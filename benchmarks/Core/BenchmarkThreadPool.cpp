@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/ThreadPool.hpp>
+
+#include <atomic>
+#include <cmath>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark measures the task throughput of the ThreadPool for both scheduling modes with   //
+// an increasing number of worker threads. Each task does a tiny amount of work only, so the      //
+// overhead of the scheduler dominates. There are three scenarios: In the first, all tasks are    //
+// enqueued from the main thread. The second does the same with the fire-and-forget submit(). In  //
+// the third, a few root tasks enqueue the actual tasks from within the worker threads, which is  //
+// the typical fork-join pattern.                                                                 //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint32_t TASK_COUNT = 200000;
+const uint32_t ROOT_TASKS = 64;
+
+// Some work to make the tasks not completely empty.
+void doWork(std::atomic_uint& counter) {
+  float value = 1.f;
+  for (uint32_t i(0); i < 100; ++i) {
+    value = std::sqrt(value + i);
+  }
+  counter.fetch_add(value > 0.f ? 1 : 0, std::memory_order_relaxed);
+}
+
+double runExternal(Core::ThreadPool& pool) {
+  std::atomic_uint counter = 0;
+  return Benchmark::measure([&]() {
+    for (uint32_t i(0); i < TASK_COUNT; ++i) {
+      pool.enqueue([&counter]() { doWork(counter); });
+    }
+    pool.waitIdle();
+  });
+}
+
+double runSubmit(Core::ThreadPool& pool) {
+  std::atomic_uint counter = 0;
+  return Benchmark::measure([&]() {
+    for (uint32_t i(0); i < TASK_COUNT; ++i) {
+      pool.submit([&counter]() { doWork(counter); });
+    }
+    pool.waitIdle();
+  });
+}
+
+double runNested(Core::ThreadPool& pool) {
+  std::atomic_uint counter = 0;
+  return Benchmark::measure([&]() {
+    for (uint32_t i(0); i < ROOT_TASKS; ++i) {
+      pool.enqueue([&]() {
+        for (uint32_t j(0); j < TASK_COUNT / ROOT_TASKS; ++j) {
+          pool.enqueue([&counter]() { doWork(counter); });
+        }
+      });
+    }
+    pool.waitIdle();
+  });
+}
+
+} // namespace
+
+int main() {
+
+  uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (uint32_t threads(1); threads <= maxThreads; threads *= 2) {
+    Core::ThreadPool shared(threads, Core::ThreadPool::Scheduling::eSharedQueue);
+    Core::ThreadPool stealing(threads, Core::ThreadPool::Scheduling::eWorkStealing);
+
+    std::string suffix = " (" + std::to_string(threads) + " threads)";
+
+    Benchmark::print("External / eSharedQueue" + suffix, runExternal(shared), TASK_COUNT);
+    Benchmark::print("External / eWorkStealing" + suffix, runExternal(stealing), TASK_COUNT);
+    Benchmark::print("Submit / eSharedQueue" + suffix, runSubmit(shared), TASK_COUNT);
+    Benchmark::print("Submit / eWorkStealing" + suffix, runSubmit(stealing), TASK_COUNT);
+    Benchmark::print("Nested / eSharedQueue" + suffix, runNested(shared), TASK_COUNT);
+    Benchmark::print("Nested / eWorkStealing" + suffix, runNested(stealing), TASK_COUNT);
+
+    // Make sure that we also measure all cores if their count is not a power of two.
+    if (threads < maxThreads && threads * 2 > maxThreads) {
+      threads = maxThreads / 2;
+    }
+  }
+
+  return 0;
+}
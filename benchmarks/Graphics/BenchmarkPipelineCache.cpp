@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "../Benchmark.hpp"
+
+#include <Illusion/Core/File.hpp>
+#include <Illusion/Graphics/Device.hpp>
+#include <Illusion/Graphics/Instance.hpp>
+#include <Illusion/Graphics/PipelineReflection.hpp>
+#include <Illusion/Graphics/Shader.hpp>
+#include <Illusion/Graphics/ShaderModule.hpp>
+#include <Illusion/Graphics/ShaderSource.hpp>
+
+using namespace Illusion;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// This benchmark measures how long it takes to create a number of compute pipelines with an      //
+// empty vk::PipelineCache (cold start) and with a vk::PipelineCache which has been loaded from   //
+// the file written by a previous Device (warm start). The shader modules are created before the  //
+// measurement, so only the pipeline compilation of the driver is measured.                       //
+// Many drivers have an additional internal shader cache on disc which may hide the difference.   //
+// Disable it for meaningful results, e.g. MESA_GLSL_CACHE_DISABLE=1 or                           //
+// __GL_SHADER_DISK_CACHE=0.                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint32_t    PIPELINE_COUNT = 64;
+const std::string CACHE_FILE     = "BenchmarkPipelineCache.bin";
+
+// Each pipeline uses a slightly different shader, else the driver could reuse the first one.
+std::string createCode(uint32_t pipeline) {
+  return R"(
+    #version 450
+    layout(local_size_x = 64) in;
+    layout(binding = 0) buffer Data { float values[]; };
+    void main() {
+      uint i = gl_GlobalInvocationID.x;
+      float v = values[i];
+      for (int j = 0; j < 16; ++j) {
+        v = sin(v * )" +
+         std::to_string(pipeline + 1) + R"(.0) + cos(v + float(j));
+      }
+      values[i] = v;
+    }
+  )";
+}
+
+// Creates a Device with the given cache file, creates all pipelines and returns the time this
+// took. The Device writes its vk::PipelineCache to the cache file when it is destroyed.
+double createPipelines(
+    Graphics::InstancePtr const& instance, std::vector<std::string> const& code) {
+  auto device = Graphics::Device::create("Device", instance->getPhysicalDevice(), CACHE_FILE);
+
+  std::vector<Graphics::ShaderPtr> shaders;
+  for (uint32_t i(0); i < PIPELINE_COUNT; ++i) {
+    auto shader = Graphics::Shader::create("Shader " + std::to_string(i), device);
+    shader->addModule(vk::ShaderStageFlagBits::eCompute,
+        Graphics::GlslCode::create(code[i], "Shader " + std::to_string(i)));
+    shader->getModules();
+    shader->getReflection()->getLayout();
+    shaders.push_back(shader);
+  }
+
+  std::vector<vk::PipelinePtr> pipelines;
+
+  Core::Timer timer;
+
+  for (auto const& shader : shaders) {
+    vk::ComputePipelineCreateInfo info;
+    info.stage.stage  = vk::ShaderStageFlagBits::eCompute;
+    info.stage.module = *shader->getModules()[0]->getHandle();
+    info.stage.pName  = "main";
+    info.layout       = *shader->getReflection()->getLayout();
+    pipelines.push_back(device->createComputePipeline("Pipeline", info));
+  }
+
+  return timer.getElapsed();
+}
+
+} // namespace
+
+int main() {
+  auto instance = Graphics::Instance::create(
+      "BenchmarkPipelineCache", Graphics::Instance::OptionBits::eHeadlessMode);
+
+  std::vector<std::string> code;
+  for (uint32_t i(0); i < PIPELINE_COUNT; ++i) {
+    code.push_back(createCode(i));
+  }
+
+  Core::File(CACHE_FILE).remove();
+
+  double cold = createPipelines(instance, code);
+  double warm = createPipelines(instance, code);
+
+  Benchmark::print("Pipeline creation with cold cache", cold, PIPELINE_COUNT);
+  Benchmark::print("Pipeline creation with warm cache", warm, PIPELINE_COUNT);
+
+  Core::Logger::message() << "Cache file size: " << Core::File(CACHE_FILE).map().getSize()
+                          << " bytes, speed-up: " << cold / warm << "x" << std::endl;
+
+  Core::File(CACHE_FILE).remove();
+
+  return 0;
+}
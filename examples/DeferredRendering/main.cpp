@@ -8,6 +8,7 @@
 
 #include <Illusion/Core/CommandLine.hpp>
 #include <Illusion/Core/Logger.hpp>
+#include <Illusion/Core/Profiler.hpp>
 #include <Illusion/Core/Timer.hpp>
 #include <Illusion/Graphics/CommandBuffer.hpp>
 #include <Illusion/Graphics/Device.hpp>
@@ -18,6 +19,7 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
 #include <thread>
 
 #include "Floor.hpp"
@@ -30,15 +32,20 @@
 int main(int argc, char* argv[]) {
 
   struct {
-    uint32_t mLightCount = 20;
-    bool     mPrintHelp  = false;
+    uint32_t    mLightCount   = 20;
+    uint32_t    mRecordFrames = 0;
+    std::string mRecordFile   = "DeferredRendering.json";
+    bool        mPrintHelp    = false;
   } options;
 
   // clang-format off
   Illusion::Core::CommandLine args("Deferred Rendering with Vulkan.");
-  args.addArgument({"-h", "--help"},   &options.mPrintHelp,  "Print this help");
-  args.addArgument({"-l", "--lights"}, &options.mLightCount, "Number of light sources");
-  args.addArgument({"-t", "--trace"},  &Illusion::Core::Logger::enableTrace, "Print trace output");
+  args.addArgument({"-h", "--help"},    &options.mPrintHelp,    "Print this help");
+  args.addArgument({"-l", "--lights"},  &options.mLightCount,   "Number of light sources");
+  args.addArgument({"-t", "--trace"},   &Illusion::Core::Logger::enableTrace, "Print trace output");
+  args.addArgument({"--record-frames"}, &options.mRecordFrames,
+    "Record a Chrome trace of this many frames at startup. F12 records one later on");
+  args.addArgument({"--record-file"},   &options.mRecordFile,   "File name of recorded traces");
   // clang-format on
 
   args.parse(argc, argv);
@@ -48,6 +55,20 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  // The trace can be opened with chrome://tracing. It contains the CPU zones of all threads and
+  // the GPU time of each pass of the FrameGraph.
+  auto startRecording = [&options](uint32_t frames) {
+    try {
+      Illusion::Core::Profiler::startRecording(options.mRecordFile, frames);
+    } catch (std::runtime_error const& e) {
+      Illusion::Core::Logger::error() << e.what() << std::endl;
+    }
+  };
+
+  if (options.mRecordFrames > 0) {
+    startRecording(options.mRecordFrames);
+  }
+
   auto instance = Illusion::Graphics::Instance::create("DeferredRenderingDemo");
   auto device   = Illusion::Graphics::Device::create("Device", instance->getPhysicalDevice());
   auto window   = Illusion::Graphics::Window::create("Window", instance, device);
@@ -116,6 +137,15 @@ int main(int argc, char* argv[]) {
   // Use a timer to get the current system time at each frame.
   Illusion::Core::Timer timer;
 
+  // Pressing F12 records the next frames.
+  window->sOnKeyEvent.connect([&options, &startRecording](Illusion::Input::KeyEvent const& e) {
+    if (e.mType == Illusion::Input::KeyEvent::Type::ePress &&
+        e.mKey == Illusion::Input::Key::eF12 && !Illusion::Core::Profiler::isRecording()) {
+      startRecording(std::max(options.mRecordFrames, 10u));
+    }
+    return true;
+  });
+
   // Then we open our window.
   window->open();
 
@@ -0,0 +1,451 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AnimationSystem.hpp"
+
+#include "Utils.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ILLUSION_ANIMATION_SYSTEM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Illusion::Core {
+
+namespace {
+
+// The update of an animation is written once as a template. It is instantiated for float, which is
+// used on architectures without SSE and for the remainder of each batch, and for Float4, which
+// processes four animations at a time.
+
+inline float select(bool condition, float a, float b) {
+  return condition ? a : b;
+}
+
+inline float minimum(float a, float b) {
+  return std::min(a, b);
+}
+
+template <typename V>
+V load(float const* data);
+
+template <>
+inline float load<float>(float const* data) {
+  return *data;
+}
+
+inline void store(float* data, float value) {
+  *data = value;
+}
+
+inline bool notEqual(float a, float b) {
+  return a != b;
+}
+
+inline int toBits(bool mask) {
+  return mask ? 1 : 0;
+}
+
+#ifdef ILLUSION_ANIMATION_SYSTEM_SSE
+
+// A tiny wrapper around four packed floats. The comparison operators return a bit mask which can
+// be passed to select().
+struct Float4 {
+  Float4(__m128 value)
+      : mValue(value) {
+  }
+
+  Float4(float value)
+      : mValue(_mm_set1_ps(value)) {
+  }
+
+  __m128 mValue;
+};
+
+inline Float4 operator+(Float4 a, Float4 b) {
+  return _mm_add_ps(a.mValue, b.mValue);
+}
+
+inline Float4 operator-(Float4 a, Float4 b) {
+  return _mm_sub_ps(a.mValue, b.mValue);
+}
+
+inline Float4 operator*(Float4 a, Float4 b) {
+  return _mm_mul_ps(a.mValue, b.mValue);
+}
+
+inline Float4 operator<(Float4 a, Float4 b) {
+  return _mm_cmplt_ps(a.mValue, b.mValue);
+}
+
+inline Float4 operator>(Float4 a, Float4 b) {
+  return _mm_cmpgt_ps(a.mValue, b.mValue);
+}
+
+inline Float4 operator|(Float4 a, Float4 b) {
+  return _mm_or_ps(a.mValue, b.mValue);
+}
+
+inline Float4 operator!(Float4 a) {
+  return _mm_xor_ps(a.mValue, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+}
+
+inline Float4 notEqual(Float4 a, Float4 b) {
+  return _mm_cmpneq_ps(a.mValue, b.mValue);
+}
+
+// Returns the sign bits of the four values. For a bit mask, bit i is set if value i is set.
+inline int toBits(Float4 mask) {
+  return _mm_movemask_ps(mask.mValue);
+}
+
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+  return _mm_or_ps(_mm_and_ps(mask.mValue, a.mValue), _mm_andnot_ps(mask.mValue, b.mValue));
+}
+
+inline Float4 minimum(Float4 a, Float4 b) {
+  return _mm_min_ps(a.mValue, b.mValue);
+}
+
+template <>
+inline Float4 load<Float4>(float const* data) {
+  return _mm_loadu_ps(data);
+}
+
+inline void store(float* data, Float4 value) {
+  _mm_storeu_ps(data, value.mValue);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// These are the easing curves of the AnimatedProperty, normalized to the range [0...1]. The actual
+// value is computed by start + curve(t) * (end - start).
+
+struct Linear {
+  template <typename V>
+  static V apply(V t, V /*exponent*/) {
+    return t;
+  }
+};
+
+struct EaseIn {
+  template <typename V>
+  static V apply(V t, V exponent) {
+    return t * t * ((exponent + 1.f) * t - exponent);
+  }
+};
+
+struct EaseOut {
+  template <typename V>
+  static V apply(V t, V exponent) {
+    V u = t - 1.f;
+    return u * u * ((exponent + 1.f) * u + exponent) + 1.f;
+  }
+};
+
+// Both halves are evaluated and the correct one is selected afterwards, as the four values of a
+// Float4 may be in different halves.
+template <typename First, typename Second>
+struct Composite {
+  template <typename V>
+  static V apply(V t, V exponent) {
+    V first  = First::apply(t * 2.f, exponent) * 0.5f;
+    V second = Second::apply(t * 2.f - 1.f, exponent) * 0.5f + 0.5f;
+    return select(t < 0.5f, first, second);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Pointers to the arrays of an AnimationSystem::Batch.
+struct Arrays {
+  float*       mState;
+  float*       mDelay;
+  float*       mValue;
+  float const* mStart;
+  float const* mEnd;
+  float const* mSpeed;
+  float const* mExponent;
+};
+
+// Updates the animations [i ... i+N) of the given arrays, where N is the number of values in V. As
+// in AnimatedProperty::update(), the delay is counted down first; then the state is advanced. The
+// returned bit mask contains a one for each animation whose value changed or which is finished.
+template <typename Curve, typename V>
+int step(Arrays const& arrays, size_t i, V time) {
+  V delay    = load<V>(arrays.mDelay + i);
+  V state    = load<V>(arrays.mState + i);
+  V waiting  = delay > 0.f;
+  V advanced = minimum(state + time * load<V>(arrays.mSpeed + i), 1.f);
+
+  state = select(waiting, state, advanced);
+  store(arrays.mDelay + i, select(waiting, delay - time, delay));
+  store(arrays.mState + i, state);
+
+  V start    = load<V>(arrays.mStart + i);
+  V end      = load<V>(arrays.mEnd + i);
+  V oldValue = load<V>(arrays.mValue + i);
+  V newValue = start + Curve::apply(state, load<V>(arrays.mExponent + i)) * (end - start);
+  store(arrays.mValue + i, newValue);
+
+  return toBits(notEqual(oldValue, newValue) | !(state < 1.f));
+}
+
+// Updates all animations of the given arrays and calls the given function with the index of each
+// animation whose value changed or which is finished.
+template <typename Curve, typename F>
+void stepAll(Arrays const& arrays, size_t count, float time, F const& onChange) {
+  size_t i = 0;
+
+#ifdef ILLUSION_ANIMATION_SYSTEM_SSE
+  Float4 time4(time);
+  for (; i + 4 <= count; i += 4) {
+    int bits = step<Curve, Float4>(arrays, i, time4);
+    for (uint32_t j(0); bits != 0; ++j, bits >>= 1) {
+      if (bits & 1) {
+        onChange(static_cast<uint32_t>(i + j));
+      }
+    }
+  }
+#endif
+
+  for (; i < count; ++i) {
+    if (step<Curve, float>(arrays, i, time)) {
+      onChange(static_cast<uint32_t>(i));
+    }
+  }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::Batch::add(Float* target, float start, float end, float duration,
+    float exponent, float delay, AnimationLoop loop) {
+
+  // A duration of zero would result in an infinite speed. As inf * 0 is NaN, we use a very large
+  // value instead. The animation will then reach its end with the next update.
+  float speed = duration > 0.f ? 1.f / duration : 1e30f;
+
+  mStart.push_back(start);
+  mEnd.push_back(end);
+  mState.push_back(0.f);
+  mSpeed.push_back(speed);
+  mDelay.push_back(delay);
+  mExponent.push_back(exponent);
+  mValue.push_back(start);
+  mLoop.push_back(loop);
+  mTargets.push_back(target);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::Batch::remove(uint32_t index) {
+
+  // The last animation is moved to the given index, so that all arrays stay densely packed.
+  auto removeFrom = [index](auto& array) {
+    array[index] = array.back();
+    array.pop_back();
+  };
+
+  removeFrom(mStart);
+  removeFrom(mEnd);
+  removeFrom(mState);
+  removeFrom(mSpeed);
+  removeFrom(mDelay);
+  removeFrom(mExponent);
+  removeFrom(mValue);
+  removeFrom(mLoop);
+  removeFrom(mTargets);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::animate(Float& property, float end, double duration,
+    AnimationDirection direction, AnimationLoop loop, double exponent, double delay) {
+
+  if (mUpdating) {
+    mDeferred.emplace_back([=, &property]() {
+      animate(property, end, duration, direction, loop, exponent, delay);
+    });
+    return;
+  }
+
+  stop(property);
+
+  auto  batchIndex = Utils::enumCast(direction);
+  auto& batch      = mBatches[batchIndex];
+
+  batch.add(&property, property.get(), end, static_cast<float>(duration),
+      static_cast<float>(exponent), static_cast<float>(delay), loop);
+
+  mLocations[&property] = {static_cast<uint32_t>(batchIndex),
+      static_cast<uint32_t>(batch.mTargets.size() - 1)};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool AnimationSystem::stop(Float const& property) {
+  auto location = mLocations.find(&property);
+
+  if (location == mLocations.end()) {
+    return false;
+  }
+
+  if (mUpdating) {
+    mDeferred.emplace_back([this, &property]() { stop(property); });
+    return true;
+  }
+
+  auto& batch = mBatches[location->second.mBatch];
+  auto  index = location->second.mIndex;
+
+  mLocations.erase(location);
+  batch.remove(index);
+
+  // The animation which has been moved to the freed index has to be updated in our map.
+  if (index < batch.mTargets.size()) {
+    mLocations[batch.mTargets[index]].mIndex = index;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::clear() {
+  if (mUpdating) {
+    mDeferred.emplace_back([this]() { clear(); });
+    return;
+  }
+
+  for (auto& batch : mBatches) {
+    batch = Batch();
+  }
+
+  mLocations.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool AnimationSystem::isAnimated(Float const& property) const {
+  return mLocations.find(&property) != mLocations.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t AnimationSystem::getAnimationCount() const {
+  return static_cast<uint32_t>(mLocations.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::update(double time) {
+
+  // While the batches are processed, signal handlers of the animated Properties must not modify
+  // them. Therefore calls to animate(), stop() and clear() are deferred until we are finished.
+  mUpdating = true;
+
+  for (size_t b(0); b < mBatches.size(); ++b) {
+    auto& batch = mBatches[b];
+
+    if (batch.mTargets.empty()) {
+      continue;
+    }
+
+    mFinished.clear();
+    evaluate(batch, static_cast<AnimationDirection>(b), static_cast<float>(time));
+
+    // We iterate backwards, so that finished animations can be removed on the fly: The animation
+    // which is moved to the index of a removed one has already been processed. Finished animations
+    // are set exactly to their end value, the easing curve may be off by a few ulps. Repeating
+    // animations jump back to their start value.
+    for (auto i = mFinished.rbegin(); i != mFinished.rend(); ++i) {
+      uint32_t index  = *i;
+      Float*   target = batch.mTargets[index];
+
+      if (batch.mLoop[index] == AnimationLoop::eRepeat) {
+        batch.mState[index] = 0.f;
+        batch.mValue[index] = batch.mStart[index];
+        target->set(batch.mEnd[index]);
+        target->set(batch.mStart[index]);
+
+      } else if (batch.mLoop[index] == AnimationLoop::eToggle) {
+        batch.mState[index] = 0.f;
+        batch.mValue[index] = batch.mEnd[index];
+        std::swap(batch.mStart[index], batch.mEnd[index]);
+        target->set(batch.mValue[index]);
+
+      } else {
+        float end = batch.mEnd[index];
+        mLocations.erase(target);
+        batch.remove(index);
+
+        if (index < batch.mTargets.size()) {
+          mLocations[batch.mTargets[index]].mIndex = index;
+        }
+
+        target->set(end);
+      }
+    }
+  }
+
+  mUpdating = false;
+
+  // Now we can apply all changes which have been requested by signal handlers.
+  for (size_t i(0); i < mDeferred.size(); ++i) {
+    mDeferred[i]();
+  }
+
+  mDeferred.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::evaluate(Batch& batch, AnimationDirection direction, float time) {
+  Arrays arrays{batch.mState.data(), batch.mDelay.data(), batch.mValue.data(),
+      batch.mStart.data(), batch.mEnd.data(), batch.mSpeed.data(), batch.mExponent.data()};
+  size_t count = batch.mTargets.size();
+
+  // Changed values are set right away, finished animations are handled by update().
+  auto onChange = [this, &batch](uint32_t i) {
+    if (batch.mState[i] < 1.f) {
+      batch.mTargets[i]->set(batch.mValue[i]);
+    } else {
+      mFinished.push_back(i);
+    }
+  };
+
+  // The direction is the same for the entire batch, so we have to decide only once which curve to
+  // use.
+  switch (direction) {
+    case AnimationDirection::eLinear:
+      stepAll<Linear>(arrays, count, time, onChange);
+      break;
+    case AnimationDirection::eIn:
+      stepAll<EaseIn>(arrays, count, time, onChange);
+      break;
+    case AnimationDirection::eOut:
+      stepAll<EaseOut>(arrays, count, time, onChange);
+      break;
+    case AnimationDirection::eInOut:
+      stepAll<Composite<EaseIn, EaseOut>>(arrays, count, time, onChange);
+      break;
+    case AnimationDirection::eOutIn:
+      stepAll<Composite<EaseOut, EaseIn>>(arrays, count, time, onChange);
+      break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
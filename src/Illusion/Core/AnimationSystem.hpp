@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_ANIMATION_SYSTEM_HPP
+#define ILLUSION_CORE_ANIMATION_SYSTEM_HPP
+
+#include "AnimatedProperty.hpp"
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The AnimationSystem animates many Float Properties at once. It uses the same easing curves as  //
+// the AnimatedProperty, but instead of updating each animation individually, all active          //
+// animations are stored in a structure-of-arrays layout, one batch for each AnimationDirection.  //
+// This way, the easing curve of a batch can be evaluated for four values at a time with SSE      //
+// instructions (or with a plain loop on other architectures). Afterwards, only those Properties  //
+// whose value actually changed are set. If the signal handlers of the animated Properties start  //
+// or stop animations, these requests are applied when update() is finished. Wrap update() in a   //
+// PropertyTransaction if these signals change many other Properties.                             //
+// The animated Properties are referenced by pointer, so an animation has to be stopped before    //
+// its Property is destroyed.                                                                     //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AnimationSystem {
+ public:
+  AnimationSystem() = default;
+
+  AnimationSystem(AnimationSystem const& other) = delete;
+  AnimationSystem& operator=(AnimationSystem const& other) = delete;
+
+  // Starts a new animation of the given Property from its current value to the given end value. If
+  // the Property is already animated by this system, the old animation is replaced. The parameters
+  // have the same meaning as the members of the AnimatedProperty.
+  void animate(Float& property, float end, double duration,
+      AnimationDirection direction = AnimationDirection::eInOut,
+      AnimationLoop loop = AnimationLoop::eNone, double exponent = 0.0, double delay = 0.0);
+
+  // Stops the animation of the given Property. The Property keeps its current value. Returns false
+  // if the Property was not animated by this system. If this is called from a signal handler during
+  // update(), the animation is stopped when update() is finished.
+  bool stop(Float const& property);
+
+  // Stops all animations.
+  void clear();
+
+  // Returns true if the given Property is currently animated by this system.
+  bool isAnimated(Float const& property) const;
+
+  // Returns the number of currently active animations.
+  uint32_t getAnimationCount() const;
+
+  // Advances all animations by the given time in seconds. Animations which reach their end are
+  // either removed or restarted, depending on their AnimationLoop mode.
+  void update(double time);
+
+ private:
+  // All arrays of a batch have the same size. The animation at index i of a batch animates
+  // mTargets[i] from mStart[i] to mEnd[i]. mState is the progress in [0...1], mSpeed is the inverse
+  // of the duration and mValue contains the most recently computed value.
+  struct Batch {
+    std::vector<float>         mStart;
+    std::vector<float>         mEnd;
+    std::vector<float>         mState;
+    std::vector<float>         mSpeed;
+    std::vector<float>         mDelay;
+    std::vector<float>         mExponent;
+    std::vector<float>         mValue;
+    std::vector<AnimationLoop> mLoop;
+    std::vector<Float*>        mTargets;
+
+    void add(Float* target, float start, float end, float duration, float exponent, float delay,
+        AnimationLoop loop);
+    void remove(uint32_t index);
+  };
+
+  // Advances the animations of the given batch and writes the results of the easing curve to
+  // Batch::mValue. This is the part of the update which is done in SIMD fashion. The Properties of
+  // changed values are set right away, the indices of finished animations are stored in mFinished.
+  void evaluate(Batch& batch, AnimationDirection direction, float time);
+
+  // The location of an animation: the index of its batch and its index inside this batch.
+  struct Location {
+    uint32_t mBatch;
+    uint32_t mIndex;
+  };
+
+  std::array<Batch, 5>                       mBatches;
+  std::unordered_map<Float const*, Location> mLocations;
+  std::vector<uint32_t>                      mFinished;
+  std::vector<std::function<void()>>         mDeferred;
+  bool                                       mUpdating = false;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_ANIMATION_SYSTEM_HPP
@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_BINARY_STREAM_HPP
+#define ILLUSION_CORE_BINARY_STREAM_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// BinaryWriter and BinaryReader can be used to store simple data structures in files. Values     //
+// are written in the byte order of the machine, so the data should not be shared between         //
+// machines of different architectures. Only trivially copyable types can be written directly;    //
+// for structs with padding bytes, each member should be written separately so that equal structs //
+// result in equal data.                                                                          //
+//                                                                                                //
+// BinaryWriter writer;                                                                           //
+// writer.write<uint32_t>(42);                                                                    //
+// writer.write(std::string("Foo"));                                                              //
+// file.save(writer.getData());                                                                   //
+//                                                                                                //
+// BinaryReader reader(data.data(), data.size());                                                 //
+// auto number = reader.read<uint32_t>();                                                         //
+// auto string = reader.read<std::string>();                                                      //
+//                                                                                                //
+// The BinaryReader throws a std::runtime_error if more data is read than available.              //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class BinaryWriter {
+ public:
+  template <typename T>
+  void write(T const& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Cannot write non-trivial types!");
+    writeBytes(&value, sizeof(T));
+  }
+
+  // Writes the size of the string followed by its characters.
+  void write(std::string const& value) {
+    write<uint32_t>(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size());
+  }
+
+  // Writes the size of the vector followed by its elements.
+  template <typename T>
+  void write(std::vector<T> const& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Cannot write non-trivial types!");
+    write<uint32_t>(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size() * sizeof(T));
+  }
+
+  void writeBytes(void const* data, size_t size) {
+    auto bytes = static_cast<uint8_t const*>(data);
+    mData.insert(mData.end(), bytes, bytes + size);
+  }
+
+  std::vector<uint8_t> const& getData() const {
+    return mData;
+  }
+
+  void clear() {
+    mData.clear();
+  }
+
+ private:
+  std::vector<uint8_t> mData;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+class BinaryReader {
+ public:
+  // The data is not copied, so it has to stay valid as long as the BinaryReader is used.
+  BinaryReader(void const* data, size_t size)
+      : mData(static_cast<uint8_t const*>(data))
+      , mSize(size) {
+  }
+
+  template <typename T>
+  void read(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Cannot read non-trivial types!");
+    readBytes(&value, sizeof(T));
+  }
+
+  void read(std::string& value) {
+    value.resize(readSize(1));
+    readBytes(value.data(), value.size());
+  }
+
+  template <typename T>
+  void read(std::vector<T>& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Cannot read non-trivial types!");
+    value.resize(readSize(sizeof(T)));
+    readBytes(value.data(), value.size() * sizeof(T));
+  }
+
+  // Convenience version of the methods above: auto value = reader.read<uint32_t>();
+  template <typename T>
+  T read() {
+    T value;
+    read(value);
+    return value;
+  }
+
+  void readBytes(void* data, size_t size) {
+    if (size > getRemaining()) {
+      throw std::runtime_error("Failed to read binary data: Unexpected end of data!");
+    }
+    std::memcpy(data, mData + mOffset, size);
+    mOffset += size;
+  }
+
+  // Returns the number of bytes which have not been read yet.
+  size_t getRemaining() const {
+    return mSize - mOffset;
+  }
+
+  bool isAtEnd() const {
+    return mOffset == mSize;
+  }
+
+ private:
+  // Reads the element count of a string or a vector. This throws before anything is allocated if
+  // there is not enough data left for that many elements.
+  size_t readSize(size_t elementSize) {
+    auto size = read<uint32_t>();
+    if (size * elementSize > getRemaining()) {
+      throw std::runtime_error("Failed to read binary data: Unexpected end of data!");
+    }
+    return size;
+  }
+
+  uint8_t const* mData;
+  size_t         mSize;
+  size_t         mOffset = 0;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_BINARY_STREAM_HPP
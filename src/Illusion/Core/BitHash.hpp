@@ -9,16 +9,18 @@
 #ifndef ILLUSION_CORE_BITHASH_HPP
 #define ILLUSION_CORE_BITHASH_HPP
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <vector>
 
 namespace Illusion::Core {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // A small class which can be used to create hashes for complex objects. This is done by pushing  //
-// individual bits of the members of the object into an std::vector<bool>. For example consider a //
-// struct like this:                                                                              //
+// individual bits of the members of the object into the BitHash. For example consider a struct   //
+// like this:                                                                                     //
 //                                                                                                //
 // struct Vehicle {                                                                               //
 //   enum class Type { eBike = 0, eCar = 1, eBoot = 2, eAirplane = 3 };                           //
@@ -32,33 +34,140 @@ namespace Illusion::Core {
 // hash.push<32>(vehicle.mPrice); // mPrice is a uint32_t, therefore we have to push 32 bits      //
 // hash.push<2>(vehicle.mType);   // mType only needs 2 bits                                      //
 //                                                                                                //
-// Then we can store our Vehicles in a maplike this:                                              //
+// Then we can store our Vehicles in a map like this:                                             //
 //                                                                                                //
-// std::map<BitHash, Vehicle> mCache;                                                             //
+// std::unordered_map<BitHash, Vehicle> mCache;                                                   //
 //                                                                                                //
+// The bits are packed into 64 bit words, so pushing and comparing is done word-wise. Whenever a  //
+// word is completely filled, it is mixed into a 64 bit digest. Therefore getDigest() (which is   //
+// used by std::hash) does not have to iterate over all bits. Two BitHashes are only equal if all //
+// of their bits are equal - the digest is not used for comparisons.                              //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class BitHash : public std::vector<bool> {
+class BitHash {
 
  public:
+  // Appends the lowest bitCount bits of the given value.
   template <uint32_t bitCount, typename T>
   void push(T const& value) {
 
+    static_assert(bitCount > 0, "Cannot push zero bits into BitHash!");
     static_assert(bitCount <= 64, "Cannot push more than 64 bits into BitHash!");
     static_assert(bitCount <= sizeof(T) * 8, "Cannot push more bits into the BitHash than T has!");
 
-    uint64_t mask(1);
     uint64_t castedValue(0);
+    std::memcpy(&castedValue, &value, std::min(sizeof(T), sizeof(uint64_t)));
 
-    std::memcpy(&castedValue, &value, sizeof(T));
+    if constexpr (bitCount < 64) {
+      castedValue &= (uint64_t(1) << bitCount) - 1;
+    }
+
+    pushBits(castedValue, bitCount);
+  }
 
-    for (uint32_t i(0); i < bitCount; ++i) {
-      push_back((castedValue & mask));
-      mask = mask << 1;
+  // Appends all bits of the given BitHash.
+  void push(BitHash const& other) {
+    for (size_t i(0); i < other.mWords.size(); ++i) {
+      uint32_t bitCount = std::min<size_t>(64, other.mSize - i * 64);
+      pushBits(other.mWords[i], bitCount);
     }
   }
+
+  // Removes all bits.
+  void clear() {
+    mWords.clear();
+    mSize   = 0;
+    mDigest = 0;
+  }
+
+  // Returns the number of bits which have been pushed so far.
+  size_t size() const {
+    return mSize;
+  }
+
+  bool empty() const {
+    return mSize == 0;
+  }
+
+  // Returns a 64 bit hash of all bits. Equal BitHashes have equal digests.
+  uint64_t getDigest() const {
+    uint64_t digest = mDigest;
+
+    // The last word has not been mixed into mDigest yet if it is only partially filled.
+    if (mSize % 64 != 0) {
+      digest = combine(digest, mWords.back());
+    }
+
+    return combine(digest, mSize);
+  }
+
+  bool operator==(BitHash const& other) const {
+    return mSize == other.mSize && mWords == other.mWords;
+  }
+
+  bool operator!=(BitHash const& other) const {
+    return !(*this == other);
+  }
+
+  // This can be used to store BitHashes in ordered containers.
+  bool operator<(BitHash const& other) const {
+    if (mSize != other.mSize) {
+      return mSize < other.mSize;
+    }
+    return mWords < other.mWords;
+  }
+
+ private:
+  // Unused bits of the last word are always zero, so the words can be compared directly.
+  void pushBits(uint64_t value, uint32_t bitCount) {
+    uint32_t offset = mSize % 64;
+
+    if (offset == 0) {
+      mWords.push_back(value);
+    } else {
+      mWords.back() |= value << offset;
+
+      if (offset + bitCount > 64) {
+        mWords.push_back(value >> (64 - offset));
+      }
+    }
+
+    // The previous word has been completely filled; mix it into our digest.
+    if (offset + bitCount >= 64) {
+      mDigest = combine(mDigest, mWords[(mSize + bitCount) / 64 - 1]);
+    }
+
+    mSize += bitCount;
+  }
+
+  // This is the 64 bit finalizer of MurmurHash3 applied to the combination of both values.
+  static uint64_t combine(uint64_t digest, uint64_t value) {
+    uint64_t h = digest ^ (value + 0x9e3779b97f4a7c15ull + (digest << 6) + (digest >> 2));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+  }
+
+  std::vector<uint64_t> mWords;
+  size_t                mSize   = 0;
+  uint64_t              mDigest = 0;
 };
 
 } // namespace Illusion::Core
 
+namespace std {
+
+// With this specialization, BitHashes can be used as keys of std::unordered_maps.
+template <>
+struct hash<Illusion::Core::BitHash> {
+  size_t operator()(Illusion::Core::BitHash const& value) const {
+    return static_cast<size_t>(value.getDigest());
+  }
+};
+
+} // namespace std
+
 #endif // ILLUSION_CORE_BITHASH_HPP
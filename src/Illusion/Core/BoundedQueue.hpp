@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_BOUNDED_QUEUE_HPP
+#define ILLUSION_CORE_BOUNDED_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A thread safe queue with a fixed capacity. In contrast to the Core::Queue, it does not use a   //
+// mutex: Any number of threads may push and pop at the same time without blocking each other.    //
+// It is a ring buffer where each cell has a sequence number which tells whether the cell may be  //
+// written or read in the current round (this is Dmitry Vyukov's bounded MPMC queue). A thread    //
+// claims a cell (or a range of cells for the bulk operations) by advancing the enqueue or        //
+// dequeue position with a compare-exchange.                                                      //
+// The try*() methods never block. push() and pop() wait until there is space or an element.      //
+// They spin for a short while and then sleep; a sleeping thread is only notified if there is a   //
+// waiting thread at all, so the non-blocking path never touches a mutex.                         //
+// T has to be default constructible and move assignable; pushing const references requires it to //
+// be copy assignable as well. The capacity is rounded up to the next power of two.               //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class BoundedQueue {
+
+ public:
+  explicit BoundedQueue(size_t capacity) {
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < capacity) {
+      roundedCapacity *= 2;
+    }
+
+    mMask  = roundedCapacity - 1;
+    mCells = std::make_unique<Cell[]>(roundedCapacity);
+
+    for (size_t i(0); i < roundedCapacity; ++i) {
+      mCells[i].mSequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(BoundedQueue const& other) = delete;
+  BoundedQueue& operator=(BoundedQueue const& other) = delete;
+
+  // Returns the maximum number of elements which can be stored in the queue.
+  size_t getCapacity() const {
+    return mMask + 1;
+  }
+
+  // Returns the number of elements in the queue. If other threads push or pop at the same time,
+  // this is only a hint; it may be outdated as soon as it is returned.
+  size_t getSizeHint() const {
+    size_t dequeuePos = mDequeuePos.load(std::memory_order_relaxed);
+    size_t enqueuePos = mEnqueuePos.load(std::memory_order_relaxed);
+    return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+  }
+
+  // Returns true if the queue is empty. Like getSizeHint(), this may be outdated immediately.
+  bool isEmptyHint() const {
+    return getSizeHint() == 0;
+  }
+
+  // Tries to append a value to the queue. Returns false if the queue is full. The value is only
+  // moved from if it has been pushed, so on failure it can still be used by the caller.
+  bool tryPush(T&& value) {
+    return tryPush(&value, 1) == 1;
+  }
+
+  // Tries to append a copy of the value to the queue. Returns false if the queue is full; in this
+  // case no copy is made.
+  bool tryPush(T const& value) {
+    return tryEnqueue(1, [&value](T& target, size_t) { target = value; }) == 1;
+  }
+
+  // Tries to append count values to the queue. The values are moved from the given array. Returns
+  // the number of values which have been pushed; this may be less than count if the queue is
+  // nearly full. The pushed values are stored consecutively. Values which have not been pushed are
+  // not modified.
+  size_t tryPush(T* values, size_t count) {
+    return tryEnqueue(count, [values](T& target, size_t i) { target = std::move(values[i]); });
+  }
+
+  // Tries to remove the first value of the queue. Returns false if the queue is empty.
+  bool tryPop(T& value) {
+    return tryPop(&value, 1) == 1;
+  }
+
+  // Tries to remove up to maxCount values from the queue. They are moved to the given array.
+  // Returns the number of values which have been popped.
+  size_t tryPop(T* values, size_t maxCount) {
+    size_t pos   = mDequeuePos.load(std::memory_order_relaxed);
+    size_t ready = 0;
+
+    while (true) {
+      // Count how many consecutive cells have been written in this round.
+      ready = countCells(pos, maxCount, 1);
+
+      if (ready == 0) {
+        size_t current = mDequeuePos.load(std::memory_order_relaxed);
+        if (current == pos) {
+          return 0;
+        }
+        pos = current;
+
+      } else if (mDequeuePos.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    for (size_t i(0); i < ready; ++i) {
+      auto& cell = mCells[(pos + i) & mMask];
+      values[i]  = std::move(cell.mValue);
+      cell.mSequence.store(pos + i + mMask + 1, std::memory_order_release);
+    }
+
+    notifyWaiters();
+
+    return ready;
+  }
+
+  // Appends a value to the queue. If the queue is full, this blocks until there is enough space.
+  void push(T&& value) {
+    wait([&]() { return tryPush(std::move(value)); },
+        [this]() { return countCells(mEnqueuePos.load(), 1, 0) == 1; });
+  }
+
+  // Appends a copy of the value to the queue. If the queue is full, this blocks until there is
+  // enough space.
+  void push(T const& value) {
+    wait([&]() { return tryPush(value); },
+        [this]() { return countCells(mEnqueuePos.load(), 1, 0) == 1; });
+  }
+
+  // Removes the first value of the queue. If the queue is empty, this blocks until there is one.
+  void pop(T& value) {
+    wait([&]() { return tryPop(&value, 1) == 1; },
+        [this]() { return countCells(mDequeuePos.load(), 1, 1) == 1; });
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> mSequence;
+    T                   mValue;
+  };
+
+  // Claims up to count consecutive free cells and calls store(cellValue, i) for each of them.
+  // Returns the number of claimed cells.
+  template <typename F>
+  size_t tryEnqueue(size_t count, F const& store) {
+    size_t pos   = mEnqueuePos.load(std::memory_order_relaxed);
+    size_t ready = 0;
+
+    while (true) {
+      // Count how many consecutive cells are free in this round.
+      ready = countCells(pos, count, 0);
+
+      if (ready == 0) {
+        // The cell at pos has not been read in the previous round, so the queue is full. If
+        // another thread has claimed it in the meantime, we have to try again.
+        size_t current = mEnqueuePos.load(std::memory_order_relaxed);
+        if (current == pos) {
+          return 0;
+        }
+        pos = current;
+
+      } else if (mEnqueuePos.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    for (size_t i(0); i < ready; ++i) {
+      auto& cell = mCells[(pos + i) & mMask];
+      store(cell.mValue, i);
+      cell.mSequence.store(pos + i + 1, std::memory_order_release);
+    }
+
+    notifyWaiters();
+
+    return ready;
+  }
+
+  // Returns the number of consecutive cells starting at pos (at most maxCount) whose sequence
+  // number is pos + offset. For producers, offset is zero (the cell is free), for consumers it is
+  // one (the cell has been written).
+  size_t countCells(size_t pos, size_t maxCount, size_t offset) const {
+    size_t count = 0;
+    while (count < maxCount && count <= mMask &&
+           mCells[(pos + count) & mMask].mSequence.load(std::memory_order_acquire) ==
+               pos + count + offset) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Calls tryOperation until it returns true. If it does not succeed for a while, the calling
+  // thread sleeps until canProceed returns true. It is woken up by notifyWaiters().
+  template <typename F, typename P>
+  void wait(F const& tryOperation, P const& canProceed) {
+    for (uint32_t i(0); !tryOperation(); ++i) {
+      if (i < 64) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mMutex);
+      ++mWaitingThreads;
+      mCondition.wait(lock, canProceed);
+      --mWaitingThreads;
+    }
+  }
+
+  // Wakes up all threads sleeping in wait(). The fence ensures that the store to the sequence
+  // number of the cell is visible before we check whether there are waiting threads. Locking the
+  // mutex ensures that a thread which is just about to fall asleep does not miss the notification.
+  void notifyWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mWaitingThreads > 0) {
+      { std::unique_lock<std::mutex> lock(mMutex); }
+      mCondition.notify_all();
+    }
+  }
+
+  std::unique_ptr<Cell[]> mCells;
+  size_t                  mMask = 0;
+
+  // The positions are on separate cache lines, so that producers and consumers do not interfere.
+  alignas(64) std::atomic<size_t> mEnqueuePos{0};
+  alignas(64) std::atomic<size_t> mDequeuePos{0};
+
+  alignas(64) std::atomic_uint mWaitingThreads{0};
+  std::mutex              mMutex;
+  std::condition_variable mCondition;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_BOUNDED_QUEUE_HPP
@@ -10,10 +10,21 @@
 
 #include "filesystem.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#endif
+
 namespace Illusion::Core {
 
 File::File(std::string fileName)
@@ -27,10 +38,114 @@ bool File::isValid() const {
   return !file.fail();
 }
 
+MappedFile File::map() const {
+  try {
+    MappedFile mapping(mPath);
+    mLastWriteTime = getLastWriteTime();
+    return mapping;
+  } catch (std::runtime_error const& e) {
+    Logger::warning() << e.what() << std::endl;
+    return MappedFile();
+  }
+}
+
 void File::remove() {
   std::remove(mPath.c_str());
 }
 
+bool File::rename(std::string const& path) {
+#if defined(_WIN32)
+  // std::rename does not replace existing files on Windows.
+  bool success = MoveFileExA(mPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  bool success = std::rename(mPath.c_str(), path.c_str()) == 0;
+#endif
+
+  if (!success) {
+    Logger::warning() << "Cannot rename file \"" << mPath << "\" to \"" << path << "\"!"
+                      << std::endl;
+    return false;
+  }
+
+  mPath = path;
+  return true;
+}
+
+bool File::saveAtomic(void const* data, size_t size) const {
+  auto bytes = static_cast<char const*>(data);
+
+#if defined(_WIN32)
+  // There is no mkstemp() on Windows, so the process ID and a counter make the name unique.
+  // CREATE_NEW fails if the file exists nevertheless.
+  static std::atomic<uint32_t> counter{0};
+  std::string tmpPath = mPath + "." + std::to_string(GetCurrentProcessId()) + "." +
+                        std::to_string(counter++) + ".tmp";
+
+  HANDLE file = CreateFileA(
+      tmpPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    Logger::warning() << "Cannot create temporary file \"" << tmpPath << "\"!" << std::endl;
+    return false;
+  }
+
+  bool success = true;
+  while (success && size > 0) {
+    DWORD chunk   = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+    DWORD written = 0;
+    success       = WriteFile(file, bytes, chunk, &written, nullptr) != 0;
+    bytes += written;
+    size -= written;
+  }
+
+  success = success && FlushFileBuffers(file) != 0;
+  CloseHandle(file);
+
+  success = success && MoveFileExA(tmpPath.c_str(), mPath.c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+
+  if (!success) {
+    DeleteFileA(tmpPath.c_str());
+  }
+#else
+  std::string tmpPath = mPath + ".XXXXXX";
+
+  int file = mkstemp(tmpPath.data());
+  if (file < 0) {
+    Logger::warning() << "Cannot create temporary file \"" << tmpPath << "\"!" << std::endl;
+    return false;
+  }
+
+  bool success = true;
+  while (success && size > 0) {
+    ssize_t written = write(file, bytes, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    success = written > 0;
+    if (success) {
+      bytes += written;
+      size -= static_cast<size_t>(written);
+    }
+  }
+
+  // Make sure that the data is on disc before the rename makes it visible. Otherwise a crash could
+  // leave an empty file behind.
+  success = success && fsync(file) == 0;
+  success = (close(file) == 0) && success;
+  success = success && std::rename(tmpPath.c_str(), mPath.c_str()) == 0;
+
+  if (!success) {
+    unlink(tmpPath.c_str());
+  }
+#endif
+
+  if (!success) {
+    Logger::warning() << "Cannot save file \"" << mPath << "\" atomically!" << std::endl;
+  }
+
+  return success;
+}
+
 std::string const& File::getFileName() const {
   return mPath;
 }
@@ -10,6 +10,7 @@
 #define ILLUSION_CORE_FILE_HPP
 
 #include "Logger.hpp"
+#include "MappedFile.hpp"
 
 #include <fstream>
 #include <string>
@@ -21,6 +22,7 @@
 // File file;                                                                                     //
 // auto content = file.getContent<std::string>(); // reads the content as a std::string           //
 // auto content = file.getContent<std::vector<uint8_t>>(); // reads the content as a byte array   //
+// auto mapping = file.map(); // maps the content into memory without copying it                  //
 //                                                                                                //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -64,6 +66,12 @@ class File {
     return data;
   }
 
+  // Maps the file's content read-only into memory. This avoids the allocation and the copy of
+  // getContent() and is the preferred way for loaders which parse large files. The returned
+  // MappedFile has to be kept alive as long as its data is accessed. If the file cannot be mapped,
+  // a warning is printed and an empty MappedFile is returned.
+  MappedFile map() const;
+
   // Saves the file. The template parameter should be either std::string or some other container
   // like a std::vector.
   template <typename T>
@@ -80,6 +88,19 @@ class File {
     return true;
   }
 
+  // Saves the file like save() but writes the data to a uniquely named temporary file first. This
+  // is flushed to disc and then replaces the original file. So the file either contains the old or
+  // the new data, even if the application crashes while saving or several processes save the same
+  // file. If saving fails, the temporary file is removed and a warning is printed.
+  template <typename T>
+  bool saveAtomic(T const& data) const {
+    return saveAtomic(data.data(), data.size() * sizeof(typename T::value_type));
+  }
+
+  // Renames the file on disc and makes this instance point to the new name. An existing file with
+  // the new name is replaced. Returns false and prints a warning if this fails.
+  bool rename(std::string const& path);
+
   // Deletes the file from the file system
   void remove();
 
@@ -98,6 +119,8 @@ class File {
   void resetChangedOnDisc();
 
  private:
+  bool saveAtomic(void const* data, size_t size) const;
+
   std::string    mPath;
   mutable time_t mLastWriteTime{};
 };
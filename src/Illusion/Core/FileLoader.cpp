@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FileLoader.hpp"
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileLoader::FileLoader(uint32_t threadCount) {
+  threadCount = std::max(threadCount, 1u);
+
+  for (uint32_t i(0); i < threadCount; ++i) {
+    mThreads.emplace_back([this, i]() {
+      Profiler::setThreadName("FileLoader " + std::to_string(i));
+      run();
+    });
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileLoader::~FileLoader() {
+  std::map<Key, Job> cancelled;
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStop = true;
+    std::swap(cancelled, mQueue);
+  }
+
+  mCondition.notify_all();
+
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+
+  for (auto& job : cancelled) {
+    job.second.mPromise.set_exception(std::make_exception_ptr(std::runtime_error(
+        "Loading of file \"" + job.second.mFileName + "\" has been cancelled!")));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileLoader::Request FileLoader::load(std::string fileName, int32_t priority) {
+  Request request;
+  request.mPriority = priority;
+
+  Job job;
+  job.mFileName = std::move(fileName);
+  request.mFile = job.mPromise.get_future();
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    request.mID = mNextID++;
+    mQueue.emplace(getKey(request), std::move(job));
+  }
+
+  mCondition.notify_one();
+
+  return request;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FileLoader::cancel(Request const& request) {
+  Job job;
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto                         it = mQueue.find(getKey(request));
+    if (it == mQueue.end()) {
+      return false;
+    }
+
+    job = std::move(it->second);
+    mQueue.erase(it);
+  }
+
+  job.mPromise.set_exception(std::make_exception_ptr(
+      std::runtime_error("Loading of file \"" + job.mFileName + "\" has been cancelled!")));
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FileLoader::setPriority(Request& request, int32_t priority) {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  auto it = mQueue.find(getKey(request));
+  if (it == mQueue.end()) {
+    return false;
+  }
+
+  Job job = std::move(it->second);
+  mQueue.erase(it);
+
+  request.mPriority = priority;
+  mQueue.emplace(getKey(request), std::move(job));
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t FileLoader::getPendingCount() const {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mQueue.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileLoader::Key FileLoader::getKey(Request const& request) {
+  return {-static_cast<int64_t>(request.mPriority), request.mID};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileLoader::run() {
+  while (true) {
+    Job job;
+
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCondition.wait(lock, [this]() { return mStop || !mQueue.empty(); });
+
+      if (mStop) {
+        return;
+      }
+
+      job = std::move(mQueue.begin()->second);
+      mQueue.erase(mQueue.begin());
+    }
+
+    ILLUSION_PROFILE_ZONE("FileLoader::load");
+
+    try {
+      job.mPromise.set_value(MappedFile(job.mFileName, true));
+    } catch (...) {
+      job.mPromise.set_exception(std::current_exception());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
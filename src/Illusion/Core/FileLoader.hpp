@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_FILE_LOADER_HPP
+#define ILLUSION_CORE_FILE_LOADER_HPP
+
+#include "MappedFile.hpp"
+
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The FileLoader reads files asynchronously on one or several dedicated I/O threads. This way, a //
+// loading screen or a streaming system can overlap disc I/O with decoding and GPU uploads on     //
+// other threads. The files are returned as prefetched MappedFiles: the entire file has been read //
+// into memory by the I/O thread, so accessing the mapping does not block anymore and no copy is  //
+// made.                                                                                          //
+// Requests with a higher priority are loaded first, requests with equal priorities in the order  //
+// in which they were made. As long as a request has not been picked up by an I/O thread, it can  //
+// be cancelled or its priority can be changed. The future of a cancelled request throws a        //
+// std::runtime_error, as does the future of a file which cannot be mapped.                       //
+//                                                                                                //
+// Core::FileLoader loader;                                                                       //
+// auto request = loader.load("texture.dds");                                                     //
+// // ... do something else ...                                                                   //
+// Core::MappedFile file = request.mFile.get();                                                   //
+//                                                                                                //
+// All methods are thread-safe.                                                                   //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class FileLoader {
+ public:
+  // Identifies a request. mFile will contain the mapped file once it has been loaded.
+  struct Request {
+    uint64_t                mID       = 0;
+    int32_t                 mPriority = 0;
+    std::future<MappedFile> mFile;
+  };
+
+  // Launches the given number of I/O threads. Usually, one thread is enough as they would compete
+  // for the same disc anyway.
+  explicit FileLoader(uint32_t threadCount = 1);
+
+  // All requests which have not been processed yet are cancelled. The destructor waits for the
+  // requests which are currently processed.
+  ~FileLoader();
+
+  FileLoader(FileLoader const& other) = delete;
+  FileLoader& operator=(FileLoader const& other) = delete;
+
+  // Queues the given file for loading. Requests with a higher priority are loaded first.
+  Request load(std::string fileName, int32_t priority = 0);
+
+  // Removes the given request from the queue. Its future will throw a std::runtime_error. Returns
+  // false if the request has already been picked up by an I/O thread; it will be finished normally
+  // in this case.
+  bool cancel(Request const& request);
+
+  // Changes the priority of the given request. Returns false if the request has already been picked
+  // up by an I/O thread.
+  bool setPriority(Request& request, int32_t priority);
+
+  // Returns the number of requests which have not been picked up by an I/O thread yet.
+  size_t getPendingCount() const;
+
+ private:
+  struct Job {
+    std::string              mFileName;
+    std::promise<MappedFile> mPromise;
+  };
+
+  // The queue is ordered by descending priority first and by ascending ID second. Therefore, the
+  // first element of a key is the negated priority.
+  using Key = std::pair<int64_t, uint64_t>;
+
+  static Key getKey(Request const& request);
+
+  void run();
+
+  std::map<Key, Job>       mQueue;
+  uint64_t                 mNextID = 0;
+  bool                     mStop   = false;
+  mutable std::mutex       mMutex;
+  std::condition_variable  mCondition;
+  std::vector<std::thread> mThreads;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_FILE_LOADER_HPP
@@ -0,0 +1,346 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.hpp"
+
+#include "Logger.hpp"
+#include "filesystem.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Illusion::Core {
+
+namespace {
+
+#if defined(__linux__)
+// Events of the watched directories. IN_MODIFY is not used on purpose: It is reported for each
+// write() call, so a reload might start before the file is completely written. IN_CLOSE_WRITE is
+// reported once the writer is done.
+const uint32_t INOTIFY_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE |
+                              IN_DELETE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+// Splits the given path into the directory and the file name.
+std::pair<std::string, std::string> splitPath(std::string const& path) {
+  auto pos = path.find_last_of("/\\");
+
+  if (pos == std::string::npos) {
+    return {".", path};
+  }
+
+  if (pos == 0) {
+    return {path.substr(0, 1), path.substr(1)};
+  }
+
+  return {path.substr(0, pos), path.substr(pos + 1)};
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileWatcher& FileWatcher::get() {
+  static FileWatcher instance;
+  return instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileWatcher::FileWatcher(Mode mode, std::chrono::milliseconds pollingInterval)
+    : mMode(Mode::ePolling)
+    , mPollingInterval(pollingInterval) {
+
+  if (mode == Mode::eNative) {
+#if defined(__linux__)
+    mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    mWakeUp  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (mInotify >= 0 && mWakeUp >= 0) {
+      mMode = Mode::eNative;
+    } else {
+      Logger::warning() << "Failed to initialize inotify, falling back to polling!" << std::endl;
+      if (mInotify >= 0) {
+        close(mInotify);
+        mInotify = -1;
+      }
+      if (mWakeUp >= 0) {
+        close(mWakeUp);
+        mWakeUp = -1;
+      }
+    }
+#endif
+  }
+
+  if (mMode == Mode::eNative) {
+    mThread = std::thread([this]() { runNative(); });
+  } else {
+    mThread = std::thread([this]() { runPolling(); });
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileWatcher::~FileWatcher() {
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+
+  mStopCondition.notify_all();
+
+  if (mMode == Mode::eNative) {
+    wakeUp();
+  }
+
+  mThread.join();
+
+#if defined(__linux__)
+  if (mInotify >= 0) {
+    close(mInotify);
+  }
+  if (mWakeUp >= 0) {
+    close(mWakeUp);
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileWatcher::Mode FileWatcher::getMode() const {
+  return mMode;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::watch(
+    std::string const& fileName, std::shared_ptr<std::atomic_bool> const& flag) {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  removeExpiredEntries();
+
+  for (auto const& entry : mEntries) {
+    if (entry.mPath == fileName && entry.mFlag.lock() == flag) {
+      return;
+    }
+  }
+
+  Entry entry;
+  entry.mPath = fileName;
+  entry.mFlag = flag;
+  std::tie(entry.mDirectory, entry.mName) = splitPath(fileName);
+
+  if (mMode == Mode::eNative) {
+    entry.mWatch = addWatch(entry.mDirectory);
+  }
+
+  // If the directory cannot be watched (for example because it does not exist), the file is polled
+  // like on other platforms. The background thread may be sleeping without a timeout, so we have
+  // to wake it up.
+  if (entry.mWatch < 0) {
+    entry.mLastWriteTime = FileSystem::getLastWriteTime(fileName);
+
+    if (mMode == Mode::eNative) {
+      wakeUp();
+    }
+  }
+
+  mEntries.push_back(std::move(entry));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t FileWatcher::getWatchCount() const {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  return std::count_if(
+      mEntries.begin(), mEntries.end(), [](Entry const& e) { return !e.mFlag.expired(); });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::notify(int watch, std::string const& name) {
+  for (auto const& entry : mEntries) {
+    if (entry.mWatch == watch && (name.empty() || entry.mName == name)) {
+      auto flag = entry.mFlag.lock();
+      if (flag) {
+        flag->store(true);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t FileWatcher::pollEntries() {
+  size_t count = 0;
+
+  for (auto& entry : mEntries) {
+    if (entry.mWatch >= 0) {
+      continue;
+    }
+
+    ++count;
+
+    auto time = FileSystem::getLastWriteTime(entry.mPath);
+    if (time != entry.mLastWriteTime) {
+      entry.mLastWriteTime = time;
+
+      auto flag = entry.mFlag.lock();
+      if (flag) {
+        flag->store(true);
+      }
+    }
+  }
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int FileWatcher::addWatch(std::string const& directory) {
+#if defined(__linux__)
+  int watch = inotify_add_watch(mInotify, directory.c_str(), INOTIFY_MASK);
+  if (watch >= 0) {
+    mWatches.insert(watch);
+  }
+  return watch;
+#else
+  return -1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::retryWatches() {
+  for (auto& entry : mEntries) {
+    if (entry.mWatch < 0) {
+      entry.mWatch = addWatch(entry.mDirectory);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::wakeUp() {
+#if defined(__linux__)
+  uint64_t value = 1;
+  if (write(mWakeUp, &value, sizeof(value)) < 0) {
+    Logger::warning() << "Failed to wake up the FileWatcher thread!" << std::endl;
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::removeExpiredEntries() {
+  mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+                     [](Entry const& e) { return e.mFlag.expired(); }),
+      mEntries.end());
+
+#if defined(__linux__)
+  for (auto watch = mWatches.begin(); watch != mWatches.end();) {
+    bool used = std::any_of(
+        mEntries.begin(), mEntries.end(), [&](Entry const& e) { return e.mWatch == *watch; });
+
+    if (used) {
+      ++watch;
+    } else {
+      inotify_rm_watch(mInotify, *watch);
+      watch = mWatches.erase(watch);
+    }
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::runNative() {
+#if defined(__linux__)
+  alignas(inotify_event) char buffer[4096];
+
+  // Files which could not be watched with inotify are polled. If there are none, we only wake up
+  // for inotify events or when the FileWatcher is destroyed or a polled file is added.
+  size_t polledEntries = 0;
+
+  while (true) {
+    pollfd fds[2] = {{mInotify, POLLIN, 0}, {mWakeUp, POLLIN, 0}};
+    poll(fds, 2, polledEntries > 0 ? static_cast<int>(mPollingInterval.count()) : -1);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (mStop) {
+      return;
+    }
+
+    uint64_t wakeUps;
+    while (read(mWakeUp, &wakeUps, sizeof(wakeUps)) > 0) {
+    }
+
+    ssize_t length;
+    while ((length = read(mInotify, buffer, sizeof(buffer))) > 0) {
+      for (char* p = buffer; p < buffer + length;) {
+        auto event = reinterpret_cast<inotify_event const*>(p);
+        p += sizeof(inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+          // Some events have been lost, so we have to assume that all files have changed.
+          for (int watch : mWatches) {
+            notify(watch, "");
+          }
+        } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+          // The directory itself is gone. All files in it have changed; from now on they are
+          // polled until the directory can be watched again. If the directory has been moved, the
+          // watch still exists and is removed here.
+          notify(event->wd, "");
+
+          if (mWatches.erase(event->wd) > 0) {
+            inotify_rm_watch(mInotify, event->wd);
+          }
+
+          for (auto& entry : mEntries) {
+            if (entry.mWatch == event->wd) {
+              entry.mWatch         = -1;
+              entry.mLastWriteTime = FileSystem::getLastWriteTime(entry.mPath);
+            }
+          }
+        } else if (event->len > 0) {
+          notify(event->wd, event->name);
+        }
+      }
+    }
+
+    polledEntries = pollEntries();
+
+    if (polledEntries > 0) {
+      retryWatches();
+    }
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileWatcher::runPolling() {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  while (!mStopCondition.wait_for(lock, mPollingInterval, [this]() { return mStop; })) {
+    pollEntries();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_FILE_WATCHER_HPP
+#define ILLUSION_CORE_FILE_WATCHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The FileWatcher observes files on disc and sets a flag when one of them changes. Checking      //
+// whether a file has changed is then just an atomic load, no matter how often this is done.      //
+// On Linux, inotify is used: The parent directories of the watched files are observed, so that   //
+// files which are replaced by an editor (written to a temporary file and renamed) are detected   //
+// as well. The events are processed by a background thread. On other platforms (or if inotify    //
+// is not available) the background thread polls the last write times of all watched files in     //
+// regular intervals instead. Files in directories which cannot be watched with inotify (for      //
+// example because they do not exist yet) are polled as well; the FileWatcher tries to watch them //
+// again in each interval. If no file is polled, the background thread only wakes up for events.  //
+// A flag is a std::shared_ptr<std::atomic_bool>; one flag can be used for several files. The     //
+// FileWatcher only keeps weak references, so a file is not watched anymore once all copies of    //
+// its flag are released. The flag is never reset by the FileWatcher.                             //
+// There is one global instance which is returned by get(), but for testing purposes additional   //
+// instances can be created as well. All methods are thread-safe.                                 //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class FileWatcher {
+ public:
+  enum class Mode { eNative, ePolling };
+
+  // Returns the global FileWatcher. It uses Mode::eNative.
+  static FileWatcher& get();
+
+  // Launches the background thread. If mode is Mode::eNative but inotify is not available, the
+  // FileWatcher falls back to Mode::ePolling. Use getMode() to check which mode is actually used.
+  // The pollingInterval is used for all polled files.
+  explicit FileWatcher(Mode mode = Mode::eNative,
+      std::chrono::milliseconds pollingInterval = std::chrono::milliseconds(250));
+
+  // Stops the background thread. Flags of changes which happen afterwards are not set anymore.
+  ~FileWatcher();
+
+  FileWatcher(FileWatcher const& other) = delete;
+  FileWatcher& operator=(FileWatcher const& other) = delete;
+
+  // Returns the mode which is actually used.
+  Mode getMode() const;
+
+  // Starts watching the given file. The flag will be set to true whenever the file is modified,
+  // replaced, removed or touched. The file does not need to exist; in this case the flag is set as
+  // soon as it is created. Watching the same file with the same flag twice has no effect.
+  void watch(std::string const& fileName, std::shared_ptr<std::atomic_bool> const& flag);
+
+  // Returns the number of currently watched files with a non-expired flag.
+  size_t getWatchCount() const;
+
+ private:
+  struct Entry {
+    std::string                     mPath;
+    std::string                     mDirectory;
+    std::string                     mName;
+    std::weak_ptr<std::atomic_bool> mFlag;
+
+    // The inotify watch descriptor of mDirectory or -1 if the file is polled.
+    int mWatch = -1;
+
+    // Used for polled files only.
+    time_t mLastWriteTime = 0;
+  };
+
+  // Sets the flags of all entries in the given directory whose name matches. If name is empty, all
+  // entries of the directory are notified.
+  void notify(int watch, std::string const& name);
+
+  // Checks the last write time of all polled entries. Returns the number of polled entries.
+  size_t pollEntries();
+
+  // Adds an inotify watch for the given directory and returns its watch descriptor. inotify
+  // returns the same descriptor for different paths of the same directory, so aliases like "."
+  // and its absolute path share one watch. Returns -1 if the directory cannot be watched.
+  int addWatch(std::string const& directory);
+
+  // Tries to add an inotify watch for all polled entries. This is done in each polling interval,
+  // so that directories which have been created in the meantime are watched natively again.
+  void retryWatches();
+
+  // Wakes up the background thread.
+  void wakeUp();
+
+  // Removes entries with expired flags and releases inotify watches which are not used anymore.
+  void removeExpiredEntries();
+
+  void runNative();
+  void runPolling();
+
+  Mode                      mMode;
+  std::chrono::milliseconds mPollingInterval;
+
+  // mWatches contains all inotify watch descriptors which are currently in use.
+  std::vector<Entry>      mEntries;
+  std::unordered_set<int> mWatches;
+  mutable std::mutex      mMutex;
+
+  // The inotify instance and an eventfd which is used to wake up the background thread when the
+  // FileWatcher is destroyed or when a polled file is added.
+  int mInotify = -1;
+  int mWakeUp  = -1;
+
+  bool                    mStop = false;
+  std::condition_variable mStopCondition;
+  std::thread             mThread;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_FILE_WATCHER_HPP
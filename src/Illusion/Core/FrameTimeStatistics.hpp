@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_FRAME_TIME_STATISTICS_HPP
+#define ILLUSION_CORE_FRAME_TIME_STATISTICS_HPP
+
+#include "Property.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// In contrast to the FPSCounter, the FrameTimeStatistics do not only compute an average. They    //
+// report percentiles of the frame times of the last C frames, so that occasional stutters are    //
+// not hidden. Just call step() once each frame.                                                  //
+// The frame times are sorted into a histogram with logarithmic buckets: Each power of two (in    //
+// microseconds) is divided into 16 linear sub-buckets. Hence the reported percentiles are at     //
+// most 6.25% larger than the actual frame times. The maximum is exact. Frame times longer than   //
+// about 67 seconds are clamped. A step() takes constant time and the memory consumption does not //
+// grow.                                                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <size_t C>
+class FrameTimeStatistics {
+
+ public:
+  // These properties contain the percentiles and the maximum of the frame times of the last C
+  // frames in seconds. They are updated by step() and add().
+  Double pP50 = 0.0;
+  Double pP95 = 0.0;
+  Double pP99 = 0.0;
+  Double pMax = 0.0;
+
+  // Frames which take longer than pHitchThreshold seconds are counted as hitches. pHitches is the
+  // number of hitches since construction (or since the last call to reset()).
+  Double pHitchThreshold = 1.0 / 30.0;
+  UInt64 pHitches        = 0;
+
+  // Call this once a frame.
+  void step() {
+    add(mTimer.restart());
+  }
+
+  // Adds a frame with the given duration in seconds. This can be used instead of step() if the
+  // frame times are measured elsewhere.
+  void add(double frameTime) {
+    size_t bucket = getBucket(frameTime);
+
+    // Remove the oldest frame from the histogram if the window is full.
+    if (mFrameCount >= C) {
+      --mCounts[mBuckets[mFrameCount % C]];
+    }
+
+    mBuckets[mFrameCount % C] = static_cast<uint16_t>(bucket);
+    ++mCounts[bucket];
+
+    // mMaxQueue contains a decreasing sequence of frame times. Its first entry is the maximum of
+    // the window; each entry is removed when a larger frame time is added.
+    while (mMaxQueueSize > 0 &&
+           mMaxQueue[(mMaxQueueStart + mMaxQueueSize - 1) % C].second <= frameTime) {
+      --mMaxQueueSize;
+    }
+    if (mMaxQueueSize > 0 && mMaxQueue[mMaxQueueStart].first + C <= mFrameCount) {
+      mMaxQueueStart = (mMaxQueueStart + 1) % C;
+      --mMaxQueueSize;
+    }
+    mMaxQueue[(mMaxQueueStart + mMaxQueueSize) % C] = {mFrameCount, frameTime};
+    ++mMaxQueueSize;
+
+    mLastFrameTime = frameTime;
+    ++mFrameCount;
+
+    if (frameTime > pHitchThreshold.get()) {
+      pHitches = pHitches.get() + 1;
+    }
+
+    updateProperties();
+  }
+
+  // Returns the given percentile (in [0...1]) of the frame times in the window in seconds. This
+  // iterates over the histogram buckets; if you need several percentiles, use the Properties.
+  double getPercentile(double percentile) const {
+    uint64_t rank  = getRank(percentile);
+    uint64_t count = 0;
+    for (size_t i(0); i < BUCKET_COUNT; ++i) {
+      count += mCounts[i];
+      if (count >= rank) {
+        return getBucketValue(i);
+      }
+    }
+    return 0.0;
+  }
+
+  // Returns the number of frames which have been added since construction (or since the last call
+  // to reset()). The statistics consider the last min(C, getFrameCount()) of them.
+  uint64_t getFrameCount() const {
+    return mFrameCount;
+  }
+
+  // Discards all frames and resets the hitch counter.
+  void reset() {
+    mCounts.fill(0);
+    mFrameCount    = 0;
+    mMaxQueueStart = 0;
+    mMaxQueueSize  = 0;
+    mLastFrameTime = 0.0;
+    pHitches       = 0;
+    updateProperties();
+    mTimer.restart();
+  }
+
+  // Writes the column names of printCSV() followed by a line break.
+  static void printCSVHeader(std::ostream& os) {
+    os << "frame,frameTime,p50,p95,p99,max,hitches" << std::endl;
+  }
+
+  // Writes the current values as one line of comma separated values. This can be called after each
+  // step() to create a log of the entire session.
+  void printCSV(std::ostream& os) const {
+    os << mFrameCount << "," << mLastFrameTime << "," << pP50.get() << "," << pP95.get() << ","
+       << pP99.get() << "," << pMax.get() << "," << pHitches.get() << std::endl;
+  }
+
+ private:
+  static constexpr size_t SUB_BUCKET_BITS = 4;
+  static constexpr size_t SUB_BUCKETS     = 1 << SUB_BUCKET_BITS;
+  static constexpr size_t MAX_EXPONENT    = 25;
+  static constexpr size_t BUCKET_COUNT    = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+  // Values below SUB_BUCKETS microseconds have their own bucket. Above, the bucket is given by the
+  // position of the highest bit and the SUB_BUCKET_BITS bits following it. The frame time is
+  // rounded to whole microseconds; truncating would sort 0.000015 seconds into the bucket for 14.
+  static size_t getBucket(double frameTime) {
+    auto microseconds = static_cast<uint64_t>(std::llround(std::max(frameTime, 0.0) * 1000000.0));
+    microseconds      = std::min<uint64_t>(microseconds, (2ull << MAX_EXPONENT) - 1);
+
+    if (microseconds < SUB_BUCKETS) {
+      return static_cast<size_t>(microseconds);
+    }
+
+    size_t exponent = SUB_BUCKET_BITS;
+    while ((microseconds >> (exponent + 1)) > 0) {
+      ++exponent;
+    }
+
+    size_t subBucket = (microseconds >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+  }
+
+  // Returns the largest frame time in seconds which is sorted into the given bucket.
+  static double getBucketValue(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return bucket * 0.000001;
+    }
+
+    size_t   shift = bucket / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return ((lower + (1ull << shift)) - 1) * 0.000001;
+  }
+
+  // Returns the number of frames which are smaller than or equal to the given percentile.
+  uint64_t getRank(double percentile) const {
+    uint64_t frames = std::min<uint64_t>(mFrameCount, C);
+    return std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile * frames)));
+  }
+
+  void updateProperties() {
+    if (mFrameCount == 0) {
+      pP50 = 0.0;
+      pP95 = 0.0;
+      pP99 = 0.0;
+      pMax = 0.0;
+      return;
+    }
+
+    // Compute all percentiles in one pass over the histogram.
+    std::array<uint64_t, 3> ranks   = {getRank(0.5), getRank(0.95), getRank(0.99)};
+    std::array<double, 3>   results = {};
+    size_t                  next    = 0;
+    uint64_t                count   = 0;
+
+    for (size_t i(0); i < BUCKET_COUNT && next < ranks.size(); ++i) {
+      count += mCounts[i];
+      while (next < ranks.size() && count >= ranks[next]) {
+        results[next++] = getBucketValue(i);
+      }
+    }
+
+    pP50 = results[0];
+    pP95 = results[1];
+    pP99 = results[2];
+    pMax = mMaxQueue[mMaxQueueStart].second;
+  }
+
+  std::array<uint32_t, BUCKET_COUNT> mCounts{};
+  std::array<uint16_t, C>            mBuckets{};
+  uint64_t                           mFrameCount    = 0;
+  double                             mLastFrameTime = 0.0;
+
+  // A ring buffer containing pairs of frame numbers and frame times.
+  std::array<std::pair<uint64_t, double>, C> mMaxQueue{};
+  size_t                                     mMaxQueueStart = 0;
+  size_t                                     mMaxQueueSize  = 0;
+
+  Timer mTimer;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_FRAME_TIME_STATISTICS_HPP
@@ -9,9 +9,18 @@
 // ---------------------------------------------------------------------------------------- includes
 #include "Logger.hpp"
 
+#include "BoundedQueue.hpp"
+
+#include <atomic>
+#include <fstream>
 #include <iomanip>
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace Illusion::Core {
 
@@ -71,11 +80,232 @@ class NullBuffer : public std::streambuf {
 NullBuffer   nullBuffer;
 std::ostream devNull(&nullBuffer);
 
+// The state of the asynchronous output. The background thread pops lines from the queue and writes
+// them to mOutput. An empty line is used to tell the thread that it should stop. Written lines are
+// cleared and passed back to the producing threads via mFreeLines, so that their capacity is reused
+// and logging does not allocate once enough lines are in circulation.
+struct AsyncOutput {
+  AsyncOutput(size_t queueCapacity, Logger::OverflowPolicy policy, std::string const& fileName)
+      : mQueue(queueCapacity)
+      , mFreeLines(queueCapacity)
+      , mPolicy(policy) {
+
+    if (!fileName.empty()) {
+      mFile.open(fileName);
+      if (!mFile) {
+        throw std::runtime_error(
+            "Failed to enable asynchronous Logger output: Cannot open file \"" + fileName + "\"!");
+      }
+    }
+
+    mThread = std::thread([this]() { work(); });
+  }
+
+  ~AsyncOutput() {
+    mQueue.push(std::string());
+    mThread.join();
+  }
+
+  // Pushes the given line to the queue. It is swapped with a recycled string, so the caller gets
+  // an empty string which usually has enough capacity for its next line.
+  void push(std::string& line) {
+    std::string message;
+    mFreeLines.tryPop(message);
+    std::swap(message, line);
+
+    if (mPolicy == Logger::OverflowPolicy::eBlock) {
+      mQueue.push(std::move(message));
+    } else if (!mQueue.tryPush(std::move(message))) {
+      ++mDropped;
+      return;
+    }
+
+    ++mPushed;
+  }
+
+  void work() {
+    std::ostream& output = mFile.is_open() ? mFile : std::cout;
+    uint64_t      dropped = 0;
+
+    // Up to this number of lines are popped at once.
+    const size_t             bulkSize = 64;
+    std::vector<std::string> lines(bulkSize);
+
+    while (true) {
+      size_t count = mQueue.tryPop(lines.data(), bulkSize);
+
+      // If there is nothing to do, we flush the output and wait for the next line.
+      if (count == 0) {
+        output.flush();
+        mQueue.pop(lines[0]);
+        count = 1;
+      }
+
+      for (size_t i(0); i < count; ++i) {
+        if (lines[i].empty()) {
+          output.flush();
+          return;
+        }
+
+        output << lines[i];
+
+        // Very long lines are not recycled in order to limit the memory consumption.
+        if (lines[i].capacity() <= MAX_RECYCLED_CAPACITY) {
+          lines[i].clear();
+          mFreeLines.tryPush(std::move(lines[i]));
+        }
+      }
+
+      // Report dropped messages once we managed to write something again.
+      if (mDropped != dropped) {
+        output << "[ILLUSION][W] " << mDropped - dropped << " log messages have been dropped!"
+               << std::endl;
+        dropped = mDropped;
+      }
+
+      mWritten += count;
+    }
+  }
+
+  static const size_t MAX_RECYCLED_CAPACITY = 4096;
+
+  BoundedQueue<std::string> mQueue;
+  BoundedQueue<std::string> mFreeLines;
+  Logger::OverflowPolicy    mPolicy;
+  std::ofstream             mFile;
+  std::thread               mThread;
+  std::atomic<uint64_t>     mPushed{0};
+  std::atomic<uint64_t>     mWritten{0};
+  std::atomic<uint64_t>     mDropped{0};
+};
+
+// This is set while the asynchronous output is enabled. Each thread which uses the output
+// increments its own counter in asyncOutputUsers before it loads the pointer. disableAsyncOutput()
+// resets the pointer first and then waits until all counters are zero before it deletes the
+// output. As each thread has its own counter, logging does not contend on a shared atomic.
+std::atomic<AsyncOutput*> asyncOutput{nullptr};
+
+struct alignas(64) AsyncOutputUser {
+  std::atomic<uint32_t> mReferences{0};
+};
+
+std::mutex                    asyncOutputUsersMutex;
+std::vector<AsyncOutputUser*> asyncOutputUsers;
+
+// Registers the counter of a thread on its first use of the asynchronous output and removes it
+// when the thread exits.
+struct AsyncOutputUserHandle {
+  AsyncOutputUserHandle() {
+    std::lock_guard<std::mutex> lock(asyncOutputUsersMutex);
+    asyncOutputUsers.push_back(&mUser);
+  }
+
+  ~AsyncOutputUserHandle() {
+    std::lock_guard<std::mutex> lock(asyncOutputUsersMutex);
+    asyncOutputUsers.erase(std::find(asyncOutputUsers.begin(), asyncOutputUsers.end(), &mUser));
+  }
+
+  AsyncOutputUser mUser;
+};
+
+AsyncOutputUser& getAsyncOutputUser() {
+  static thread_local AsyncOutputUserHandle handle;
+  return handle.mUser;
+}
+
+// Keeps the asynchronous output alive while it is used. get() returns nullptr if the asynchronous
+// output is disabled.
+class AsyncOutputReference {
+ public:
+  AsyncOutputReference()
+      : mUser(getAsyncOutputUser()) {
+    ++mUser.mReferences;
+    mOutput = asyncOutput.load();
+  }
+
+  ~AsyncOutputReference() {
+    --mUser.mReferences;
+  }
+
+  AsyncOutputReference(AsyncOutputReference const& other) = delete;
+  AsyncOutputReference& operator=(AsyncOutputReference const& other) = delete;
+
+  AsyncOutput* get() const {
+    return mOutput;
+  }
+
+ private:
+  AsyncOutputUser& mUser;
+  AsyncOutput*     mOutput;
+};
+
+// Stops the background thread at program exit. Afterwards, messages which are logged by the
+// destructors of other static objects are written synchronously.
+struct AsyncOutputShutdown {
+  ~AsyncOutputShutdown() {
+    Logger::disableAsyncOutput();
+  }
+} asyncOutputShutdown;
+
+// Collects the characters of one line. When the stream is flushed or a line break is written, the
+// line is pushed to the queue of the asynchronous output.
+class LineBuffer : public std::streambuf {
+ public:
+  int overflow(int c) override {
+    if (c != traits_type::eof()) {
+      mLine.push_back(static_cast<char>(c));
+      if (c == '\n') {
+        sync();
+      }
+    }
+    return c;
+  }
+
+  std::streamsize xsputn(char const* s, std::streamsize count) override {
+    mLine.append(s, static_cast<size_t>(count));
+    if (count > 0 && s[count - 1] == '\n') {
+      sync();
+    }
+    return count;
+  }
+
+  // If the asynchronous output has been disabled in the meantime, the line is written directly.
+  int sync() override {
+    if (mLine.empty()) {
+      return 0;
+    }
+
+    AsyncOutputReference output;
+    if (output.get()) {
+      output.get()->push(mLine);
+    } else {
+      std::cout << mLine << std::flush;
+      mLine.clear();
+    }
+
+    return 0;
+  }
+
+ private:
+  std::string mLine;
+};
+
+// Each thread formats its messages into its own stream.
+std::ostream& getThreadStream() {
+  static thread_local LineBuffer   buffer;
+  static thread_local std::ostream stream(&buffer);
+  return stream;
+}
+
 std::ostream& print(
     std::ostream& os, bool enable, std::string const& header, std::string const& color) {
   if (enable) {
-    return os << (Logger::enableColorOutput ? color : "") << header
-              << (Logger::enableColorOutput ? Logger::PRINT_RESET : "") << " ";
+    // If the asynchronous output is disabled before the line is finished, LineBuffer::sync()
+    // writes it directly. So no AsyncOutputReference is required here.
+    bool          async  = asyncOutput.load(std::memory_order_relaxed) != nullptr;
+    std::ostream& target = (&os == &std::cout && async) ? getThreadStream() : os;
+    return target << (Logger::enableColorOutput ? color : "") << header
+                  << (Logger::enableColorOutput ? Logger::PRINT_RESET : "") << " ";
   }
   return devNull;
 }
@@ -129,5 +359,52 @@ void Logger::traceDeletion(std::string const& object, std::string const& name, s
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Logger::enableAsyncOutput(
+    size_t queueCapacity, OverflowPolicy policy, std::string const& fileName) {
+  disableAsyncOutput();
+
+  asyncOutput = new AsyncOutput(queueCapacity, policy, fileName);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Logger::disableAsyncOutput() {
+  AsyncOutput* output = asyncOutput.exchange(nullptr);
+
+  if (output) {
+    // Threads which have loaded the pointer before it was reset may still push lines. As the
+    // background thread keeps running, they cannot block forever.
+    std::lock_guard<std::mutex> lock(asyncOutputUsersMutex);
+    for (auto const* user : asyncOutputUsers) {
+      while (user->mReferences > 0) {
+        std::this_thread::yield();
+      }
+    }
+
+    delete output;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Logger::flushAsyncOutput() {
+  AsyncOutputReference output;
+  if (output.get()) {
+    uint64_t pushed = output.get()->mPushed;
+    while (output.get()->mWritten < pushed) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Logger::getDroppedMessages() {
+  AsyncOutputReference output;
+  return output.get() ? output.get()->mDropped.load() : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 } // namespace Illusion::Core
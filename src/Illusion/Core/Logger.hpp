@@ -9,6 +9,7 @@
 #ifndef ILLUSION_LOGGER_HPP
 #define ILLUSION_LOGGER_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 
@@ -18,11 +19,23 @@ namespace Illusion::Core {
 // Prints beautiful messages to the console output. You can use the macros at the bottom of this  //
 // file like this:                                                                                //
 // Logger::message() << "hello world" << std::endl; //
+//                                                                                                //
+// By default, all messages are written synchronously on the calling thread. When asynchronous    //
+// output is enabled, messages which would go to std::cout are formatted into a thread-local      //
+// buffer instead. Each line is then pushed to a lock-free queue when the stream is flushed (for  //
+// example with std::endl) and a background thread writes the lines to std::cout or to a file.    //
+// If the queue is full, the lines are either dropped or the logging thread blocks, depending on  //
+// the OverflowPolicy.                                                                            //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Logger {
 
  public:
+  // Determines what happens when a line is logged while the queue of the asynchronous output is
+  // full. With eDrop, the line is discarded and counted (see getDroppedMessages()). With eBlock,
+  // the logging thread waits until the background thread made some space.
+  enum class OverflowPolicy { eDrop, eBlock };
+
   // These are constant which can be used to modify the color of cout streams. For now, this only
   // works on linux.
   const static std::string PRINT_RED;
@@ -60,8 +73,73 @@ class Logger {
       std::string const& object, std::string const& name, std::ostream& os = std::cout);
   static void traceDeletion(
       std::string const& object, std::string const& name, std::ostream& os = std::cout);
+
+  // Starts a background thread which writes all messages that are logged to std::cout. If a file
+  // name is given, the messages are written to this file instead (you may want to set
+  // enableColorOutput to false in this case). The queue can store the given number of lines. This
+  // should be called before any other thread starts logging. Calling it again restarts the
+  // background thread with the new parameters; all pending lines are written before.
+  static void enableAsyncOutput(size_t queueCapacity = 4096,
+      OverflowPolicy policy = OverflowPolicy::eDrop, std::string const& fileName = "");
+
+  // Writes all pending lines and stops the background thread. Afterwards, messages are written
+  // synchronously again. This may be called while other threads are logging. It is called
+  // automatically at program exit, so destructors of static objects can still log.
+  static void disableAsyncOutput();
+
+  // Blocks until all lines which have been logged so far are written.
+  static void flushAsyncOutput();
+
+  // Returns the number of lines which have been discarded due to a full queue since
+  // enableAsyncOutput() has been called.
+  static uint64_t getDroppedMessages();
 };
 
 } // namespace Illusion::Core
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The functions above always evaluate their arguments, even if the corresponding messages are    //
+// discarded. The macros below check Logger::enable* first; the rest of the statement (including  //
+// all operator<< calls and the arguments of traceCreation() and traceDeletion()) is only         //
+// evaluated if the level is enabled:                                                             //
+// ILLUSION_TRACE << "expensive " << toString(object) << std::endl;                               //
+// ILLUSION_TRACE_CREATION("vk::Buffer", "Buffer of " + getName());                               //
+//                                                                                                //
+// Levels below ILLUSION_MIN_LOG_LEVEL are removed at compile time (0: trace, 1: debug,           //
+// 2: message, 3: warning, 4: error). By default, trace and debug output is stripped from builds  //
+// which define NDEBUG. This can be changed by defining ILLUSION_MIN_LOG_LEVEL, for example with  //
+// the ILLUSION_MIN_LOG_LEVEL CMake option.                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define ILLUSION_MIN_LOG_LEVEL 2
+#else
+#define ILLUSION_MIN_LOG_LEVEL 0
+#endif
+#endif
+
+// The if-else construct makes sure that the macros can be used inside other if-else statements.
+#define ILLUSION_LOG_IF(level, enabled)                                                            \
+  if ((level) < ILLUSION_MIN_LOG_LEVEL || !(enabled)) {                                            \
+  } else
+
+#define ILLUSION_TRACE                                                                             \
+  ILLUSION_LOG_IF(0, Illusion::Core::Logger::enableTrace) Illusion::Core::Logger::trace()
+#define ILLUSION_DEBUG                                                                             \
+  ILLUSION_LOG_IF(1, Illusion::Core::Logger::enableDebug) Illusion::Core::Logger::debug()
+#define ILLUSION_MESSAGE                                                                           \
+  ILLUSION_LOG_IF(2, Illusion::Core::Logger::enableMessage) Illusion::Core::Logger::message()
+#define ILLUSION_WARNING                                                                           \
+  ILLUSION_LOG_IF(3, Illusion::Core::Logger::enableWarning) Illusion::Core::Logger::warning()
+#define ILLUSION_ERROR                                                                             \
+  ILLUSION_LOG_IF(4, Illusion::Core::Logger::enableError) Illusion::Core::Logger::error()
+
+#define ILLUSION_TRACE_CREATION(object, name)                                                      \
+  ILLUSION_LOG_IF(0, Illusion::Core::Logger::enableTrace)                                          \
+  Illusion::Core::Logger::traceCreation(object, name)
+#define ILLUSION_TRACE_DELETION(object, name)                                                      \
+  ILLUSION_LOG_IF(0, Illusion::Core::Logger::enableTrace)                                          \
+  Illusion::Core::Logger::traceDeletion(object, name)
+
 #endif // ILLUSION_LOGGER_HPP
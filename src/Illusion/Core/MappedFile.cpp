@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(std::string const& fileName, bool prefetch) {
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+      nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": Cannot open file!");
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": Cannot get file size!");
+  }
+
+  // Mapping an empty file is an error on Windows, so we just keep the mapping empty.
+  if (size.QuadPart == 0) {
+    CloseHandle(file);
+    return;
+  }
+
+  // The mapping object keeps a reference to the file, so the file handle can be closed right away.
+  mMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+
+  if (mMapping == nullptr) {
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": Cannot create mapping!");
+  }
+
+  mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+  if (mData == nullptr) {
+    CloseHandle(mMapping);
+    mMapping = nullptr;
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": Cannot map view of file!");
+  }
+
+  mSize = static_cast<size_t>(size.QuadPart);
+
+  // Touch each page in order to read the file into the file cache.
+  if (prefetch) {
+    auto          data = static_cast<volatile uint8_t const*>(mData);
+    volatile char sum  = 0;
+    for (size_t i(0); i < mSize; i += 4096) {
+      sum += data[i];
+    }
+  }
+#else
+  int file = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": Cannot open file!");
+  }
+
+  struct stat info {};
+  if (fstat(file, &info) != 0) {
+    close(file);
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": Cannot get file size!");
+  }
+
+  // mmap() fails for a length of zero, so empty files result in an empty mapping.
+  if (info.st_size == 0) {
+    close(file);
+    return;
+  }
+
+  // The mapping keeps a reference to the file, so the file descriptor can be closed right away.
+  // MAP_POPULATE reads the entire file and creates the page table entries right away.
+  int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+  if (prefetch) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+
+  void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, flags, file, 0);
+  close(file);
+
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Failed to map file \"" + fileName + "\": mmap() failed!");
+  }
+
+  // Loaders usually parse the file from front to back, so the kernel may read ahead aggressively.
+  // Without MAP_POPULATE, at least ask the kernel to start reading in the background.
+  madvise(data, static_cast<size_t>(info.st_size), prefetch ? MADV_WILLNEED : MADV_SEQUENTIAL);
+
+  mData = data;
+  mSize = static_cast<size_t>(info.st_size);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mData(std::exchange(other.mData, nullptr))
+    , mSize(std::exchange(other.mSize, 0))
+    , mMapping(std::exchange(other.mMapping, nullptr)) {
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    mData    = std::exchange(other.mData, nullptr);
+    mSize    = std::exchange(other.mSize, 0);
+    mMapping = std::exchange(other.mMapping, nullptr);
+  }
+
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::~MappedFile() {
+  unmap();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool MappedFile::isEmpty() const {
+  return mSize == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t MappedFile::getSize() const {
+  return mSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string_view MappedFile::getString() const {
+  return std::string_view(getData<char>(), mSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MappedFile::unmap() {
+  if (mData == nullptr) {
+    return;
+  }
+
+#if defined(_WIN32)
+  UnmapViewOfFile(mData);
+  CloseHandle(mMapping);
+#else
+  munmap(const_cast<void*>(mData), mSize);
+#endif
+
+  mData    = nullptr;
+  mSize    = 0;
+  mMapping = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
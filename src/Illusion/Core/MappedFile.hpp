@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_MAPPED_FILE_HPP
+#define ILLUSION_CORE_MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A MappedFile maps the content of a file read-only into memory. In contrast to                  //
+// File::getContent(), nothing is copied: the returned pointers point directly to the pages of    //
+// the operating system's file cache, which are loaded lazily on first access. This is meant for  //
+// loaders which parse large files (Spir-V, shader sources, textures) in one go.                  //
+// The mapping is released when the MappedFile is destroyed, so all pointers and string views     //
+// obtained from it must not outlive it. A MappedFile can be moved but not copied.                //
+// If the file is truncated by another process while it is mapped, accessing the removed part is  //
+// undefined behavior (usually a SIGBUS on POSIX systems). Therefore, the mapping should be kept  //
+// only as long as the content is being parsed.                                                   //
+//                                                                                                //
+// Core::MappedFile mapping("shader.spv");                                                        //
+// auto code = mapping.getData<uint32_t>();  // code[0] is the Spir-V magic number                //
+// auto size = mapping.getCount<uint32_t>(); // number of 32 bit words in the file                //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class MappedFile {
+
+ public:
+  // This constructs an empty mapping.
+  MappedFile() = default;
+
+  // Maps the given file. A std::runtime_error is thrown if the file cannot be opened or mapped.
+  // Empty files result in an empty mapping. If prefetch is set to true, the entire file is read
+  // into the file cache right away. This blocks the calling thread but later accesses will not.
+  explicit MappedFile(std::string const& fileName, bool prefetch = false);
+
+  MappedFile(MappedFile const& other) = delete;
+  MappedFile& operator=(MappedFile const& other) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  ~MappedFile();
+
+  // Returns true if nothing is mapped. This is the case for default-constructed and moved-from
+  // instances and for empty files.
+  bool isEmpty() const;
+
+  // Returns the size of the mapped file in bytes.
+  size_t getSize() const;
+
+  // Returns a pointer to the first byte of the file, interpreted as an array of T. The mapping is
+  // page-aligned, so any T with a fundamental alignment can be used. This is nullptr if the mapping
+  // is empty.
+  template <typename T = uint8_t>
+  T const* getData() const {
+    return static_cast<T const*>(mData);
+  }
+
+  // Returns the number of complete elements of type T in the file. Trailing bytes which do not
+  // form a complete element are ignored.
+  template <typename T = uint8_t>
+  size_t getCount() const {
+    return mSize / sizeof(T);
+  }
+
+  // Returns the content of the file as text. The view is not null-terminated.
+  std::string_view getString() const;
+
+ private:
+  void unmap();
+
+  void const* mData = nullptr;
+  size_t      mSize = 0;
+
+  // On Windows, this is the handle of the file mapping object.
+  void* mMapping = nullptr;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_MAPPED_FILE_HPP
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_PARALLEL_FOR_HPP
+#define ILLUSION_CORE_PARALLEL_FOR_HPP
+
+#include "TaskGroup.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// These helpers execute loops in parallel on a ThreadPool. The index range [begin, end) is split //
+// recursively into two halves until the parts are not larger than the grain size. One half is    //
+// pushed to the ThreadPool while the calling thread continues with the other half. This works    //
+// best with a ThreadPool using Scheduling::eWorkStealing, as idle workers will steal the largest //
+// remaining parts. The calling thread helps processing the range, so these can also be used from //
+// within tasks of the same ThreadPool.                                                           //
+// If no grain size is given, it is chosen so that each thread gets about eight parts. Ranges     //
+// which are not larger than one grain are processed directly on the calling thread, this is      //
+// always the case for single-threaded pools. If the body of the loop is very cheap, you should   //
+// provide a larger grain size.                                                                   //
+//                                                                                                //
+// parallelFor(pool, 0, nodes.size(), [&](size_t i) { nodes[i].update(); });                      //
+//                                                                                                //
+// float sum = parallelReduce(pool, 0, values.size(), 0.f,                                        //
+//     [&](size_t i) { return values[i]; },                                                       //
+//     [](float a, float b) { return a + b; });                                                   //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Returns the grain size which is used if none is given to the functions below.
+inline size_t getDefaultGrainSize(ThreadPool const& pool, size_t begin, size_t end) {
+
+  // There is no point in splitting the range if there is only one thread.
+  if (pool.getThreadCount() <= 1) {
+    return std::max<size_t>(1, end - begin);
+  }
+
+  size_t const partsPerThread = 8;
+  return std::max<size_t>(1, (end - begin) / (pool.getThreadCount() * partsPerThread));
+}
+
+// Calls body(rangeBegin, rangeEnd) for non-overlapping sub-ranges which together cover the range
+// [begin, end). Each sub-range will contain at most grainSize elements.
+template <typename F>
+void parallelForRange(ThreadPool& pool, size_t begin, size_t end, F const& body,
+    size_t grainSize = 0) {
+
+  if (end <= begin) {
+    return;
+  }
+
+  if (grainSize == 0) {
+    grainSize = getDefaultGrainSize(pool, begin, end);
+  }
+
+  // Small ranges are not worth the scheduling overhead.
+  if (end - begin <= grainSize) {
+    body(begin, end);
+    return;
+  }
+
+  TaskGroup group(pool);
+
+  // This splits the given range until it is small enough. The upper halves are pushed to the
+  // ThreadPool where they will be split further.
+  struct Splitter {
+    static void split(TaskGroup& group, size_t begin, size_t end, size_t grainSize, F const& body) {
+      while (end - begin > grainSize) {
+        size_t middle = begin + (end - begin) / 2;
+        group.run([&group, middle, end, grainSize, &body]() {
+          split(group, middle, end, grainSize, body);
+        });
+        end = middle;
+      }
+      body(begin, end);
+    }
+  };
+
+  Splitter::split(group, begin, end, grainSize, body);
+
+  group.wait();
+}
+
+// Calls body(i) for each i in [begin, end).
+template <typename F>
+void parallelFor(ThreadPool& pool, size_t begin, size_t end, F const& body, size_t grainSize = 0) {
+  parallelForRange(pool, begin, end,
+      [&body](size_t rangeBegin, size_t rangeEnd) {
+        for (size_t i(rangeBegin); i < rangeEnd; ++i) {
+          body(i);
+        }
+      },
+      grainSize);
+}
+
+// Computes reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1)) in
+// parallel. The range is divided into chunks of grainSize elements, each chunk is reduced
+// separately, starting with identity. Then the results of the chunks are reduced in order on the
+// calling thread. Therefore reduce has to be associative and identity has to be its neutral
+// element. For a given grain size, the result is deterministic, even for floating point values.
+template <typename T, typename M, typename R>
+T parallelReduce(ThreadPool& pool, size_t begin, size_t end, T const& identity, M const& map,
+    R const& reduce, size_t grainSize = 0) {
+
+  if (end <= begin) {
+    return identity;
+  }
+
+  if (grainSize == 0) {
+    grainSize = getDefaultGrainSize(pool, begin, end);
+  }
+
+  size_t         chunkCount = (end - begin + grainSize - 1) / grainSize;
+  std::vector<T> chunkResults(chunkCount, identity);
+
+  parallelFor(pool, 0, chunkCount,
+      [&](size_t chunk) {
+        size_t chunkBegin = begin + chunk * grainSize;
+        size_t chunkEnd   = std::min(chunkBegin + grainSize, end);
+
+        T result = identity;
+        for (size_t i(chunkBegin); i < chunkEnd; ++i) {
+          result = reduce(result, map(i));
+        }
+        chunkResults[chunk] = result;
+      },
+      1);
+
+  T result = identity;
+  for (auto const& chunkResult : chunkResults) {
+    result = reduce(result, chunkResult);
+  }
+
+  return result;
+}
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_PARALLEL_FOR_HPP
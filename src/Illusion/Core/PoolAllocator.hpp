@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_POOL_ALLOCATOR_HPP
+#define ILLUSION_CORE_POOL_ALLOCATOR_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// All BlockPools count the blocks they request from the system in one shared counter. Once all   //
+// BlockPools have reached their maximum number of simultaneously allocated blocks, it stops      //
+// increasing. This can be used to check that a code path does not allocate in its steady state. //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class BlockPoolStatistics {
+ public:
+  // Returns the total number of blocks which have been allocated by all BlockPools so far.
+  static size_t getAllocatedBlocks() {
+    return getCounter().load(std::memory_order_relaxed);
+  }
+
+ protected:
+  static std::atomic<size_t>& getCounter() {
+    static std::atomic<size_t> counter{0};
+    return counter;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The BlockPool recycles memory blocks of a fixed size. Freed blocks are not returned to the     //
+// system but stored in a free-list; allocate() will reuse them. Therefore, once a program has    //
+// reached its maximum number of simultaneously allocated blocks, no further heap allocations     //
+// are made. There is one global instance per block size and alignment, it is thread-safe.        //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <size_t Size, size_t Alignment>
+class BlockPool : public BlockPoolStatistics {
+ public:
+  static BlockPool& get() {
+    static BlockPool instance;
+    return instance;
+  }
+
+  ~BlockPool() {
+    for (void* block : mFreeBlocks) {
+      ::operator delete(block, std::align_val_t(Alignment));
+    }
+  }
+
+  void* allocate() {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      if (!mFreeBlocks.empty()) {
+        void* block = mFreeBlocks.back();
+        mFreeBlocks.pop_back();
+        return block;
+      }
+    }
+
+    getCounter().fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(Size, std::align_val_t(Alignment));
+  }
+
+  void deallocate(void* block) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFreeBlocks.push_back(block);
+  }
+
+ private:
+  BlockPool() = default;
+
+  std::vector<void*> mFreeBlocks;
+  std::mutex         mMutex;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A standard-conforming allocator which allocates single objects from the BlockPool matching     //
+// the size and alignment of T. Arrays are allocated with std::allocator. This can be used with   //
+// std::allocate_shared() or std::promise in order to recycle their shared states.                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class PoolAllocator {
+ public:
+  typedef T value_type;
+
+  PoolAllocator() = default;
+
+  template <typename U>
+  PoolAllocator(PoolAllocator<U> const&) {
+  }
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::get().allocate());
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    BlockPool<sizeof(T), alignof(T)>::get().deallocate(p);
+  }
+
+  template <typename U>
+  bool operator==(PoolAllocator<U> const&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(PoolAllocator<U> const&) const {
+    return false;
+  }
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_POOL_ALLOCATOR_HPP
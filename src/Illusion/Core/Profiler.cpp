@@ -0,0 +1,634 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+namespace Illusion::Core {
+
+std::atomic<bool> Profiler::sEnabled{false};
+std::atomic<bool> Profiler::sRecording{false};
+
+namespace {
+
+// The begin or the end of a zone. mName is nullptr for end events. The time is in ticks, see
+// getTicks().
+struct Event {
+  char const* mName;
+  int64_t     mTime;
+};
+
+int64_t getNanoseconds() {
+  auto time = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+// Reading the time stamp counter is several times faster than std::chrono::steady_clock. The ticks
+// are converted to nanoseconds with a factor which is calibrated against the steady_clock. On other
+// architectures, the ticks are simply nanoseconds.
+int64_t getTicks() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  return static_cast<int64_t>(__rdtsc());
+#else
+  return getNanoseconds();
+#endif
+}
+
+const uint64_t BUFFER_SIZE = 16384;
+
+// A single-producer single-consumer ring buffer. The owning thread writes events, nextFrame()
+// reads them.
+struct ThreadBuffer {
+  std::unique_ptr<Event[]> mEvents = std::make_unique<Event[]>(BUFFER_SIZE);
+
+  alignas(64) std::atomic<uint64_t> mWritePos{0};
+  alignas(64) std::atomic<uint64_t> mReadPos{0};
+  std::atomic<bool> mExpired{false};
+
+  // The number of recorded zones which have not been ended yet. Only accessed by the owning
+  // thread. For each of them, one slot is kept free so that endZone() never fails.
+  uint32_t mOpenZones = 0;
+
+  // The zone IDs and begin times of the zones which are currently open on this thread. Only
+  // accessed by nextFrame().
+  std::vector<std::pair<uint32_t, int64_t>> mStack;
+
+  // The name is set by setThreadName() and protected by State::mBufferMutex. mTrack is the index
+  // of this thread in State::mTrackNames; it is assigned when the first trace event of this thread
+  // is recorded.
+  std::string mName;
+  uint32_t    mTrack = ~0u;
+};
+
+struct ZoneData {
+  std::string_view mName;
+  uint32_t         mParent;
+  uint32_t         mDepth;
+
+  // The time spent in this zone during the current frame.
+  double   mCurrentTime  = 0.0;
+  uint32_t mCurrentCalls = 0;
+  uint32_t mLastCalls    = 0;
+
+  // A ring buffer containing the per-frame times of the most recent frames.
+  std::vector<double> mHistory;
+  size_t              mHistoryPos = 0;
+
+  // Maps the name pointers of child zones to their IDs. This is much faster than the lookup in
+  // State::mZoneIDs, which has to compare the strings.
+  std::vector<std::pair<char const*, uint32_t>> mChildren;
+};
+
+struct State {
+  // Protects mBuffers.
+  std::mutex                                 mBufferMutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;
+
+  // Protects all members below.
+  std::mutex                                                mZoneMutex;
+  std::map<std::pair<uint32_t, std::string_view>, uint32_t> mZoneIDs;
+  std::vector<ZoneData>                                     mZones;
+  std::vector<std::pair<char const*, uint32_t>>             mRootZones;
+  uint32_t                                                  mFrameWindow = 100;
+
+  // The events which have been recorded since startRecording(). The track of an event is an index
+  // into mTrackNames; it is used as thread ID in the written trace.
+  struct TraceEvent {
+    std::string mName;
+    uint32_t    mTrack;
+    int64_t     mBegin;
+    int64_t     mDuration;
+  };
+
+  std::vector<TraceEvent>         mTraceEvents;
+  std::vector<std::string>        mTrackNames;
+  std::map<std::string, uint32_t> mCustomTracks;
+  std::ofstream                   mTraceFile;
+  uint32_t                        mRemainingTraceFrames = 0;
+  bool                            mWasEnabled           = false;
+
+  // The reference points for converting ticks to nanoseconds.
+  int64_t mStartTicks;
+  int64_t mStartTime;
+  double  mNanosecondsPerTick;
+
+  std::atomic<uint64_t> mDroppedZones{0};
+
+  // Initially, the ticks are calibrated over one millisecond. The factor is refined in each call
+  // to nextFrame().
+  State()
+      : mStartTicks(getTicks())
+      , mStartTime(getNanoseconds()) {
+    while (getNanoseconds() - mStartTime < 1000000) {
+    }
+    calibrate();
+  }
+
+  void calibrate() {
+    mNanosecondsPerTick = 1.0 * (getNanoseconds() - mStartTime) / (getTicks() - mStartTicks);
+  }
+
+  // Converts ticks to the same clock as Profiler::getTime().
+  int64_t toNanoseconds(int64_t ticks) const {
+    return mStartTime + static_cast<int64_t>((ticks - mStartTicks) * mNanosecondsPerTick);
+  }
+};
+
+State& getState() {
+  static State state;
+  return state;
+}
+
+// Owns the ThreadBuffer of a thread. The buffer is only created when the thread enters its first
+// zone while the Profiler is enabled, so threads which are never profiled neither allocate a buffer
+// nor construct the State. When the thread exits, the buffer is removed right away if all of its
+// events have been processed. Else it is marked as expired and removed by nextFrame() once this
+// has happened.
+struct ThreadBufferHandle {
+  ~ThreadBufferHandle() {
+    if (!mBuffer) {
+      return;
+    }
+
+    auto&                       state = getState();
+    std::lock_guard<std::mutex> lock(state.mBufferMutex);
+
+    if (mBuffer->mReadPos.load() == mBuffer->mWritePos.load()) {
+      state.mBuffers.erase(std::find(state.mBuffers.begin(), state.mBuffers.end(), mBuffer));
+    } else {
+      mBuffer->mExpired = true;
+    }
+  }
+
+  ThreadBuffer& get() {
+    if (!mBuffer) {
+      mBuffer = std::make_shared<ThreadBuffer>();
+
+      auto&                       state = getState();
+      std::lock_guard<std::mutex> lock(state.mBufferMutex);
+      mBuffer->mName = mName;
+      state.mBuffers.push_back(mBuffer);
+    }
+    return *mBuffer;
+  }
+
+  // The name given to setThreadName(). It is copied to the buffer when this is created.
+  std::string                   mName;
+  std::shared_ptr<ThreadBuffer> mBuffer;
+};
+
+ThreadBufferHandle& getThreadBufferHandle() {
+  static thread_local ThreadBufferHandle handle;
+  return handle;
+}
+
+ThreadBuffer& getThreadBuffer() {
+  return getThreadBufferHandle().get();
+}
+
+// Appends an event to the given buffer if there are at least the given number of free slots.
+bool push(ThreadBuffer& buffer, Event const& event, uint64_t requiredSlots) {
+  uint64_t writePos = buffer.mWritePos.load(std::memory_order_relaxed);
+  uint64_t readPos  = buffer.mReadPos.load(std::memory_order_acquire);
+
+  if (BUFFER_SIZE - (writePos - readPos) < requiredSlots) {
+    return false;
+  }
+
+  buffer.mEvents[writePos % BUFFER_SIZE] = event;
+  buffer.mWritePos.store(writePos + 1, std::memory_order_release);
+  return true;
+}
+
+uint32_t getZoneID(State& state, uint32_t parent, char const* name) {
+  auto& cache = parent == Profiler::NO_PARENT ? state.mRootZones : state.mZones[parent].mChildren;
+
+  for (auto const& child : cache) {
+    if (child.first == name) {
+      return child.second;
+    }
+  }
+
+  // The same name may be stored at different addresses, so we have to compare the strings before
+  // creating a new zone.
+  auto result = state.mZoneIDs.emplace(
+      std::make_pair(parent, name), static_cast<uint32_t>(state.mZones.size()));
+
+  if (result.second) {
+    ZoneData zone;
+    zone.mName   = name;
+    zone.mParent = parent;
+    zone.mDepth  = parent == Profiler::NO_PARENT ? 0 : state.mZones[parent].mDepth + 1;
+    zone.mHistory.reserve(state.mFrameWindow);
+    state.mZones.push_back(std::move(zone));
+  }
+
+  // The reference to the cache may have been invalidated by push_back().
+  uint32_t id = result.first->second;
+  (parent == Profiler::NO_PARENT ? state.mRootZones : state.mZones[parent].mChildren)
+      .emplace_back(name, id);
+
+  return id;
+}
+
+// Returns the track of the given thread, creating one if necessary. The caller has to hold both
+// mutexes of the State.
+uint32_t getTrack(State& state, ThreadBuffer& buffer) {
+  if (buffer.mTrack == ~0u) {
+    buffer.mTrack = static_cast<uint32_t>(state.mTrackNames.size());
+    state.mTrackNames.push_back(
+        buffer.mName.empty() ? "Thread " + std::to_string(buffer.mTrack) : buffer.mName);
+  }
+  return buffer.mTrack;
+}
+
+// Processes all events which have been written to the given buffer since the last call.
+void processEvents(State& state, ThreadBuffer& buffer) {
+  uint64_t readPos  = buffer.mReadPos.load(std::memory_order_relaxed);
+  uint64_t writePos = buffer.mWritePos.load(std::memory_order_acquire);
+
+  for (uint64_t i(readPos); i < writePos; ++i) {
+    Event const& event = buffer.mEvents[i % BUFFER_SIZE];
+
+    if (event.mName) {
+      uint32_t parent = buffer.mStack.empty() ? Profiler::NO_PARENT : buffer.mStack.back().first;
+      buffer.mStack.emplace_back(getZoneID(state, parent, event.mName), event.mTime);
+    } else if (!buffer.mStack.empty()) {
+      auto&   zone     = state.mZones[buffer.mStack.back().first];
+      int64_t begin    = state.toNanoseconds(buffer.mStack.back().second);
+      int64_t duration = state.toNanoseconds(event.mTime) - begin;
+
+      zone.mCurrentTime += duration * 0.000001;
+      ++zone.mCurrentCalls;
+      buffer.mStack.pop_back();
+
+      if (Profiler::isRecording()) {
+        state.mTraceEvents.push_back(
+            {std::string(zone.mName), getTrack(state, buffer), begin, duration});
+      }
+    }
+  }
+
+  buffer.mReadPos.store(writePos, std::memory_order_release);
+}
+
+void writeEscaped(std::ostream& os, std::string const& text) {
+  os << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << ' ';
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+// The events of a finished recording. They are moved out of the State, so that the file can be
+// written without holding any lock.
+struct FinishedTrace {
+  std::vector<State::TraceEvent> mEvents;
+  std::vector<std::string>       mTrackNames;
+  std::ofstream                  mFile;
+};
+
+// Stops the recording and moves all recorded events out of the State. The caller has to hold both
+// mutexes of the State.
+FinishedTrace finishRecording(State& state) {
+  FinishedTrace trace;
+  trace.mEvents     = std::move(state.mTraceEvents);
+  trace.mTrackNames = std::move(state.mTrackNames);
+  trace.mFile       = std::move(state.mTraceFile);
+
+  state.mTraceEvents.clear();
+  state.mTrackNames.clear();
+  state.mCustomTracks.clear();
+
+  for (auto& buffer : state.mBuffers) {
+    buffer->mTrack = ~0u;
+  }
+
+  Profiler::setEnabled(state.mWasEnabled);
+
+  return trace;
+}
+
+// Writes all events of a finished recording in the Chrome trace event format. The time stamps are
+// in microseconds relative to the first event.
+void writeTrace(FinishedTrace& trace) {
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (auto const& event : trace.mEvents) {
+    origin = std::min(origin, event.mBegin);
+  }
+
+  auto& os = trace.mFile;
+  os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+
+  for (uint32_t i(0); i < trace.mTrackNames.size(); ++i) {
+    os << (i == 0 ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << i
+       << R"(,"args":{"name":)";
+    writeEscaped(os, trace.mTrackNames[i]);
+    os << "}}";
+  }
+
+  for (auto const& event : trace.mEvents) {
+    os << ",\n{\"name\":";
+    writeEscaped(os, event.mName);
+    os << R"(,"ph":"X","pid":0,"tid":)" << event.mTrack
+       << ",\"ts\":" << (event.mBegin - origin) * 0.001 << ",\"dur\":" << event.mDuration * 0.001
+       << "}";
+  }
+
+  os << "\n]}\n";
+  trace.mFile.close();
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::setEnabled(bool enable) {
+  sEnabled.store(enable, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Profiler::beginZone(char const* name) {
+  auto& buffer = getThreadBuffer();
+
+  // Keep one slot for the end event of this zone and one for each currently open zone.
+  if (!push(buffer, {name, getTicks()}, buffer.mOpenZones + 2)) {
+    getState().mDroppedZones.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  ++buffer.mOpenZones;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::endZone() {
+  auto& buffer = getThreadBuffer();
+  push(buffer, {nullptr, getTicks()}, 1);
+  --buffer.mOpenZones;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::nextFrame() {
+  auto&                        state = getState();
+  std::unique_lock<std::mutex> zoneLock(state.mZoneMutex);
+  std::optional<FinishedTrace> trace;
+
+  state.calibrate();
+
+  {
+    std::lock_guard<std::mutex> bufferLock(state.mBufferMutex);
+
+    for (auto it = state.mBuffers.begin(); it != state.mBuffers.end();) {
+      // The expired flag has to be loaded before the events are processed. Else we might miss
+      // events which have been written right before the thread exited.
+      bool expired = (*it)->mExpired;
+      processEvents(state, **it);
+
+      if (expired) {
+        it = state.mBuffers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    if (isRecording() && --state.mRemainingTraceFrames == 0) {
+      sRecording = false;
+      trace      = finishRecording(state);
+    }
+  }
+
+  for (auto& zone : state.mZones) {
+    if (zone.mCurrentCalls == 0) {
+      continue;
+    }
+
+    if (zone.mHistory.size() < state.mFrameWindow) {
+      zone.mHistory.push_back(zone.mCurrentTime);
+    } else {
+      zone.mHistory[zone.mHistoryPos] = zone.mCurrentTime;
+    }
+
+    zone.mHistoryPos   = (zone.mHistoryPos + 1) % state.mFrameWindow;
+    zone.mLastCalls    = zone.mCurrentCalls;
+    zone.mCurrentTime  = 0.0;
+    zone.mCurrentCalls = 0;
+  }
+
+  // Writing the trace may take a while, so this is done after releasing the lock.
+  if (trace) {
+    zoneLock.unlock();
+    writeTrace(*trace);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::setFrameWindow(uint32_t frames) {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+  state.mFrameWindow = std::max(frames, 1u);
+
+  for (auto& zone : state.mZones) {
+    zone.mHistory.clear();
+    zone.mHistory.reserve(state.mFrameWindow);
+    zone.mHistoryPos = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t Profiler::getFrameWindow() {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+  return state.mFrameWindow;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Profiler::ZoneStatistics> Profiler::getStatistics() {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+
+  std::vector<std::vector<uint32_t>> children(state.mZones.size());
+  std::vector<uint32_t>              stack;
+
+  // Zones are created after their parents, so pushing them in reverse order onto the stack results
+  // in a depth-first traversal in creation order.
+  for (uint32_t i(static_cast<uint32_t>(state.mZones.size())); i-- > 0;) {
+    if (state.mZones[i].mParent == NO_PARENT) {
+      stack.push_back(i);
+    } else {
+      children[state.mZones[i].mParent].push_back(i);
+    }
+  }
+
+  std::vector<ZoneStatistics> result;
+  std::vector<uint32_t>       resultIndices(state.mZones.size());
+  std::vector<double>         sorted;
+
+  while (!stack.empty()) {
+    uint32_t id = stack.back();
+    stack.pop_back();
+    stack.insert(stack.end(), children[id].begin(), children[id].end());
+
+    auto const& zone = state.mZones[id];
+
+    ZoneStatistics statistics{};
+    statistics.mName   = std::string(zone.mName);
+    statistics.mDepth  = zone.mDepth;
+    statistics.mParent = zone.mParent == NO_PARENT ? NO_PARENT : resultIndices[zone.mParent];
+    statistics.mFrames = static_cast<uint32_t>(zone.mHistory.size());
+    statistics.mCalls  = zone.mLastCalls;
+
+    if (!zone.mHistory.empty()) {
+      sorted.assign(zone.mHistory.begin(), zone.mHistory.end());
+      std::sort(sorted.begin(), sorted.end());
+
+      size_t p99 = static_cast<size_t>(std::ceil(sorted.size() * 0.99)) - 1;
+
+      statistics.mMin = sorted.front();
+      statistics.mMax = sorted.back();
+      statistics.mP99 = sorted[p99];
+
+      for (double time : sorted) {
+        statistics.mAvg += time;
+      }
+      statistics.mAvg /= sorted.size();
+    }
+
+    resultIndices[id] = static_cast<uint32_t>(result.size());
+    result.push_back(std::move(statistics));
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::clearStatistics() {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+
+  for (auto& zone : state.mZones) {
+    zone.mHistory.clear();
+    zone.mHistoryPos   = 0;
+    zone.mCurrentTime  = 0.0;
+    zone.mCurrentCalls = 0;
+    zone.mLastCalls    = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Profiler::getDroppedZones() {
+  return getState().mDroppedZones.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::startRecording(std::string const& fileName, uint32_t frames) {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+
+  if (isRecording()) {
+    throw std::runtime_error("Failed to record trace to \"" + fileName +
+                             "\": There is already a recording in progress!");
+  }
+
+  state.mTraceFile.open(fileName);
+  if (!state.mTraceFile) {
+    throw std::runtime_error("Failed to record trace: Cannot open file \"" + fileName + "\"!");
+  }
+
+  state.mRemainingTraceFrames = std::max(frames, 1u);
+  state.mWasEnabled           = isEnabled();
+
+  setEnabled(true);
+  sRecording = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t Profiler::getRemainingRecordedFrames() {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+  return isRecording() ? state.mRemainingTraceFrames : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::setThreadName(std::string const& name) {
+  auto& handle = getThreadBufferHandle();
+  handle.mName = name;
+
+  // If the thread has not entered any zone yet, the name is only stored in the handle.
+  if (handle.mBuffer) {
+    auto&                       state = getState();
+    std::lock_guard<std::mutex> lock(state.mBufferMutex);
+    handle.mBuffer->mName = name;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64_t Profiler::getTime() {
+  return getNanoseconds();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::addSpan(
+    std::string const& track, std::string const& name, int64_t begin, int64_t end) {
+  auto&                       state = getState();
+  std::lock_guard<std::mutex> lock(state.mZoneMutex);
+
+  if (!isRecording()) {
+    return;
+  }
+
+  auto trackIt = state.mCustomTracks.find(track);
+  if (trackIt == state.mCustomTracks.end()) {
+    trackIt =
+        state.mCustomTracks.emplace(track, static_cast<uint32_t>(state.mTrackNames.size())).first;
+    state.mTrackNames.push_back(track);
+  }
+
+  state.mTraceEvents.push_back({name, trackIt->second, begin, end - begin});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_PROFILER_HPP
+#define ILLUSION_CORE_PROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The Profiler measures how much time is spent in named zones of code. In contrast to the        //
+// ScopedTimer, it does not print anything; the durations are accumulated per frame and can be    //
+// queried as statistics over the most recent frames. A zone is usually opened with the macro at  //
+// the bottom of this file and lasts until the end of the enclosing scope:                        //
+//                                                                                                //
+// void CommandBuffer::flush() {                                                                  //
+//   ILLUSION_PROFILE_ZONE("CommandBuffer::flush");                                               //
+//   ...                                                                                          //
+// }                                                                                              //
+//                                                                                                //
+// Zones can be nested; a zone is identified by its name and by its parent zone. Zones with the   //
+// same path which are entered on different threads are accumulated together.                     //
+// Each thread writes the begin and end timestamps of its zones to its own ring buffer; this does //
+// neither lock nor allocate. The buffer is allocated when the thread enters its first zone while //
+// the Profiler is enabled. The buffers are evaluated in nextFrame(), which has to be called once //
+// per frame. Graphics::FrameGraph::process() does this, so applications using a FrameGraph do    //
+// not have to; other render loops have to call it themselves. If a buffer is full, new zones of  //
+// this thread are discarded and counted (see getDroppedZones()). When the Profiler is disabled,  //
+// a zone costs one relaxed atomic load.                                                          //
+// Additionally, all zones of a number of frames can be recorded to a file in the Chrome trace    //
+// event format. Such files can be viewed with chrome://tracing or https://ui.perfetto.dev. Each  //
+// thread is shown on its own track; spans which have been measured elsewhere (for example GPU    //
+// timings) can be added to further tracks with addSpan().                                        //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Profiler {
+ public:
+  // The statistics of a zone. All times are in milliseconds and refer to the accumulated time
+  // spent in this zone per frame. Only frames in which the zone has been entered are considered.
+  struct ZoneStatistics {
+    std::string mName;
+    uint32_t    mDepth;  // The nesting depth, zero for root zones.
+    uint32_t    mParent; // The index of the parent zone or NO_PARENT for root zones.
+    uint32_t    mFrames; // The number of frames from which the statistics are computed.
+    uint32_t    mCalls;  // The number of times the zone was entered in its most recent frame.
+    double      mMin;
+    double      mAvg;
+    double      mMax;
+    double      mP99;
+  };
+
+  static constexpr uint32_t NO_PARENT = ~0u;
+
+  // Use the ILLUSION_PROFILE_ZONE macro instead of creating instances of this class directly. The
+  // name has to be valid during the entire program lifetime (usually it is a string literal).
+  class Zone {
+   public:
+    explicit Zone(char const* name)
+        : mActive(isEnabled() && beginZone(name)) {
+    }
+
+    ~Zone() {
+      if (mActive) {
+        endZone();
+      }
+    }
+
+    Zone(Zone const& other) = delete;
+    Zone& operator=(Zone const& other) = delete;
+
+   private:
+    bool mActive;
+  };
+
+  // The Profiler is disabled by default. Zones which have been entered before enabling the
+  // Profiler are not recorded.
+  static void setEnabled(bool enable);
+  static bool isEnabled() {
+    return sEnabled.load(std::memory_order_relaxed);
+  }
+
+  // Records the begin and the end of a zone on the calling thread. beginZone() returns false if
+  // the zone has been discarded because the thread's buffer is full; endZone() must only be
+  // called for zones which have been recorded. Usually these are called by the Zone class.
+  static bool beginZone(char const* name);
+  static void endZone();
+
+  // Evaluates the zones which have been finished by all threads since the last call and finishes
+  // the current frame. This should be called once per frame, always from the same thread. This is
+  // done by Graphics::FrameGraph::process() unless it is called with eSkipProfilerFrame.
+  static void nextFrame();
+
+  // The statistics are computed over the given number of most recent frames. Changing the window
+  // clears all statistics. The default is 100 frames.
+  static void     setFrameWindow(uint32_t frames);
+  static uint32_t getFrameWindow();
+
+  // Returns the statistics of all zones which have been entered so far in depth-first order: Each
+  // zone is directly followed by its child zones.
+  static std::vector<ZoneStatistics> getStatistics();
+
+  // Discards the statistics of all zones.
+  static void clearStatistics();
+
+  // Returns the number of zones which have been discarded because a thread's buffer was full.
+  static uint64_t getDroppedZones();
+
+  // Records all zones which end during the next given number of frames (that is calls to
+  // nextFrame()) and writes them to the given file afterwards. The Profiler is enabled during the
+  // recording. A std::runtime_error is thrown if the file cannot be opened or if there is already a
+  // recording in progress.
+  static void startRecording(std::string const& fileName, uint32_t frames = 1);
+  static bool isRecording() {
+    return sRecording.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of calls to nextFrame() until the current recording is finished, or zero if
+  // there is no recording in progress. Components which add spans with a delay (like the
+  // FrameGraph with its GPU timestamps) can use this to add all pending spans before the last call.
+  static uint32_t getRemainingRecordedFrames();
+
+  // Sets the name of the calling thread's track in recorded traces. This neither allocates the
+  // thread's buffer nor initializes the Profiler, so it can be called for any thread.
+  static void setThreadName(std::string const& name);
+
+  // Returns the current time in nanoseconds. This is the clock which is used for all recorded
+  // events; it is based on std::chrono::steady_clock.
+  static int64_t getTime();
+
+  // Adds a span to the given track of the current recording. The begin and end times have to be
+  // given in nanoseconds as returned by getTime(). This does nothing if there is no recording in
+  // progress. Note that the Graphics::FrameGraph does not calibrate the GPU clock against this
+  // clock: The GPU spans are shifted so that the first one begins when the frame is submitted. So
+  // their durations are exact, but they appear earlier than they actually were executed.
+  static void addSpan(
+      std::string const& track, std::string const& name, int64_t begin, int64_t end);
+
+ private:
+  static std::atomic<bool> sEnabled;
+  static std::atomic<bool> sRecording;
+};
+
+} // namespace Illusion::Core
+
+// Opens a profiler zone which lasts until the end of the current scope.
+#define ILLUSION_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ILLUSION_PROFILE_CONCAT(a, b) ILLUSION_PROFILE_CONCAT_IMPL(a, b)
+#define ILLUSION_PROFILE_ZONE(name)                                                                \
+  Illusion::Core::Profiler::Zone ILLUSION_PROFILE_CONCAT(illusionProfilerZone, __LINE__)(name)
+
+#endif // ILLUSION_CORE_PROFILER_HPP
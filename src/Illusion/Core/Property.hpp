@@ -9,15 +9,20 @@
 #ifndef ILLUSION_CORE_PROPERTY_HPP
 #define ILLUSION_CORE_PROPERTY_HPP
 
+#include "PropertyTransaction.hpp"
 #include "Signal.hpp"
 
 #include <glm/glm.hpp>
 
+#include <optional>
+
 namespace Illusion::Core {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // A Property encpsulates a value and may inform you on any changes                               //
-// applied to this value.                                                                         //
+// applied to this value. If a PropertyTransaction exists on the current thread, the              //
+// notifications are deferred until the transaction is finished. In this case, beforeChange() is  //
+// emitted late: its callbacks will already see the final value when calling get().               //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
@@ -46,7 +51,11 @@ class Property {
       : mValue(std::move(toCopy.mValue)) {
   }
 
-  virtual ~Property() = default;
+  virtual ~Property() {
+    if (mHasPendingNotification) {
+      PropertyTransaction::forget(this);
+    }
+  }
 
   // Returns a Signal which is fired when the internal value will be changed.
   // The old value is passed as parameter.
@@ -60,12 +69,18 @@ class Property {
     return mOnChange;
   }
 
-  // Sets the Property to a new value. beforeChange() and onChange() will be emitted.
+  // Sets the Property to a new value. beforeChange() and onChange() will be emitted - either
+  // immediately or when the current PropertyTransaction is finished.
   virtual void set(T const& value) {
     if (value != mValue) {
-      mBeforeChange.emit(value);
-      mValue = value;
-      mOnChange.emit(value);
+      if (PropertyTransaction::isActive()) {
+        deferNotification();
+        mValue = value;
+      } else {
+        mBeforeChange.emit(value);
+        mValue = value;
+        mOnChange.emit(value);
+      }
     }
   }
 
@@ -76,8 +91,13 @@ class Property {
 
   // Emits beforeChange() and onChange() even if the value did not change
   void touch() {
-    mBeforeChange.emit(mValue);
-    mOnChange.emit(mValue);
+    if (PropertyTransaction::isActive()) {
+      deferNotification();
+      mIsTouched = true;
+    } else {
+      mBeforeChange.emit(mValue);
+      mOnChange.emit(mValue);
+    }
   }
 
   // Returns the internal value
@@ -150,12 +170,41 @@ class Property {
   }
 
  private:
+  // Records this Property in the current PropertyTransaction (if not already done). This has to
+  // be called before the value is changed, as the value from before the transaction is stored.
+  void deferNotification() {
+    if (!mHasPendingNotification) {
+      mHasPendingNotification = true;
+      mValueBeforeTransaction = mValue;
+      PropertyTransaction::record(this, &Property<T>::emitDeferredNotification);
+    }
+  }
+
+  // This is called by the PropertyTransaction when it is finished. If the Property has been set
+  // back to its original value and has not been touched, nothing is emitted.
+  static void emitDeferredNotification(void* property) {
+    auto self    = static_cast<Property<T>*>(property);
+    bool changed = self->mIsTouched || *self->mValueBeforeTransaction != self->mValue;
+
+    self->mHasPendingNotification = false;
+    self->mIsTouched              = false;
+    self->mValueBeforeTransaction.reset();
+
+    if (changed) {
+      self->mBeforeChange.emit(self->mValue);
+      self->mOnChange.emit(self->mValue);
+    }
+  }
+
   T         mValue;
   Signal<T> mOnChange;
   Signal<T> mBeforeChange;
 
-  Property<T> const* mConnection   = nullptr;
-  uint32_t           mConnectionId = 0;
+  Property<T> const* mConnection             = nullptr;
+  uint32_t           mConnectionId           = 0;
+  bool               mHasPendingNotification = false;
+  bool               mIsTouched              = false;
+  std::optional<T>   mValueBeforeTransaction;
 };
 
 // stream operators
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PropertyTransaction.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+namespace Illusion::Core {
+
+thread_local uint32_t PropertyTransaction::sDepth = 0;
+
+namespace {
+
+struct Entry {
+  void* mProperty;
+  void (*mCommit)(void* property);
+};
+
+// The recorded Properties of one thread. The mutex is only contended if a Property is forgotten
+// on another thread. The vector is never shrunk, so recording does not allocate memory in the
+// steady state.
+struct EntryList {
+  std::mutex         mMutex;
+  std::vector<Entry> mEntries;
+};
+
+// The EntryLists of all threads. forget() has to search all of them, as a Property may be destroyed
+// on another thread than the one which recorded it.
+struct Registry {
+  std::mutex              mMutex;
+  std::vector<EntryList*> mLists;
+};
+
+Registry& getRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+// Registers the EntryList of a thread and removes it again when the thread exits.
+struct EntryListHandle {
+  EntryListHandle() {
+    auto&                        registry = getRegistry();
+    std::unique_lock<std::mutex> lock(registry.mMutex);
+    registry.mLists.push_back(&mList);
+  }
+
+  ~EntryListHandle() {
+    auto&                        registry = getRegistry();
+    std::unique_lock<std::mutex> lock(registry.mMutex);
+    registry.mLists.erase(std::find(registry.mLists.begin(), registry.mLists.end(), &mList));
+  }
+
+  EntryList mList;
+};
+
+EntryList& getEntryList() {
+  thread_local EntryListHandle handle;
+  return handle.mList;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PropertyTransaction::PropertyTransaction() {
+  ++sDepth;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PropertyTransaction::~PropertyTransaction() {
+  try {
+    commit();
+  } catch (...) {
+    // Exceptions must not leave the destructor.
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PropertyTransaction::commit() {
+  if (mCommitted) {
+    return;
+  }
+
+  mCommitted = true;
+
+  if (sDepth > 1) {
+    --sDepth;
+    return;
+  }
+
+  // The transaction stays active while we emit the signals. Properties which are changed by the
+  // connected callbacks are appended to the list and processed in this loop as well. We must not
+  // keep references to the entries, as the vector may be reallocated by the callbacks. The mutex
+  // must not be held while a callback is executed, as it may record or forget Properties.
+  auto&              list = getEntryList();
+  std::exception_ptr exception;
+
+  for (size_t i(0);; ++i) {
+    Entry entry;
+
+    {
+      std::unique_lock<std::mutex> lock(list.mMutex);
+      if (i == list.mEntries.size()) {
+        list.mEntries.clear();
+        break;
+      }
+      entry = list.mEntries[i];
+    }
+
+    if (entry.mProperty) {
+      try {
+        entry.mCommit(entry.mProperty);
+      } catch (...) {
+        // Only the first exception is stored.
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    }
+  }
+
+  sDepth = 0;
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PropertyTransaction::record(void* property, void (*commit)(void* property)) {
+  auto&                        list = getEntryList();
+  std::unique_lock<std::mutex> lock(list.mMutex);
+  list.mEntries.push_back({property, commit});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PropertyTransaction::forget(void* property) {
+  // This is rare, so a linear search is fine. We do not erase the entry as forget() may be called
+  // while the entries are processed.
+  auto&                        registry = getRegistry();
+  std::unique_lock<std::mutex> registryLock(registry.mMutex);
+
+  for (auto list : registry.mLists) {
+    std::unique_lock<std::mutex> lock(list->mMutex);
+    for (auto& entry : list->mEntries) {
+      if (entry.mProperty == property) {
+        entry.mProperty = nullptr;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
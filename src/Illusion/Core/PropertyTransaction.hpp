@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_PROPERTY_TRANSACTION_HPP
+#define ILLUSION_CORE_PROPERTY_TRANSACTION_HPP
+
+#include <cstdint>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// While a PropertyTransaction exists, Properties which are changed on the same thread do not     //
+// emit their beforeChange() and onChange() signals immediately. Instead, each changed Property   //
+// is recorded once, and when the outermost PropertyTransaction is destroyed, all recorded        //
+// Properties emit their signals with their final value - in the order in which they have been    //
+// changed first. If these signals change other Properties (for example via connectFrom()), the   //
+// notifications of those are collapsed as well.                                                  //
+// Transactions can be nested; only the outermost one emits the signals. A Property which has     //
+// been changed and set back to its original value will not emit anything, unless it has been     //
+// touched. As beforeChange() is emitted at the end of the transaction as well, its callbacks     //
+// will already see the final value.                                                              //
+// The signals are emitted by commit(). If a callback throws, commit() rethrows the exception     //
+// once all other signals have been emitted. If commit() is not called, the destructor does it    //
+// and discards any exception.                                                                    //
+//                                                                                                //
+// {                                                                                              //
+//   PropertyTransaction transaction;                                                             //
+//   for (auto& value : values) {                                                                 //
+//     pSum = pSum.get() + value; // pSum.onChange() will be emitted only once                    //
+//   }                                                                                            //
+//   transaction.commit();                                                                        //
+// }                                                                                              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class PropertyTransaction {
+ public:
+  PropertyTransaction();
+
+  // Calls commit() if this has not been done before. Exceptions thrown by the callbacks are
+  // discarded in this case; call commit() before if you are interested in them.
+  ~PropertyTransaction();
+
+  PropertyTransaction(PropertyTransaction const& other) = delete;
+  PropertyTransaction& operator=(PropertyTransaction const& other) = delete;
+
+  // Finishes this transaction. If this is the outermost transaction on this thread, all recorded
+  // Properties will emit their signals. If one of the callbacks throws an exception, the remaining
+  // Properties still emit their signals; afterwards the first exception is rethrown. Calling this
+  // more than once has no effect.
+  void commit();
+
+  // Returns true if there is a PropertyTransaction on the calling thread.
+  static bool isActive() {
+    return sDepth > 0;
+  }
+
+  // These are used by the Property class. The given function will be called with the given
+  // Property pointer when the outermost transaction is finished. Each Property must be recorded
+  // only once until its commit function has been called. If a recorded Property is destroyed
+  // before, it has to call forget(). This may happen on any thread, but not while the transaction
+  // which recorded the Property is being committed.
+  static void record(void* property, void (*commit)(void* property));
+  static void forget(void* property);
+
+ private:
+  static thread_local uint32_t sDepth;
+
+  bool mCommitted = false;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_PROPERTY_TRANSACTION_HPP
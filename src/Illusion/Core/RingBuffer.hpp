@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_RING_BUFFER_HPP
+#define ILLUSION_CORE_RING_BUFFER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A double-ended queue which stores its items in one contiguous ring. In contrast to std::deque, //
+// it never releases memory: When items are pushed and popped at the same rate, it will not       //
+// allocate anything once it has grown large enough. The capacity is always a power of two. This  //
+// class is not thread-safe.                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class RingBuffer {
+ public:
+  bool empty() const {
+    return mSize == 0;
+  }
+
+  size_t size() const {
+    return mSize;
+  }
+
+  size_t capacity() const {
+    return mItems.size();
+  }
+
+  void push_back(T&& item) {
+    if (mSize == mItems.size()) {
+      grow();
+    }
+    mItems[(mFirst + mSize) & (mItems.size() - 1)] = std::move(item);
+    ++mSize;
+  }
+
+  // Moves the oldest item to the given reference. This must not be called on an empty RingBuffer.
+  void pop_front(T& item) {
+    item   = std::move(mItems[mFirst]);
+    mFirst = (mFirst + 1) & (mItems.size() - 1);
+    --mSize;
+  }
+
+  // Moves the newest item to the given reference. This must not be called on an empty RingBuffer.
+  void pop_back(T& item) {
+    --mSize;
+    item = std::move(mItems[(mFirst + mSize) & (mItems.size() - 1)]);
+  }
+
+ private:
+  void grow() {
+    std::vector<T> items(std::max<size_t>(16, mItems.size() * 2));
+    for (size_t i(0); i < mSize; ++i) {
+      items[i] = std::move(mItems[(mFirst + i) & (mItems.size() - 1)]);
+    }
+    mItems = std::move(items);
+    mFirst = 0;
+  }
+
+  std::vector<T> mItems;
+  size_t         mFirst = 0;
+  size_t         mSize  = 0;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_RING_BUFFER_HPP
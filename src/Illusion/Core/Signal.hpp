@@ -9,9 +9,11 @@
 #ifndef ILLUSION_CORE_SIGNAL_HPP
 #define ILLUSION_CORE_SIGNAL_HPP
 
+#include <atomic>
 #include <functional>
-#include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace Illusion::Core {
 
@@ -21,6 +23,12 @@ namespace Illusion::Core {
 // argument passed to emit() will be passed to the given function. Connect and disconnect methods //
 // may be called from different threads, but the callbacks will be called from the thread calling //
 // emit().                                                                                        //
+// The connected callbacks are stored in an immutable list. connect() and disconnect() create a   //
+// modified copy of this list and publish it atomically, emit() just loads the current list and   //
+// does not lock anything. Therefore emitting a Signal costs little more than the calls to the    //
+// connected callbacks, and callbacks may connect, disconnect or emit any Signal (including this  //
+// one) without deadlocks. If a callback is disconnected during an emit() from another thread, it //
+// may still be called once by this emit(). Old lists are deleted once no emit() is using them.   //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename... Parameters>
@@ -33,57 +41,165 @@ class Signal {
   Signal(Signal const&) {
   }
 
+  ~Signal() {
+    delete mSlots.load();
+  }
+
   // connects a member function of a given object to this Signal
   template <typename F, typename... Args>
   uint32_t connectMember(F&& f, Args&&... a) const {
-    std::unique_lock<std::mutex> lock(mMutex);
-    mCallbacks.insert(std::make_pair(++mCurrentId, std::bind(f, a...)));
-    return mCurrentId;
+    return connect(std::bind(f, a...));
   }
 
   // connects a std::function to the signal. The returned value can be used to
   // disconnect the function again
   uint32_t connect(std::function<bool(Parameters...)> const& callback) const {
     std::unique_lock<std::mutex> lock(mMutex);
-    mCallbacks.insert(std::make_pair(++mCurrentId, callback));
+
+    SlotList const* current = mSlots.load();
+    auto            slots   = current ? std::make_unique<SlotList>(*current)
+                                      : std::make_unique<SlotList>();
+    slots->push_back({++mCurrentId, callback});
+    publish(slots.release());
+
     return mCurrentId;
   }
 
   // disconnects a previously connected function
   void disconnect(uint32_t id) const {
     std::unique_lock<std::mutex> lock(mMutex);
-    mCallbacks.erase(id);
+
+    SlotList const* current = mSlots.load();
+    if (!current) {
+      return;
+    }
+
+    auto slots = std::make_unique<SlotList>();
+    for (auto const& slot : *current) {
+      if (slot.mId != id) {
+        slots->push_back(slot);
+      }
+    }
+
+    if (slots->size() != current->size()) {
+      publish(slots->empty() ? nullptr : slots.release());
+    }
   }
 
   // disconnects all previously connected functions
   void disconnectAll() const {
     std::unique_lock<std::mutex> lock(mMutex);
-    mCallbacks.clear();
+    publish(nullptr);
     mCurrentId = 0;
   }
 
   // calls all connected functions
   void emit(Parameters... p) {
-    std::unique_lock<std::mutex> lock(mMutex);
-    auto                         it(mCallbacks.begin());
-    while (it != mCallbacks.end()) {
-      if (it->second(p...)) {
-        ++it;
-      } else {
-        it = mCallbacks.erase(it);
+
+    // Fast path for Signals without any connection.
+    if (!mSlots.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    // The list which we load here will not be deleted as long as mActiveEmits is greater than zero.
+    // The counter has to be incremented before the list is loaded, see publish(). The guard
+    // decrements it again even if a callback throws.
+    EmitGuard       guard(*this);
+    SlotList const* slots = mSlots.load();
+
+    if (!slots) {
+      return;
+    }
+
+    // Fast path for Signals with one connection, this is the most common case for Properties.
+    if (slots->size() == 1) {
+      auto const& slot = slots->front();
+      if (!slot.mCallback(p...)) {
+        disconnect(slot.mId);
       }
+      return;
     }
+
+    for (auto const& slot : *slots) {
+      if (!slot.mCallback(p...)) {
+        disconnect(slot.mId);
+      }
+    }
+  }
+
+  // Returns the number of connected functions.
+  uint32_t getConnectionCount() const {
+    std::unique_lock<std::mutex> lock(mMutex);
+    SlotList const*              slots = mSlots.load();
+    return slots ? static_cast<uint32_t>(slots->size()) : 0;
   }
 
   // assignment creates new Signal
   Signal& operator=(Signal const&) {
     disconnectAll();
+    return *this;
   }
 
  private:
-  mutable std::map<uint32_t, std::function<bool(Parameters...)>> mCallbacks;
-  mutable uint32_t                                               mCurrentId = 0;
+  struct Slot {
+    uint32_t                           mId;
+    std::function<bool(Parameters...)> mCallback;
+  };
+
+  typedef std::vector<Slot> SlotList;
+
+  // Increments mActiveEmits of the given Signal for its lifetime. The last running emit() deletes
+  // the lists which have been replaced while it was running.
+  struct EmitGuard {
+    explicit EmitGuard(Signal const& signal)
+        : mSignal(signal) {
+      ++mSignal.mActiveEmits;
+    }
+
+    ~EmitGuard() {
+      if (--mSignal.mActiveEmits == 0 && mSignal.mHasRetiredSlots) {
+        std::unique_lock<std::mutex> lock(mSignal.mMutex);
+        mSignal.deleteRetired();
+      }
+    }
+
+    EmitGuard(EmitGuard const& other) = delete;
+    EmitGuard& operator=(EmitGuard const& other) = delete;
+
+    Signal const& mSignal;
+  };
+
+  // Replaces the current list of slots. The old list is deleted right away if there is no emit()
+  // running. Otherwise it is deleted when the last running emit() has finished. This must be called
+  // with mMutex locked.
+  void publish(SlotList const* slots) const {
+    SlotList const* old = mSlots.exchange(slots);
+
+    if (old) {
+      mRetiredSlots.emplace_back(old);
+      mHasRetiredSlots = true;
+    }
+
+    deleteRetired();
+  }
+
+  // Deletes the retired lists if no emit() is running. This must be called with mMutex locked. As
+  // mActiveEmits is incremented before an emit() loads mSlots, an emit() which starts after this
+  // check will already see the current list.
+  void deleteRetired() const {
+    if (mActiveEmits == 0) {
+      mRetiredSlots.clear();
+      mHasRetiredSlots = false;
+    }
+  }
+
+  mutable std::atomic<SlotList const*>                 mSlots{nullptr};
+  mutable std::atomic_uint                             mActiveEmits{0};
+  mutable std::atomic_bool                             mHasRetiredSlots{false};
+  mutable std::vector<std::unique_ptr<SlotList const>> mRetiredSlots;
+  mutable uint32_t                                     mCurrentId = 0;
 
+  // This is only used by connect() and disconnect(), emit() does not lock it.
   mutable std::mutex mMutex;
 };
 
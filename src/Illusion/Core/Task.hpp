@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_TASK_HPP
+#define ILLUSION_CORE_TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A Task is a move-only replacement for std::function<void()> which is used by the ThreadPool.   //
+// Callables which are not larger than INLINE_SIZE bytes are stored directly inside the Task, so  //
+// creating, moving and executing such a Task does not allocate any memory. This covers lambdas   //
+// capturing a handful of pointers or references. Larger callables are stored on the heap.        //
+// In contrast to std::function, the callable does not have to be copyable.                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Task {
+ public:
+  // Together with the pointer to the type-erased operations, a Task fits into one cache line.
+  static const size_t INLINE_SIZE = 48;
+
+  Task() = default;
+
+  template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+  Task(F&& f) {
+    using Callable = std::decay_t<F>;
+
+    if constexpr (isInline<Callable>()) {
+      new (&mStorage) Callable(std::forward<F>(f));
+    } else {
+      *reinterpret_cast<Callable**>(&mStorage) = new Callable(std::forward<F>(f));
+    }
+
+    mOperations = &OPERATIONS<Callable>;
+  }
+
+  Task(Task&& other) noexcept {
+    *this = std::move(other);
+  }
+
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.mOperations) {
+        other.mOperations->mMove(&other.mStorage, &mStorage);
+        mOperations       = other.mOperations;
+        other.mOperations = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  Task(Task const& other) = delete;
+  Task& operator=(Task const& other) = delete;
+
+  ~Task() {
+    reset();
+  }
+
+  // Executes the stored callable. This must not be called on an empty Task.
+  void operator()() {
+    mOperations->mInvoke(&mStorage);
+  }
+
+  // Returns true if there is a callable stored in this Task.
+  explicit operator bool() const {
+    return mOperations != nullptr;
+  }
+
+  // Destroys the stored callable (if any).
+  void reset() {
+    if (mOperations) {
+      mOperations->mDestroy(&mStorage);
+      mOperations = nullptr;
+    }
+  }
+
+  // Returns true if a callable of the given type will be stored without heap allocation.
+  template <typename Callable>
+  static constexpr bool isInline() {
+    return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Callable>;
+  }
+
+ private:
+  // For each type of callable, there is one static instance of these function pointers. They are
+  // used to invoke, move and destroy the type-erased callable in mStorage.
+  struct Operations {
+    void (*mInvoke)(void* storage);
+    void (*mMove)(void* from, void* to);
+    void (*mDestroy)(void* storage);
+  };
+
+  template <typename Callable>
+  static Callable* get(void* storage) {
+    if constexpr (isInline<Callable>()) {
+      return std::launder(reinterpret_cast<Callable*>(storage));
+    } else {
+      return *reinterpret_cast<Callable**>(storage);
+    }
+  }
+
+  template <typename Callable>
+  static constexpr Operations OPERATIONS = {
+      [](void* storage) { (*get<Callable>(storage))(); },
+      [](void* from, void* to) {
+        if constexpr (isInline<Callable>()) {
+          new (to) Callable(std::move(*get<Callable>(from)));
+          get<Callable>(from)->~Callable();
+        } else {
+          *reinterpret_cast<Callable**>(to) = get<Callable>(from);
+        }
+      },
+      [](void* storage) {
+        if constexpr (isInline<Callable>()) {
+          get<Callable>(storage)->~Callable();
+        } else {
+          delete get<Callable>(storage);
+        }
+      }};
+
+  std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> mStorage;
+  Operations const*                                              mOperations = nullptr;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_TASK_HPP
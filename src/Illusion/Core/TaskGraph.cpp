@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TaskGraph::TaskGraph(ThreadPool& pool)
+    : mGroup(pool) {
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TaskGraph::NodeId TaskGraph::addNode(std::function<void()> const& task) {
+  auto node   = std::make_unique<Node>();
+  node->mTask = task;
+  mNodes.push_back(std::move(node));
+  mDirty = true;
+  return static_cast<NodeId>(mNodes.size() - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::addDependency(NodeId before, NodeId after) {
+  if (before >= mNodes.size() || after >= mNodes.size()) {
+    throw std::runtime_error("Failed to add dependency to TaskGraph: Invalid node ID " +
+                             std::to_string(std::max(before, after)) + "!");
+  }
+
+  mNodes[before]->mSuccessors.push_back(mNodes[after].get());
+  ++mNodes[after]->mDependencyCount;
+  mDirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::clear() {
+  mNodes.clear();
+  mRoots.clear();
+  mDirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TaskGraph::getNodeCount() const {
+  return static_cast<uint32_t>(mNodes.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::run() {
+  if (mDirty) {
+    validate();
+  }
+
+  // Reset the dependency counters. This is the only thing which has to be done each time the graph
+  // is run.
+  for (auto const& node : mNodes) {
+    node->mPendingDependencies = node->mDependencyCount;
+  }
+
+  for (auto root : mRoots) {
+    schedule(root);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::wait() {
+  mGroup.wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::execute() {
+  run();
+  wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::validate() {
+  mRoots.clear();
+
+  for (auto const& node : mNodes) {
+    if (node->mDependencyCount == 0) {
+      mRoots.push_back(node.get());
+    }
+  }
+
+  // We do a topological sort (Kahn's algorithm) in order to detect cycles. If not all nodes can be
+  // visited this way, there is a cycle in the graph which would never be executed.
+  for (auto const& node : mNodes) {
+    node->mPendingDependencies = node->mDependencyCount;
+  }
+
+  std::vector<Node*> ready(mRoots);
+  size_t             visited = 0;
+
+  while (!ready.empty()) {
+    Node* node = ready.back();
+    ready.pop_back();
+    ++visited;
+
+    for (auto successor : node->mSuccessors) {
+      if (--successor->mPendingDependencies == 0) {
+        ready.push_back(successor);
+      }
+    }
+  }
+
+  if (visited != mNodes.size()) {
+    throw std::runtime_error("Failed to run TaskGraph: The graph contains a cycle!");
+  }
+
+  mDirty = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::schedule(Node* node) {
+  mGroup.run([this, node]() { process(node); });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGraph::process(Node* node) {
+  while (node) {
+    node->mTask();
+
+    // Release all successors. All but the last ready successor are pushed to the ThreadPool, the
+    // last one is executed directly by this thread. This saves one round-trip through the queues
+    // for chains of nodes.
+    Node* continuation = nullptr;
+
+    for (auto successor : node->mSuccessors) {
+      if (--successor->mPendingDependencies == 0) {
+        if (continuation) {
+          schedule(continuation);
+        }
+        continuation = successor;
+      }
+    }
+
+    node = continuation;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_TASK_GRAPH_HPP
+#define ILLUSION_CORE_TASK_GRAPH_HPP
+
+#include "TaskGroup.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The TaskGraph executes tasks with dependencies on a ThreadPool. First, the graph is built by   //
+// adding nodes and dependencies between them. Then it can be run as often as needed, for         //
+// example once each frame. Each node has an atomic counter of unfinished dependencies. When a    //
+// node has been executed, it decrements the counters of all its successors. Successors which     //
+// have no remaining dependencies are pushed to the ThreadPool right away - except for the last   //
+// one, which is executed directly by the same thread as a continuation.                          //
+//                                                                                                //
+// TaskGraph graph(pool);                                                                         //
+// auto animate = graph.addNode([&]() { updateAnimations(); });                                   //
+// auto cull    = graph.addNode([&]() { cullObjects(); });                                        //
+// auto record  = graph.addNode([&]() { recordCommands(); });                                     //
+// graph.addDependency(animate, cull);                                                            //
+// graph.addDependency(cull, record);                                                             //
+//                                                                                                //
+// // each frame:                                                                                 //
+// graph.run();                                                                                   //
+// graph.wait();                                                                                  //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class TaskGraph {
+ public:
+  typedef uint32_t NodeId;
+
+  explicit TaskGraph(ThreadPool& pool);
+
+  // The destructor waits until the graph has finished running.
+  ~TaskGraph() = default;
+
+  TaskGraph(TaskGraph const& other) = delete;
+  TaskGraph& operator=(TaskGraph const& other) = delete;
+
+  // Adds a new node to the graph. The returned ID can be used to add dependencies. The graph must
+  // not be modified while it is running.
+  NodeId addNode(std::function<void()> const& task);
+
+  // After this call, the node "after" will not be executed before the node "before" has finished.
+  // This will throw a std::runtime_error if one of the IDs is invalid.
+  void addDependency(NodeId before, NodeId after);
+
+  // Removes all nodes and dependencies.
+  void clear();
+
+  // Returns the number of nodes in the graph.
+  uint32_t getNodeCount() const;
+
+  // Pushes all nodes without dependencies to the ThreadPool. The other nodes will follow once
+  // their dependencies are satisfied. Before run() can be called again, wait() has to be called.
+  // If the graph contains a cycle, a std::runtime_error is thrown.
+  void run();
+
+  // Blocks until all nodes have been executed. The calling thread will help executing pending
+  // tasks of the ThreadPool in the meantime. If a node threw an exception, it will be rethrown
+  // here. In this case, the successors of the failed node have not been executed.
+  void wait();
+
+  // Same as run() followed by wait().
+  void execute();
+
+ private:
+  struct Node {
+    std::function<void()> mTask;
+    std::vector<Node*>    mSuccessors;
+    uint32_t              mDependencyCount = 0;
+    std::atomic_uint      mPendingDependencies{0};
+  };
+
+  void validate();
+  void schedule(Node* node);
+  void process(Node* node);
+
+  std::vector<std::unique_ptr<Node>> mNodes;
+  std::vector<Node*>                 mRoots;
+  bool                               mDirty = true;
+
+  // This has to be the last member: It is destroyed first and waits for all running nodes.
+  TaskGroup mGroup;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_TASK_GRAPH_HPP
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TaskGroup.hpp"
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : mPool(pool) {
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TaskGroup::~TaskGroup() {
+  // The tasks capture a pointer to this group, so we have to wait for them in any case.
+  mPool.waitUntil([this]() { return isDone(); });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGroup::wait() {
+  mPool.waitUntil([this]() { return isDone(); });
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(mExceptionMutex);
+    std::swap(exception, mException);
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool TaskGroup::isDone() const {
+  return mPendingTasks == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGroup::storeException(std::exception_ptr exception) {
+  std::unique_lock<std::mutex> lock(mExceptionMutex);
+
+  // Only the first exception is stored.
+  if (!mException) {
+    mException = exception;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TaskGroup::finish() {
+  // This group may be destroyed as soon as the counter reaches zero. Therefore we must not access
+  // any member afterwards.
+  ThreadPool& pool = mPool;
+  if (--mPendingTasks == 0) {
+    pool.notifyWaiters();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Core
@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_CORE_TASK_GROUP_HPP
+#define ILLUSION_CORE_TASK_GROUP_HPP
+
+#include "ThreadPool.hpp"
+
+#include <exception>
+
+namespace Illusion::Core {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A TaskGroup can be used to wait for a subset of the tasks of a ThreadPool. Tasks are added to  //
+// the group with run(), wait() then blocks until all of them have been finished. The waiting     //
+// thread does not sleep while there are pending tasks in the pool, it rather executes them       //
+// itself. Therefore it is safe to use a TaskGroup from within a task of the same ThreadPool -    //
+// even if the pool has only one thread. This makes nested fork-join parallelism possible:        //
+//                                                                                                //
+// TaskGroup group(pool);                                                                         //
+// for (auto& node : nodes) {                                                                     //
+//   group.run([&node]() { node.update(); });                                                     //
+// }                                                                                              //
+// group.wait();                                                                                  //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool);
+
+  // The destructor waits for all tasks of the group. Exceptions thrown by the tasks are discarded
+  // in this case; call wait() before if you are interested in them.
+  ~TaskGroup();
+
+  TaskGroup(TaskGroup const& other) = delete;
+  TaskGroup& operator=(TaskGroup const& other) = delete;
+
+  // Pushes a new task to the ThreadPool of this group. If the task throws an exception, it will be
+  // rethrown by wait().
+  template <typename F>
+  void run(F&& f) {
+    ++mPendingTasks;
+
+    mPool.push([this, task = std::forward<F>(f)]() mutable {
+      try {
+        task();
+      } catch (...) {
+        storeException(std::current_exception());
+      }
+      finish();
+    });
+  }
+
+  // Blocks until all tasks of this group have been finished. Pending tasks of the ThreadPool are
+  // executed by the calling thread in the meantime. If one of the tasks threw an exception, the
+  // first of them will be rethrown.
+  void wait();
+
+  // Returns true if all tasks of this group have been finished.
+  bool isDone() const;
+
+ private:
+  void storeException(std::exception_ptr exception);
+  void finish();
+
+  ThreadPool&        mPool;
+  std::atomic_uint   mPendingTasks = 0;
+  std::mutex         mExceptionMutex;
+  std::exception_ptr mException;
+};
+
+} // namespace Illusion::Core
+
+#endif // ILLUSION_CORE_TASK_GROUP_HPP
@@ -8,11 +8,21 @@
 
 #include "ThreadPool.hpp"
 
+#include "Profiler.hpp"
+
 namespace Illusion::Core {
 
+namespace {
+// These are set once for each worker thread. They are used to find the deque of the current worker
+// when a task enqueues new tasks.
+thread_local ThreadPool* tCurrentPool   = nullptr;
+thread_local uint32_t    tCurrentWorker = 0;
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-ThreadPool::ThreadPool(uint32_t threadCount) {
+ThreadPool::ThreadPool(uint32_t threadCount, Scheduling scheduling)
+    : mScheduling(scheduling) {
   restart(threadCount);
 }
 
@@ -30,6 +40,12 @@ uint32_t ThreadPool::getThreadCount() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+ThreadPool::Scheduling ThreadPool::getScheduling() const {
+  return mScheduling;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ThreadPool::~ThreadPool() {
   // Wait until all worker threads have ended.
   stop();
@@ -38,10 +54,19 @@ ThreadPool::~ThreadPool() {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ThreadPool::waitIdle() {
-  // Do busy wait.
-  while (getRunningTasks() + getPendingTasks() > 0) {
-    std::this_thread::sleep_for(std::chrono::microseconds(1));
+  waitUntil([this]() { return mUnfinishedTasks == 0; });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ThreadPool::runPendingTask() {
+  Task task;
+  if (pop(task)) {
+    execute(task);
+    return true;
   }
+
+  return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,8 +78,201 @@ uint32_t ThreadPool::getRunningTasks() const {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 uint32_t ThreadPool::getPendingTasks() const {
+  return mPendingTasks;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t ThreadPool::getQueueCapacity() const {
+  size_t capacity = 0;
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    capacity += mTasks.capacity();
+  }
+
+  for (auto const& worker : mWorkers) {
+    std::unique_lock<std::mutex> lock(worker->mMutex);
+    capacity += worker->mTasks.capacity();
+  }
+
+  return capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::push(Task&& task) {
+
+  // The counter is incremented before the task becomes visible to the workers. This way it can
+  // never underflow when a worker removes the task again.
+  ++mUnfinishedTasks;
+  ++mPendingTasks;
+
+  // Tasks which are enqueued from one of our own workers go to the worker's deque. All other tasks
+  // are pushed to the shared queue.
+  if (mScheduling == Scheduling::eWorkStealing && tCurrentPool == this) {
+    auto&                        worker = *mWorkers[tCurrentWorker];
+    std::unique_lock<std::mutex> lock(worker.mMutex);
+    worker.mTasks.push_back(std::move(task));
+  } else {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mTasks.push_back(std::move(task));
+  }
+
+  // Notify a waiting thread that there is new work to be done. We only have to do this if there
+  // actually is a sleeping worker or a thread blocked in waitUntil(). Locking the mutex before
+  // notifying ensures that a thread which is just about to fall asleep does not miss the
+  // notification.
+  if (mSleepingWorkers + mWaitingThreads > 0) {
+    { std::unique_lock<std::mutex> lock(mMutex); }
+    mCondition.notify_one();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ThreadPool::pop(Task& task) {
+  bool success = false;
+
+  // In eWorkStealing mode, we first try our own deque, then the shared queue and then the deques of
+  // all other workers. Threads which are not part of this pool have no deque.
+  if (mScheduling == Scheduling::eWorkStealing) {
+    if (tCurrentPool == this) {
+      success =
+          popLocal(tCurrentWorker, task) || popShared(task) || steal(tCurrentWorker + 1, task);
+    } else {
+      success = popShared(task) || steal(0, task);
+    }
+  } else {
+    success = popShared(task);
+  }
+
+  if (success) {
+    ++mRunningTasks;
+    --mPendingTasks;
+  }
+
+  return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ThreadPool::popShared(Task& task) {
   std::unique_lock<std::mutex> lock(mMutex);
-  return mTasks.size();
+
+  if (mTasks.empty()) {
+    return false;
+  }
+
+  mTasks.pop_front(task);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ThreadPool::popLocal(uint32_t workerIndex, Task& task) {
+  auto&                        worker = *mWorkers[workerIndex];
+  std::unique_lock<std::mutex> lock(worker.mMutex);
+
+  if (worker.mTasks.empty()) {
+    return false;
+  }
+
+  // The owner processes its own tasks in LIFO order, as the most recent task is most likely to
+  // still have its data in the cache.
+  worker.mTasks.pop_back(task);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ThreadPool::steal(uint32_t firstVictim, Task& task) {
+
+  // Workers start with their right neighbor so that not all idle workers try to steal from the same
+  // victim.
+  for (size_t i(0); i < mWorkers.size(); ++i) {
+    auto&                        victim = *mWorkers[(firstVictim + i) % mWorkers.size()];
+    std::unique_lock<std::mutex> lock(victim.mMutex);
+
+    // Thieves take the oldest task of the victim.
+    if (!victim.mTasks.empty()) {
+      victim.mTasks.pop_front(task);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::execute(Task& task) {
+  {
+    ILLUSION_PROFILE_ZONE("ThreadPool::Task");
+    task();
+  }
+  task.reset();
+  --mRunningTasks;
+
+  // If this was the last task, threads blocked in waitIdle() have to be woken up.
+  if (--mUnfinishedTasks == 0) {
+    notifyWaiters();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::work(uint32_t workerIndex) {
+  tCurrentPool   = this;
+  tCurrentWorker = workerIndex;
+
+  Profiler::setThreadName("ThreadPool Worker " + std::to_string(workerIndex));
+
+  while (mRunning) {
+
+    // Try to get a new task and execute it!
+    if (runPendingTask()) {
+      continue;
+    }
+
+    // There was nothing to do, so we wait until there is a new task or stop() has been called.
+    std::unique_lock<std::mutex> lock(mMutex);
+    ++mSleepingWorkers;
+    mCondition.wait(lock, [this] { return !mRunning || mPendingTasks > 0; });
+    --mSleepingWorkers;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::waitUntil(std::function<bool()> const& predicate) {
+  while (!predicate()) {
+
+    // Help executing pending tasks while the condition is not met.
+    if (runPendingTask()) {
+      continue;
+    }
+
+    // There is nothing to do, so we sleep until either the condition becomes true or there is a new
+    // task which we could execute. Both events notify the condition variable.
+    std::unique_lock<std::mutex> lock(mMutex);
+    ++mWaitingThreads;
+    mCondition.wait(lock, [this, &predicate] { return predicate() || mPendingTasks > 0; });
+    --mWaitingThreads;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::notifyWaiters() {
+  // This is only necessary if there actually is someone waiting. Locking the mutex ensures that a
+  // thread which is just about to fall asleep in waitUntil() does not miss the notification.
+  if (mWaitingThreads > 0) {
+    { std::unique_lock<std::mutex> lock(mMutex); }
+    mCondition.notify_all();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -99,38 +317,29 @@ void ThreadPool::restart(uint32_t threadCount) {
     stop();
   }
 
-  // Now we can start some new threads.
-  mRunning = true;
-
-  for (size_t i = 0; i < threadCount; ++i) {
-    mThreads.emplace_back([this] {
-      while (true) {
-
-        // Try to get a new task from the queue.
-        std::function<void()> task;
-        {
-          std::unique_lock<std::mutex> lock(mMutex);
-
-          // Wait until there is a task in the queue or stop() has been called.
-          mCondition.wait(lock, [this] { return !mRunning || !mTasks.empty(); });
+  // Tasks which are still in the deques of the old workers are moved to the shared queue. This way
+  // they will be executed by the new workers.
+  for (auto const& worker : mWorkers) {
+    while (!worker->mTasks.empty()) {
+      Task task;
+      worker->mTasks.pop_front(task);
+      mTasks.push_back(std::move(task));
+    }
+  }
 
-          // If stop has been called, we can quit this thread.
-          if (!mRunning) {
-            return;
-          }
+  mWorkers.clear();
 
-          // If there is a new task, pop it from the queue.
-          task = std::move(mTasks.front());
-          mTasks.pop();
+  if (mScheduling == Scheduling::eWorkStealing) {
+    for (size_t i = 0; i < threadCount; ++i) {
+      mWorkers.emplace_back(std::make_unique<Worker>());
+    }
+  }
 
-          ++mRunningTasks;
-        }
+  // Now we can start some new threads.
+  mRunning = true;
 
-        // And execute it!
-        task();
-        --mRunningTasks;
-      }
-    });
+  for (uint32_t i = 0; i < threadCount; ++i) {
+    mThreads.emplace_back([this, i] { work(i); });
   }
 }
 
@@ -9,23 +9,45 @@
 #ifndef ILLUSION_CORE_THREAD_POOL_HPP
 #define ILLUSION_CORE_THREAD_POOL_HPP
 
+#include "PoolAllocator.hpp"
+#include "RingBuffer.hpp"
+#include "Task.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <future>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace Illusion::Core {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // The ThreadPool can be used to execute tasks in parallel. New work can be pushed into a queue   //
 // and it will be processed by a set of threads asynchronously.                                   //
+// There are two scheduling modes: With eSharedQueue, all tasks are stored in one queue which is  //
+// shared by all worker threads. This is simple and keeps the tasks in FIFO order, but the queue  //
+// becomes a bottleneck when many small tasks are pushed from several threads. With               //
+// eWorkStealing, each worker thread has its own deque. Tasks which are enqueued from within a    //
+// worker thread are pushed to this thread's deque and processed in LIFO order by this thread.    //
+// Workers which run out of work steal the oldest tasks from the other workers. Tasks which are   //
+// enqueued from other threads are pushed to a shared queue first.                                //
+// Submitting tasks does not allocate memory in the steady state: The callables are stored inline //
+// in Core::Task objects, the queues do not release their memory and the shared states of the     //
+// returned std::futures are recycled by a BlockPool.                                             //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class ThreadPool {
  public:
+  enum class Scheduling { eSharedQueue, eWorkStealing };
+
   // Constructs a new ThreadPool with a given number of worker-threads. If the argument is zero,
   // std::thread::hardware_concurrency() will be used. If, for some reason, this equals to zero as
   // well, only one thread will be launched. You can use setThreadCount() to adjust the number
   // later and getThreadCount() to check how many threads have been launched.
-  ThreadPool(uint32_t threadCount = 0);
+  ThreadPool(uint32_t threadCount = 0, Scheduling scheduling = Scheduling::eSharedQueue);
 
   // The destructor will wait until all currently running tasks are done, however tasks which are
   // still in the queue will be discarded. Use waitIdle() before the destructor to make sure that
@@ -42,51 +64,110 @@ class ThreadPool {
   // You can use getThreadCount() to check how many threads have been launched.
   uint32_t getThreadCount() const;
 
-  // This will do a busy wait until all pending tasks have been executed.
+  // Returns the scheduling mode which has been chosen at construction time.
+  Scheduling getScheduling() const;
+
+  // This will block until all pending tasks have been executed. While waiting, the calling thread
+  // will help executing pending tasks. This must not be called from within a task as it would wait
+  // for itself; use a TaskGroup for fork-join parallelism inside of tasks.
   void waitIdle();
 
+  // Removes one pending task from the queue and executes it on the calling thread. If there is no
+  // pending task, false is returned. This can be used to do something useful while waiting for
+  // other tasks.
+  bool runPendingTask();
+
   // Returns the number of tasks which are currently processed.
   uint32_t getRunningTasks() const;
 
   // Returns the number of tasks which are queued and not yet running.
   uint32_t getPendingTasks() const;
 
+  // Returns the total capacity of the shared queue and of all per-worker queues. The queues never
+  // shrink, so once this has stopped growing, queuing tasks does not allocate any memory.
+  size_t getQueueCapacity() const;
+
   // This is the main method to queue new tasks. It will return a std::future object which can be
-  // queried for the result of the queued task.
+  // queried for the result of the queued task. If the task throws an exception, it will be
+  // rethrown by std::future::get().
   template <typename F>
   std::future<typename std::result_of<F()>::type> enqueue(F&& f) {
+    typedef typename std::result_of<F()>::type Result;
 
-    // Wrap the given function in a std::packaged_task so that we can return a std::future for the
-    // result of the function.
-    auto task = std::make_shared<std::packaged_task<typename std::result_of<F()>::type()>>(
-        std::forward<F>(f));
+    // The shared state of the std::promise is allocated from a BlockPool, so it will be recycled
+    // once the std::future has been destroyed.
+    std::promise<Result> promise(std::allocator_arg, PoolAllocator<char>());
 
     // We will return the result of the task as a std::future.
-    auto futureResult = task->get_future();
-
-    // Add a lambda to our task list which executes the new task.
-    {
-      std::unique_lock<std::mutex> lock(mMutex);
-      mTasks.emplace([task]() { (*task)(); });
-    }
-
-    // Notify any waiting thread that there is new work to be done.
-    mCondition.notify_one();
+    auto futureResult = promise.get_future();
+
+    // Add a lambda to our task list which executes the new task and stores its result.
+    push([promise = std::move(promise), f = std::forward<F>(f)]() mutable {
+      try {
+        if constexpr (std::is_void_v<Result>) {
+          f();
+          promise.set_value();
+        } else {
+          promise.set_value(f());
+        }
+      } catch (...) {
+        promise.set_exception(std::current_exception());
+      }
+    });
 
     // Return our future result.
     return futureResult;
   }
 
+  // Use this to queue tasks if you are not interested in their result. This is cheaper than
+  // enqueue() as no std::future has to be created. If the callable is small enough to fit into a
+  // Core::Task, no memory will be allocated. The task must not throw any exception.
+  template <typename F>
+  void submit(F&& f) {
+    push(Task(std::forward<F>(f)));
+  }
+
  private:
+  // In eWorkStealing mode, each worker thread owns one of these. The owning thread pushes and pops
+  // at the back, other threads steal from the front. The struct is aligned to a cache line so that
+  // the mutexes of neighboring workers do not suffer from false sharing.
+  struct alignas(64) Worker {
+    RingBuffer<Task> mTasks;
+    std::mutex       mMutex;
+  };
+
+  // The TaskGroup uses push(), waitUntil() and notifyWaiters() directly.
+  friend class TaskGroup;
+
+  void push(Task&& task);
+  bool pop(Task& task);
+  bool popShared(Task& task);
+  bool popLocal(uint32_t workerIndex, Task& task);
+  bool steal(uint32_t firstVictim, Task& task);
+  void execute(Task& task);
+  void work(uint32_t workerIndex);
+
+  // Blocks until the given predicate returns true. The calling thread will execute pending tasks in
+  // the meantime. It will only sleep when there is nothing to do; in this case it will be woken up
+  // by notifyWaiters() or when a new task is pushed.
+  void waitUntil(std::function<bool()> const& predicate);
+  void notifyWaiters();
+
   void stop();
   void restart(uint32_t threadCount);
 
-  std::vector<std::thread>          mThreads;
-  std::queue<std::function<void()>> mTasks;
-  mutable std::mutex                mMutex;
-  std::condition_variable           mCondition;
-  std::atomic_uint                  mRunningTasks = 0;
-  bool                              mRunning      = false;
+  Scheduling                           mScheduling;
+  std::vector<std::thread>             mThreads;
+  std::vector<std::unique_ptr<Worker>> mWorkers;
+  RingBuffer<Task>                     mTasks;
+  mutable std::mutex                   mMutex;
+  std::condition_variable              mCondition;
+  std::atomic_uint                     mRunningTasks    = 0;
+  std::atomic_uint                     mPendingTasks    = 0;
+  std::atomic_uint                     mUnfinishedTasks = 0;
+  std::atomic_uint                     mSleepingWorkers = 0;
+  std::atomic_uint                     mWaitingThreads  = 0;
+  std::atomic_bool                     mRunning         = false;
 };
 
 } // namespace Illusion::Core
@@ -20,6 +20,7 @@ namespace Illusion::Graphics {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct BackedBuffer {
+  // This is empty unless Device::isDebugNamingEnabled() returned true when the buffer was created.
   std::string mName;
 
   vk::DeviceMemoryPtr mMemory;
@@ -21,6 +21,7 @@ namespace Illusion::Graphics {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct BackedImage {
+  // This is empty unless Device::isDebugNamingEnabled() returned true when the image was created.
   std::string mName;
 
   vk::DeviceMemoryPtr mMemory;
@@ -9,14 +9,20 @@
 #include "CommandBuffer.hpp"
 
 #include "../Core/Logger.hpp"
+#include "../Core/Profiler.hpp"
 #include "BackedBuffer.hpp"
 #include "Device.hpp"
+#include "PipelineDescription.hpp"
+#include "PipelineManifest.hpp"
+#include "PipelineObjectCache.hpp"
 #include "PipelineReflection.hpp"
 #include "RenderPass.hpp"
 #include "Shader.hpp"
 #include "ShaderModule.hpp"
 #include "Texture.hpp"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <utility>
 
@@ -24,15 +30,15 @@ namespace Illusion::Graphics {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-CommandBuffer::CommandBuffer(std::string const& name, DeviceConstPtr const& device, QueueType type,
+CommandBuffer::CommandBuffer(DebugName const& name, DeviceConstPtr const& device, QueueType type,
     vk::CommandBufferLevel level)
-    : Core::NamedObject(name)
+    : Core::NamedObject(name.toString())
     , mDevice(device)
-    , mVkCmd(device->allocateCommandBuffer(name, type, level))
+    , mVkCmd(device->allocateCommandBuffer(getName(), type, level))
     , mType(type)
     , mLevel(level)
     , mGraphicsState(device)
-    , mDescriptorSetCache(name, device) {
+    , mDescriptorSetCache(getName(), device) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -47,6 +53,32 @@ uint64_t CommandBuffer::getMaxPipelineAge() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void CommandBuffer::setPipelineThreadPool(std::shared_ptr<Core::ThreadPool> pool) {
+  mPipelineThreadPool = std::move(pool);
+}
+
+std::shared_ptr<Core::ThreadPool> CommandBuffer::getPipelineThreadPool() const {
+  return mPipelineThreadPool;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CommandBuffer::setFallbackPipeline(vk::PipelinePtr const& pipeline) {
+  mFallbackPipeline = pipeline;
+}
+
+vk::PipelinePtr const& CommandBuffer::getFallbackPipeline() const {
+  return mFallbackPipeline;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t CommandBuffer::getPendingPipelineCount() const {
+  return mPendingPipelineCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void CommandBuffer::reset() {
 
   // First clear all state of the CommandBuffer. Except for the GraphicsState, this is kept.
@@ -55,7 +87,8 @@ void CommandBuffer::reset() {
   mCurrentDescriptorSets.clear();
   mDescriptorSetCache.releaseAll();
   mCurrentRenderPass.reset();
-  mCurrentSubpass = 0;
+  mCurrentSubpass       = 0;
+  mPendingPipelineCount = 0;
 
   // Increment our recording counter. This is used to track the life time of pipeline cache entries.
   ++mRecordingID;
@@ -77,6 +110,9 @@ void CommandBuffer::reset() {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void CommandBuffer::begin(vk::CommandBufferUsageFlagBits usage) {
+  mRecordedViewports.clear();
+  mRecordedScissors.clear();
+
   mVkCmd->begin({usage});
 }
 
@@ -89,6 +125,8 @@ void CommandBuffer::begin(RenderPassPtr const& currentRenderPass, uint32_t curre
 
   mCurrentRenderPass = currentRenderPass;
   mCurrentSubpass    = currentSubpass;
+  mRecordedViewports.clear();
+  mRecordedScissors.clear();
 
   vk::CommandBufferInheritanceInfo info;
   info.subpass     = mCurrentSubpass;
@@ -137,6 +175,7 @@ void CommandBuffer::submit(std::vector<vk::SemaphorePtr> const& waitSemaphores,
   info.pWaitSemaphores      = tmpWaitSemaphores.data();
 
   // Submit to the queue which was defined at contruction time.
+  ILLUSION_PROFILE_ZONE("CommandBuffer::submit");
   mDevice->getQueue(mType).submit(info, fence ? *fence : nullptr);
 }
 
@@ -182,6 +221,10 @@ void CommandBuffer::endRenderPass() {
 
 void CommandBuffer::execute(CommandBufferPtr const& secondary) {
   mVkCmd->executeCommands(*secondary->mVkCmd);
+
+  // The dynamic state is undefined after executing secondary CommandBuffers.
+  mRecordedViewports.clear();
+  mRecordedScissors.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -194,6 +237,10 @@ void CommandBuffer::execute(std::vector<CommandBufferPtr> const& secondaries) {
   }
 
   mVkCmd->executeCommands(cmds);
+
+  // The dynamic state is undefined after executing secondary CommandBuffers.
+  mRecordedViewports.clear();
+  mRecordedScissors.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -303,8 +350,11 @@ void CommandBuffer::pushConstants(const void* data, uint32_t size, uint32_t offs
 void CommandBuffer::draw(
     uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
 
-  // First, bind a Pipeline and create, update and bind DescriptorSets.
-  flush();
+  // First, bind a Pipeline and create, update and bind DescriptorSets. If the pipeline is still
+  // being compiled and there is no fallback pipeline, the call is skipped.
+  if (!flush()) {
+    return;
+  }
 
   // The record the actual draw call.
   mVkCmd->draw(vertexCount, instanceCount, firstVertex, firstInstance);
@@ -315,8 +365,11 @@ void CommandBuffer::draw(
 void CommandBuffer::drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex,
     int32_t vertexOffset, uint32_t firstInstance) {
 
-  // First, bind a Pipeline and create, update and bind DescriptorSets.
-  flush();
+  // First, bind a Pipeline and create, update and bind DescriptorSets. If the pipeline is still
+  // being compiled and there is no fallback pipeline, the call is skipped.
+  if (!flush()) {
+    return;
+  }
 
   // The record the actual draw call.
   mVkCmd->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
@@ -326,8 +379,11 @@ void CommandBuffer::drawIndexed(uint32_t indexCount, uint32_t instanceCount, uin
 
 void CommandBuffer::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
 
-  // First, bind a Pipeline and create, update and bind DescriptorSets.
-  flush();
+  // First, bind a Pipeline and create, update and bind DescriptorSets. If the pipeline is still
+  // being compiled and there is no fallback pipeline, the call is skipped.
+  if (!flush()) {
+    return;
+  }
 
   // The record the actual dispatch call.
   mVkCmd->dispatch(groupCountX, groupCountY, groupCountZ);
@@ -538,7 +594,22 @@ void CommandBuffer::copyImageToBuffer(vk::Image src, vk::Buffer dst, vk::ImageLa
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void CommandBuffer::flush() {
+void CommandBuffer::resetQueryPool(
+    vk::QueryPoolPtr const& pool, uint32_t firstQuery, uint32_t queryCount) const {
+  mVkCmd->resetQueryPool(*pool, firstQuery, queryCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CommandBuffer::writeTimestamp(
+    vk::PipelineStageFlagBits stage, vk::QueryPoolPtr const& pool, uint32_t query) const {
+  mVkCmd->writeTimestamp(stage, *pool, query);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CommandBuffer::flush() {
+  ILLUSION_PROFILE_ZONE("CommandBuffer::flush");
 
   if (!mCurrentShader) {
     throw std::runtime_error(
@@ -550,8 +621,19 @@ void CommandBuffer::flush() {
 
   // create (or retrieve from cache) and bind a pipeline -------------------------------------------
   auto pipeline = getPipelineHandle();
+  if (!pipeline) {
+    return false;
+  }
   mVkCmd->bindPipeline(bindPoint, *pipeline);
 
+  // set dynamic viewports and scissors ------------------------------------------------------------
+
+  // These are not part of the vk::Pipeline, so the pipeline can be reused when they change (for
+  // example when the window is resized).
+  if (bindPoint == vk::PipelineBindPoint::eGraphics) {
+    flushViewports(pipeline == mFallbackPipeline);
+  }
+
   // now bind and update all DescriptorSets -------------------------------------------------------
 
   // the logic is roughly as follows:
@@ -725,63 +807,90 @@ void CommandBuffer::flush() {
   // Reset dirty state.
   mBindingState.clearDirtySets();
   mBindingState.clearDirtyDynamicOffsets();
+
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-vk::PipelinePtr CommandBuffer::getPipelineHandle() {
+void CommandBuffer::flushViewports(bool isFallback) {
+  auto const& dynamicState = mGraphicsState.getDynamicState();
+  auto const& viewports    = mGraphicsState.getViewports();
+  auto const& scissors     = mGraphicsState.getScissors();
 
-  if (!mCurrentShader) {
-    throw std::runtime_error("Failed to create pipeline for CommandBuffer \"" + getName() +
-                             "\": There must be an active Shader!");
-  }
-
-  if (mType == QueueType::eCompute) {
-
-    Core::BitHash hash;
-    hash.push<64>(mCurrentShader.get());
+  bool dynamicViewports = dynamicState.count(vk::DynamicState::eViewport) != 0u;
+  bool dynamicScissors  = dynamicState.count(vk::DynamicState::eScissor) != 0u;
 
-    auto const& specialisationHash = mSpecialisationState.getHash();
-    hash.insert(hash.end(), specialisationHash.begin(), specialisationHash.end());
+  if ((dynamicViewports || dynamicScissors) &&
+      (viewports.size() > MAX_DYNAMIC_VIEWPORTS || scissors.size() > MAX_DYNAMIC_VIEWPORTS)) {
+    throw std::runtime_error("Failed to flush CommandBuffer \"" + getName() +
+                             "\": There must be at most " +
+                             std::to_string(MAX_DYNAMIC_VIEWPORTS) + " viewports and scissors!");
+  }
 
-    auto cached = mPipelineCache.find(hash);
-    if (cached != mPipelineCache.end()) {
-      cached->second.second = mRecordingID;
-      return cached->second.first;
+  if (dynamicViewports && viewports != mRecordedViewports) {
+    std::array<vk::Viewport, MAX_DYNAMIC_VIEWPORTS> vkViewports;
+    for (size_t i(0); i < viewports.size(); ++i) {
+      auto const& v  = viewports[i];
+      vkViewports[i] = vk::Viewport(
+          v.mOffset[0], v.mOffset[1], v.mExtend[0], v.mExtend[1], v.mMinDepth, v.mMaxDepth);
     }
+    mVkCmd->setViewport(0, static_cast<uint32_t>(viewports.size()), vkViewports.data());
+    mRecordedViewports = viewports;
+  }
 
-    vk::ComputePipelineCreateInfo info;
+  if (dynamicScissors) {
+    // As for static scissors, the viewports are used as scissors if none are defined.
+    std::array<GraphicsState::Scissor, MAX_DYNAMIC_VIEWPORTS> effective;
+    size_t                                                    count = scissors.size();
+    if (scissors.empty()) {
+      count = viewports.size();
+      for (size_t i(0); i < count; ++i) {
+        effective[i].mOffset = glm::ivec2(viewports[i].mOffset);
+        effective[i].mExtend = glm::uvec2(viewports[i].mExtend);
+      }
+    } else {
+      std::copy(scissors.begin(), scissors.end(), effective.begin());
+    }
 
-    if (mCurrentShader->getModules().size() != 1) {
-      throw std::runtime_error("Failed to create compute pipeline for CommandBuffer \"" +
-                               getName() + "\": There must be exactly one ShaderModule!");
+    if (!std::equal(effective.begin(), effective.begin() + count, mRecordedScissors.begin(),
+            mRecordedScissors.end())) {
+      std::array<vk::Rect2D, MAX_DYNAMIC_VIEWPORTS> vkScissors;
+      for (size_t i(0); i < count; ++i) {
+        auto const& r = effective[i];
+        vkScissors[i] = vk::Rect2D({r.mOffset[0], r.mOffset[1]}, {r.mExtend[0], r.mExtend[1]});
+      }
+      mVkCmd->setScissor(0, static_cast<uint32_t>(count), vkScissors.data());
+      mRecordedScissors.assign(effective.begin(), effective.begin() + count);
     }
+  }
 
-    info.stage.stage               = mCurrentShader->getModules()[0]->getStage();
-    info.stage.module              = *mCurrentShader->getModules()[0]->getHandle();
-    info.stage.pName               = "main";
-    info.stage.pSpecializationInfo = mSpecialisationState.getInfo();
-    info.layout                    = *mCurrentShader->getReflection()->getLayout();
+  // Binding a vk::Pipeline with static viewports or scissors overrides the recorded values. The
+  // state of the fallback pipeline is not known, so it is treated like this as well.
+  if (!dynamicViewports || isFallback) {
+    mRecordedViewports.clear();
+  }
+  if (!dynamicScissors || isFallback) {
+    mRecordedScissors.clear();
+  }
+}
 
-    auto pipeline = mDevice->createComputePipeline("ComputePipeline of " + getName(), info);
+////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    mPipelineCache[hash] = {pipeline, mRecordingID};
+vk::PipelinePtr CommandBuffer::getPipelineHandle() {
 
-    return pipeline;
+  if (!mCurrentShader) {
+    throw std::runtime_error("Failed to create pipeline for CommandBuffer \"" + getName() +
+                             "\": There must be an active Shader!");
   }
 
-  // -----------------------------------------------------------------------------------------------
-
-  Core::BitHash hash = mGraphicsState.getHash();
-
-  for (auto const& m : mCurrentShader->getModules()) {
-    hash.push<64>(m->getHandle().get());
+  Core::BitHash renderPassHash;
+  if (mType != QueueType::eCompute) {
+    renderPassHash = mCurrentRenderPass->getCompatibilityHash();
   }
-  hash.push<64>(mCurrentRenderPass.get());
-  hash.push<32>(mCurrentSubpass);
 
-  auto const& specialisationHash = mSpecialisationState.getHash();
-  hash.insert(hash.end(), specialisationHash.begin(), specialisationHash.end());
+  Core::BitHash hash = PipelineDescription::getHash(mType, mCurrentShader->getModules(),
+      mGraphicsState, renderPassHash, mCurrentSubpass, mSpecialisationState);
 
   auto cached = mPipelineCache.find(hash);
   if (cached != mPipelineCache.end()) {
@@ -789,185 +898,73 @@ vk::PipelinePtr CommandBuffer::getPipelineHandle() {
     return cached->second.first;
   }
 
-  // -----------------------------------------------------------------------------------------------
-  std::vector<vk::PipelineShaderStageCreateInfo> stageInfos;
-  if (mCurrentShader) {
-    for (auto const& i : mCurrentShader->getModules()) {
-      vk::PipelineShaderStageCreateInfo stageInfo;
-      stageInfo.stage               = i->getStage();
-      stageInfo.module              = *i->getHandle();
-      stageInfo.pName               = "main";
-      stageInfo.pSpecializationInfo = mSpecialisationState.getInfo();
-      stageInfos.push_back(stageInfo);
-    }
+  // Maybe another CommandBuffer has already created this pipeline.
+  auto const& sharedCache = mDevice->getPipelineObjectCache();
+  if (auto shared = sharedCache->get(hash)) {
+    mPipelineCache[hash] = {shared, mRecordingID};
+    return shared;
   }
 
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineVertexInputStateCreateInfo vertexInputStateInfo;
+  // If it is still being compiled in the background, there is no need to create a description.
+  if (mPipelineThreadPool && sharedCache->isPending(hash)) {
+    ++mPendingPipelineCount;
+    return mFallbackPipeline;
+  }
 
-  std::vector<vk::VertexInputBindingDescription>   vertexInputBindingDescriptions;
-  std::vector<vk::VertexInputAttributeDescription> vertexInputAttributeDescriptions;
-  for (auto const& i : mGraphicsState.getVertexInputBindings()) {
-    vertexInputBindingDescriptions.emplace_back(i.binding, i.stride, i.inputRate);
+  // If compiling it in the background has failed before, an error has already been printed. Trying
+  // again would fail as well.
+  if (mPipelineThreadPool && sharedCache->isFailed(hash)) {
+    return mFallbackPipeline;
   }
-  for (auto const& i : mGraphicsState.getVertexInputAttributes()) {
-    vertexInputAttributeDescriptions.emplace_back(i.location, i.binding, i.format, i.offset);
+
+  // Else we have to create the pipeline. Everything which is needed for this is copied, so that
+  // this can happen on another thread while this CommandBuffer is modified.
+  if (mType == QueueType::eCompute && mCurrentShader->getModules().size() != 1) {
+    throw std::runtime_error("Failed to create compute pipeline for CommandBuffer \"" +
+                             getName() + "\": There must be exactly one ShaderModule!");
   }
-  vertexInputStateInfo.vertexBindingDescriptionCount =
-      static_cast<uint32_t>(vertexInputBindingDescriptions.size());
-  vertexInputStateInfo.pVertexBindingDescriptions = vertexInputBindingDescriptions.data();
-  vertexInputStateInfo.vertexAttributeDescriptionCount =
-      static_cast<uint32_t>(vertexInputAttributeDescriptions.size());
-  vertexInputStateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
 
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateInfo;
-  inputAssemblyStateInfo.topology = mGraphicsState.getTopology();
-  inputAssemblyStateInfo.primitiveRestartEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getPrimitiveRestartEnable());
+  PipelineDescription description{mDevice, getName(), mCurrentShader->getName(), mType,
+      mGraphicsState, mSpecialisationState};
 
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineTessellationStateCreateInfo tessellationStateInfo;
-  tessellationStateInfo.patchControlPoints = mGraphicsState.getTessellationPatchControlPoints();
+  for (auto const& m : mCurrentShader->getModules()) {
+    description.mModules.emplace_back(m->getStage(), m->getHandle());
+  }
+  description.mLayout = mCurrentShader->getReflection()->getLayout();
+
+  if (mType != QueueType::eCompute) {
+    for (auto const& a : mCurrentRenderPass->getAttachments()) {
+      vk::AttachmentDescription attachment;
+      attachment.format  = a.mImage->mImageInfo.format;
+      attachment.samples = a.mImage->mImageInfo.samples;
+      description.mAttachments.emplace_back(attachment);
+    }
 
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineViewportStateCreateInfo viewportStateInfo;
-  std::vector<vk::Viewport>           viewports;
-  std::vector<vk::Rect2D>             scissors;
-  for (auto const& i : mGraphicsState.getViewports()) {
-    viewports.emplace_back(
-        i.mOffset[0], i.mOffset[1], i.mExtend[0], i.mExtend[1], i.mMinDepth, i.mMaxDepth);
+    description.mRenderPass = mCurrentRenderPass->getHandle();
+    description.mSubpasses  = mCurrentRenderPass->getSubpasses();
+    description.mSubpass    = mCurrentSubpass;
   }
 
-  // use viewport as scissors if no scissors are defined
-  if (!mGraphicsState.getScissors().empty()) {
-    for (auto const& i : mGraphicsState.getScissors()) {
-      scissors.push_back({{i.mOffset[0], i.mOffset[1]}, {i.mExtend[0], i.mExtend[1]}});
-    }
-  } else {
-    for (auto const& i : mGraphicsState.getViewports()) {
-      scissors.push_back({{static_cast<int32_t>(i.mOffset[0]), static_cast<int32_t>(i.mOffset[1])},
-          {static_cast<uint32_t>(i.mExtend[0]), static_cast<uint32_t>(i.mExtend[1])}});
-    }
+  // This pipeline has not been used before during this session, so it may be worth remembering.
+  if (auto const& manifest = mDevice->getPipelineManifest()) {
+    manifest->record(description);
   }
-  viewportStateInfo.viewportCount = static_cast<uint32_t>(viewports.size());
-  viewportStateInfo.pViewports    = viewports.data();
-  viewportStateInfo.scissorCount  = static_cast<uint32_t>(scissors.size());
-  viewportStateInfo.pScissors     = scissors.data();
-
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineRasterizationStateCreateInfo rasterizationStateInfo;
-  rasterizationStateInfo.depthClampEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getDepthClampEnable());
-  rasterizationStateInfo.rasterizerDiscardEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getRasterizerDiscardEnable());
-  rasterizationStateInfo.polygonMode = mGraphicsState.getPolygonMode();
-  rasterizationStateInfo.cullMode    = mGraphicsState.getCullMode();
-  rasterizationStateInfo.frontFace   = mGraphicsState.getFrontFace();
-  rasterizationStateInfo.depthBiasEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getDepthBiasEnable());
-  rasterizationStateInfo.depthBiasConstantFactor = mGraphicsState.getDepthBiasConstantFactor();
-  rasterizationStateInfo.depthBiasClamp          = mGraphicsState.getDepthBiasClamp();
-  rasterizationStateInfo.depthBiasSlopeFactor    = mGraphicsState.getDepthBiasSlopeFactor();
-  rasterizationStateInfo.lineWidth               = mGraphicsState.getLineWidth();
-
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineMultisampleStateCreateInfo multisampleStateInfo;
-  multisampleStateInfo.rasterizationSamples = mGraphicsState.getRasterizationSamples();
-  multisampleStateInfo.sampleShadingEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getSampleShadingEnable());
-  multisampleStateInfo.minSampleShading = mGraphicsState.getMinSampleShading();
-  multisampleStateInfo.pSampleMask      = mGraphicsState.getSampleMask().data();
-  multisampleStateInfo.alphaToCoverageEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getAlphaToCoverageEnable());
-  multisampleStateInfo.alphaToOneEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getAlphaToOneEnable());
-
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineDepthStencilStateCreateInfo depthStencilStateInfo;
-  depthStencilStateInfo.depthTestEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getDepthTestEnable());
-  depthStencilStateInfo.depthWriteEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getDepthWriteEnable());
-  depthStencilStateInfo.depthCompareOp = mGraphicsState.getDepthCompareOp();
-  depthStencilStateInfo.depthBoundsTestEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getDepthBoundsTestEnable());
-  depthStencilStateInfo.stencilTestEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getStencilTestEnable());
-  depthStencilStateInfo.front          = {mGraphicsState.getStencilFrontFailOp(),
-      mGraphicsState.getStencilFrontPassOp(), mGraphicsState.getStencilFrontDepthFailOp(),
-      mGraphicsState.getStencilFrontCompareOp(), mGraphicsState.getStencilFrontCompareMask(),
-      mGraphicsState.getStencilFrontWriteMask(), mGraphicsState.getStencilFrontReference()};
-  depthStencilStateInfo.back           = {mGraphicsState.getStencilBackFailOp(),
-      mGraphicsState.getStencilBackPassOp(), mGraphicsState.getStencilBackDepthFailOp(),
-      mGraphicsState.getStencilBackCompareOp(), mGraphicsState.getStencilBackCompareMask(),
-      mGraphicsState.getStencilBackWriteMask(), mGraphicsState.getStencilBackReference()};
-  depthStencilStateInfo.minDepthBounds = mGraphicsState.getMinDepthBounds();
-  depthStencilStateInfo.maxDepthBounds = mGraphicsState.getMaxDepthBounds();
-
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineColorBlendStateCreateInfo              colorBlendStateInfo;
-  std::vector<vk::PipelineColorBlendAttachmentState> pipelineColorBlendAttachments;
-
-  // use default blend attachments if none are defined
-  if (mGraphicsState.getBlendAttachments().empty()) {
-    auto attachmentCount =
-        int32_t(mCurrentRenderPass->getSubpasses()[mCurrentSubpass].mColorAttachments.size());
-
-    for (int32_t i(0); i < attachmentCount; ++i) {
-      GraphicsState::BlendAttachment a;
-      pipelineColorBlendAttachments.emplace_back(static_cast<vk::Bool32>(a.mBlendEnable),
-          a.mSrcColorBlendFactor, a.mDstColorBlendFactor, a.mColorBlendOp, a.mSrcAlphaBlendFactor,
-          a.mDstAlphaBlendFactor, a.mAlphaBlendOp, a.mColorWriteMask);
-    }
 
-  } else {
-    for (auto const& i : mGraphicsState.getBlendAttachments()) {
-      pipelineColorBlendAttachments.emplace_back(static_cast<vk::Bool32>(i.mBlendEnable),
-          i.mSrcColorBlendFactor, i.mDstColorBlendFactor, i.mColorBlendOp, i.mSrcAlphaBlendFactor,
-          i.mDstAlphaBlendFactor, i.mAlphaBlendOp, i.mColorWriteMask);
+  vk::PipelinePtr pipeline;
+
+  if (mPipelineThreadPool) {
+    auto modules = description.getModuleHandles();
+    pipeline = sharedCache->createAsync(hash, *mPipelineThreadPool,
+        [description = std::move(description)]() { return description.create(); }, modules);
+
+    // The fallback is not stored in mPipelineCache, so we will check again on the next flush().
+    if (!pipeline) {
+      ++mPendingPipelineCount;
+      return mFallbackPipeline;
     }
+  } else {
+    pipeline = sharedCache->add(hash, description.create());
   }
-  colorBlendStateInfo.logicOpEnable =
-      static_cast<vk::Bool32>(mGraphicsState.getBlendLogicOpEnable());
-  colorBlendStateInfo.logicOp         = mGraphicsState.getBlendLogicOp();
-  colorBlendStateInfo.attachmentCount = static_cast<uint32_t>(pipelineColorBlendAttachments.size());
-  colorBlendStateInfo.pAttachments    = pipelineColorBlendAttachments.data();
-  colorBlendStateInfo.blendConstants[0] = mGraphicsState.getBlendConstants()[0];
-  colorBlendStateInfo.blendConstants[1] = mGraphicsState.getBlendConstants()[1];
-  colorBlendStateInfo.blendConstants[2] = mGraphicsState.getBlendConstants()[2];
-  colorBlendStateInfo.blendConstants[3] = mGraphicsState.getBlendConstants()[3];
-
-  // -----------------------------------------------------------------------------------------------
-  vk::PipelineDynamicStateCreateInfo dynamicStateInfo;
-  std::vector<vk::DynamicState>      dynamicState(
-      mGraphicsState.getDynamicState().begin(), mGraphicsState.getDynamicState().end());
-  dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicState.size());
-  dynamicStateInfo.pDynamicStates    = dynamicState.data();
-
-  // -----------------------------------------------------------------------------------------------
-  vk::GraphicsPipelineCreateInfo info;
-  info.stageCount          = static_cast<uint32_t>(stageInfos.size());
-  info.pStages             = stageInfos.data();
-  info.pVertexInputState   = &vertexInputStateInfo;
-  info.pInputAssemblyState = &inputAssemblyStateInfo;
-  info.pTessellationState  = &tessellationStateInfo;
-  info.pViewportState      = &viewportStateInfo;
-  info.pRasterizationState = &rasterizationStateInfo;
-  info.pMultisampleState   = &multisampleStateInfo;
-  info.pDepthStencilState  = &depthStencilStateInfo;
-  info.pColorBlendState    = &colorBlendStateInfo;
-  if (!mGraphicsState.getDynamicState().empty()) {
-    info.pDynamicState = &dynamicStateInfo;
-  }
-  info.renderPass = *mCurrentRenderPass->getHandle();
-  info.subpass    = mCurrentSubpass;
-
-  if (mCurrentShader) {
-    info.layout = *mCurrentShader->getReflection()->getLayout();
-  }
-
-  auto pipeline = mDevice->createGraphicsPipeline("GraphicsPipeline of " + getName(), info);
 
   mPipelineCache[hash] = {pipeline, mRecordingID};
 
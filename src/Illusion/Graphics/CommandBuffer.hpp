@@ -9,13 +9,16 @@
 #ifndef ILLUSION_GRAPHICS_COMMAND_BUFFER_HPP
 #define ILLUSION_GRAPHICS_COMMAND_BUFFER_HPP
 
+#include "../Core/ThreadPool.hpp"
 #include "BindingState.hpp"
+#include "DebugName.hpp"
 #include "DescriptorSetCache.hpp"
 #include "GraphicsState.hpp"
 #include "SpecialisationState.hpp"
 #include "fwd.hpp"
 
 #include <glm/glm.hpp>
+#include <unordered_map>
 
 namespace Illusion::Graphics {
 
@@ -29,8 +32,8 @@ namespace Illusion::Graphics {
 class CommandBuffer : public Core::StaticCreate<CommandBuffer>, public Core::NamedObject {
  public:
   // Allocates a new vk::CommandBuffer from the device. It is a good idea to give the object a
-  // descriptive name.
-  CommandBuffer(std::string const& name, DeviceConstPtr const& device,
+  // descriptive name. The name is passed as a DebugName so that it is concatenated only once.
+  CommandBuffer(DebugName const& name, DeviceConstPtr const& device,
       QueueType              type  = QueueType::eGeneric,
       vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
 
@@ -38,13 +41,34 @@ class CommandBuffer : public Core::StaticCreate<CommandBuffer>, public Core::Nam
 
   // Whenever reset() is called, old entries from the internal pipeline cache are deleted. When
   // reset() is called "value" many times without a vk::Pipeline being used in the previous
-  // recording, it will be deleted. The default value is 2. So in a common setup, when a
-  // CommandBuffer is re-recorded per frame, a vk::Pipeline will be deleted when it wasn't used for
-  // two frames. When this value is set to zero, all pipelines will be re-created for every
-  // recording.
+  // recording, it will be released. The default value is 2. So in a common setup, when a
+  // CommandBuffer is re-recorded per frame, a vk::Pipeline will be released when it wasn't used for
+  // two frames. The vk::Pipelines are shared with all other CommandBuffers of the same Device via
+  // the Device's PipelineObjectCache; a vk::Pipeline is only deleted once all CommandBuffers have
+  // released it.
   void     setMaxPipelineAge(uint64_t value);
   uint64_t getMaxPipelineAge() const;
 
+  // By default, a vk::Pipeline which is not available yet is created synchronously during the draw
+  // or dispatch call which needs it. This may cause severe hitches. If a ThreadPool is set, the
+  // vk::Pipeline is compiled on this ThreadPool instead. Until it is ready, the fallback pipeline
+  // is bound or - if there is none - the draw or dispatch call is skipped. Set to nullptr to go
+  // back to synchronous pipeline creation.
+  void                              setPipelineThreadPool(std::shared_ptr<Core::ThreadPool> pool);
+  std::shared_ptr<Core::ThreadPool> getPipelineThreadPool() const;
+
+  // The fallback pipeline is used for draw and dispatch calls whose vk::Pipeline is still being
+  // compiled on the pipeline ThreadPool. It is also used if compiling has failed; in this case,
+  // compiling is not tried again until the Shader has been reloaded. The fallback has to be
+  // compatible to the current shader's pipeline layout and the current render pass. It may be a
+  // nullptr (the default), in this case these calls are skipped.
+  void                   setFallbackPipeline(vk::PipelinePtr const& pipeline);
+  vk::PipelinePtr const& getFallbackPipeline() const;
+
+  // Returns the number of draw and dispatch calls since the last reset() which used the fallback
+  // pipeline or which have been skipped because their vk::Pipeline was still being compiled.
+  uint32_t getPendingPipelineCount() const;
+
   // Resets the vk::CommandBuffer, deletes old entries from the internal pipeline cache and clears
   // the current binding state. The current graphics state and the current shader program are not
   // changed.
@@ -143,7 +167,8 @@ class CommandBuffer : public Core::StaticCreate<CommandBuffer>, public Core::Nam
   // the currently bound shader program and the current graphics state or retrieve a matching cached
   // vk::Pipeline. This pipeline will be bound. Then, based on the binding state, descriptor sets
   // will be allocated, updated and bound. These will throw a std::runtime_error when there is no
-  // active shader.
+  // active shader. If a pipeline ThreadPool is set and the vk::Pipeline is still being compiled,
+  // the fallback pipeline is bound instead or the call is skipped entirely.
   void draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0,
       uint32_t firstInstance = 0);
   void drawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0,
@@ -238,10 +263,28 @@ class CommandBuffer : public Core::StaticCreate<CommandBuffer>, public Core::Nam
   void copyImageToBuffer(vk::Image src, vk::Buffer dst, vk::ImageLayout srcLayout,
       std::vector<vk::BufferImageCopy> const& infos) const;
 
+  // queries ---------------------------------------------------------------------------------------
+
+  // These must be called outside of render passes.
+  void resetQueryPool(vk::QueryPoolPtr const& pool, uint32_t firstQuery, uint32_t queryCount) const;
+
+  // Writes a timestamp to the given query when all previous commands have completed the given
+  // pipeline stage.
+  void writeTimestamp(
+      vk::PipelineStageFlagBits stage, vk::QueryPoolPtr const& pool, uint32_t query) const;
+
  private:
-  void            flush();
+  bool            flush();
   vk::PipelinePtr getPipelineHandle();
 
+  // Records the viewports and scissors of the GraphicsState if they are part of its dynamic state
+  // and if they differ from the values which have been recorded before. This is called by flush()
+  // after a graphics pipeline has been bound.
+  void flushViewports(bool isFallback);
+
+  // The number of viewports which is supported by most devices.
+  static constexpr size_t MAX_DYNAMIC_VIEWPORTS = 16;
+
   DeviceConstPtr         mDevice;
   vk::CommandBufferPtr   mVkCmd;
   QueueType              mType;
@@ -255,9 +298,18 @@ class CommandBuffer : public Core::StaticCreate<CommandBuffer>, public Core::Nam
   RenderPassPtr mCurrentRenderPass;
   uint32_t      mCurrentSubpass = 0;
 
-  uint64_t                                                      mRecordingID    = 0;
-  uint64_t                                                      mMaxPipelineAge = 2;
-  std::map<Core::BitHash, std::pair<vk::PipelinePtr, uint64_t>> mPipelineCache;
+  uint64_t mRecordingID    = 0;
+  uint64_t mMaxPipelineAge = 2;
+  std::unordered_map<Core::BitHash, std::pair<vk::PipelinePtr, uint64_t>> mPipelineCache;
+
+  std::shared_ptr<Core::ThreadPool> mPipelineThreadPool;
+  vk::PipelinePtr                   mFallbackPipeline;
+  uint32_t                          mPendingPipelineCount = 0;
+
+  // The dynamic viewports and scissors which are currently recorded to mVkCmd. They are cleared
+  // whenever the recorded values become invalid.
+  std::vector<GraphicsState::Viewport> mRecordedViewports;
+  std::vector<GraphicsState::Scissor>  mRecordedScissors;
 
   struct DescriptorSetState {
     vk::DescriptorSetPtr mSet;
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_GRAPHICS_DEBUG_NAME_HPP
+#define ILLUSION_GRAPHICS_DEBUG_NAME_HPP
+
+#include "../Core/Logger.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace Illusion::Graphics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The Device gives a name to each Vulkan object it creates. These names are only needed if the   //
+// Instance has been created in debug mode (then they are passed to vkSetDebugUtilsObjectNameEXT) //
+// or if trace output is enabled. A DebugName is a cheap reference to such a name: It can be      //
+// constructed from a string or a string literal without copying it, and it can be prepended with //
+// a prefix without concatenating anything. Only toString() builds the actual name.               //
+//                                                                                                //
+// device->createMemory(DebugName("Memory for ", name), info);                                    //
+//                                                                                                //
+// As a DebugName only references the strings it is constructed from, it should be used as a      //
+// function parameter only. Do not store it anywhere, use toString() instead.                     //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class DebugName {
+ public:
+  DebugName(char const* name)
+      : mName(name) {
+  }
+
+  DebugName(std::string const& name)
+      : mName(name) {
+  }
+
+  // The resulting name is prefix + name.toString().
+  DebugName(char const* prefix, DebugName const& name)
+      : mName(prefix)
+      , mParent(&name) {
+  }
+
+  // Concatenates all parts of the name. This allocates memory if the name is longer than the small
+  // string optimization of std::string allows.
+  std::string toString() const {
+    std::string result;
+    for (DebugName const* n = this; n != nullptr; n = n->mParent) {
+      result += n->mName;
+    }
+    return result;
+  }
+
+  // Returns toString() if trace output is enabled, an empty string otherwise. This is meant for
+  // names which are captured by deleter lambdas for their ILLUSION_TRACE_DELETION output; when
+  // trace output is disabled, no memory is allocated.
+  std::string toTraceString() const {
+    if (ILLUSION_MIN_LOG_LEVEL > 0 || !Core::Logger::enableTrace) {
+      return std::string();
+    }
+    return toString();
+  }
+
+ private:
+  std::string_view mName;
+  DebugName const* mParent = nullptr;
+};
+
+} // namespace Illusion::Graphics
+
+#endif // ILLUSION_GRAPHICS_DEBUG_NAME_HPP
@@ -9,6 +9,7 @@
 #include "DescriptorPool.hpp"
 
 #include "../Core/Logger.hpp"
+#include "DebugName.hpp"
 #include "DescriptorSetReflection.hpp"
 #include "Device.hpp"
 #include "Utils.hpp"
@@ -111,16 +112,16 @@ vk::DescriptorSetPtr DescriptorPool::allocateDescriptorSet() {
   info.descriptorSetCount = 1;
   info.pSetLayouts        = &descriptorSetLayout;
 
-  Core::Logger::traceCreation("vk::DescriptorSet", "DescriptorSet from " + getName());
+  // Descriptor sets are allocated very often, so the name is only built if trace output is enabled.
+  auto traceName = DebugName("DescriptorSet from ", getName()).toTraceString();
+  ILLUSION_TRACE_CREATION("vk::DescriptorSet", traceName);
 
   auto device = mDevice->getHandle();
-  auto name   = getName();
   return VulkanPtr::create(
-      device->allocateDescriptorSets(info)[0], [device, pool, name](vk::DescriptorSet* obj) {
-        Core::Logger::traceDeletion("vk::DescriptorSet", "DescriptorSet from " + name);
+      device->allocateDescriptorSets(info)[0], [device, pool, traceName](vk::DescriptorSet* obj) {
+        ILLUSION_TRACE_DELETION("vk::DescriptorSet", traceName);
         --pool->mAllocationCount;
         device->freeDescriptorSets(*pool->mPool, *obj);
-        delete obj;
       });
 }
 
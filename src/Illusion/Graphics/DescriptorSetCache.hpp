@@ -11,7 +11,8 @@
 
 #include "DescriptorSetReflection.hpp"
 
-#include <map>
+#include <set>
+#include <unordered_map>
 
 namespace Illusion::Graphics {
 
@@ -57,7 +58,7 @@ class DescriptorSetCache : public Core::NamedObject {
   DeviceConstPtr mDevice;
 
   // lazy state ------------------------------------------------------------------------------------
-  mutable std::map<Core::BitHash, CacheEntry> mCache;
+  mutable std::unordered_map<Core::BitHash, CacheEntry> mCache;
 };
 
 } // namespace Illusion::Graphics
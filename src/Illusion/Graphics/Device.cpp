@@ -8,17 +8,21 @@
 
 #include "Device.hpp"
 
+#include "../Core/File.hpp"
 #include "../Core/Logger.hpp"
+#include "../Core/Profiler.hpp"
 #include "../Core/Utils.hpp"
 #include "BackedBuffer.hpp"
 #include "BackedImage.hpp"
 #include "CommandBuffer.hpp"
 #include "PhysicalDevice.hpp"
+#include "PipelineObjectCache.hpp"
 #include "PipelineResource.hpp"
 #include "Texture.hpp"
 #include "Utils.hpp"
 #include "VulkanPtr.hpp"
 
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <utility>
@@ -29,14 +33,45 @@ namespace Illusion::Graphics {
 
 namespace {
 const std::vector<const char*> DEVICE_EXTENSIONS{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+// Checks the header of the given pipeline cache data. The pipelineCacheUUID changes with each
+// driver version, so the data is only used if it has been written by the same driver for the same
+// device. Drivers are required to ignore incompatible data, but not all of them do so reliably.
+bool isPipelineCacheCompatible(
+    Core::MappedFile const& data, vk::PhysicalDeviceProperties const& properties) {
+
+  // This is the layout of VkPipelineCacheHeaderVersionOne.
+  struct Header {
+    uint32_t mHeaderSize;
+    uint32_t mHeaderVersion;
+    uint32_t mVendorID;
+    uint32_t mDeviceID;
+    uint8_t  mPipelineCacheUUID[VK_UUID_SIZE];
+  };
+
+  if (data.getSize() < sizeof(Header)) {
+    return false;
+  }
+
+  Header header{};
+  std::memcpy(&header, data.getData(), sizeof(Header));
+
+  return header.mHeaderSize >= sizeof(Header) &&
+         header.mHeaderVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.mVendorID == properties.vendorID && header.mDeviceID == properties.deviceID &&
+         std::memcmp(header.mPipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
 }
+} // namespace
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Device::Device(std::string const& name, PhysicalDeviceConstPtr physicalDevice)
+Device::Device(
+    std::string const& name, PhysicalDeviceConstPtr physicalDevice, std::string pipelineCacheFile)
     : Core::NamedObject(name)
     , mPhysicalDevice(std::move(physicalDevice))
-    , mDevice(createDevice(name)) {
+    , mDevice(createDevice(name))
+    , mPipelineCacheFile(std::move(pipelineCacheFile))
+    , mPipelineObjectCache(std::make_shared<PipelineObjectCache>()) {
 
   mSetObjectNameFunc =
       PFN_vkSetDebugUtilsObjectNameEXT(mDevice->getProcAddr("vkSetDebugUtilsObjectNameEXT"));
@@ -53,21 +88,30 @@ Device::Device(std::string const& name, PhysicalDeviceConstPtr physicalDevice)
                               std::to_string(info.queueFamilyIndex) + " of " + getName(),
             info);
   }
+
+  mPipelineCache = createPipelineCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Device::~Device() = default;
+Device::~Device() {
+  if (!mPipelineCacheFile.empty()) {
+    savePipelineCache();
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-BackedImagePtr Device::createBackedImage(std::string const& name, vk::ImageCreateInfo imageInfo,
+BackedImagePtr Device::createBackedImage(DebugName const& name, vk::ImageCreateInfo imageInfo,
     vk::ImageViewType viewType, vk::ImageAspectFlags const& imageAspectMask,
     vk::MemoryPropertyFlags const& properties, vk::ImageLayout layout,
     vk::ComponentMapping const& componentMapping, vk::DeviceSize dataSize, const void* data) const {
 
-  auto result   = std::make_shared<BackedImage>();
-  result->mName = name;
+  auto result = std::make_shared<BackedImage>();
+
+  if (isDebugNamingEnabled()) {
+    result->mName = name.toString();
+  }
 
   // make sure eTransferDst is set when we have data to upload
   if (data != nullptr) {
@@ -84,7 +128,7 @@ BackedImagePtr Device::createBackedImage(std::string const& name, vk::ImageCreat
   result->mMemoryInfo.allocationSize = requirements.size;
   result->mMemoryInfo.memoryTypeIndex =
       mPhysicalDevice->findMemoryType(requirements.memoryTypeBits, properties);
-  result->mMemory = createMemory("Memory for " + name, result->mMemoryInfo);
+  result->mMemory = createMemory(DebugName("Memory for ", name), result->mMemoryInfo);
   mDevice->bindImageMemory(*result->mImage, *result->mMemory, 0);
 
   // create image view
@@ -98,16 +142,16 @@ BackedImagePtr Device::createBackedImage(std::string const& name, vk::ImageCreat
   result->mViewInfo.subresourceRange.layerCount     = imageInfo.arrayLayers;
   result->mViewInfo.components                      = componentMapping;
 
-  result->mView = createImageView("ImageView for " + name, result->mViewInfo);
+  result->mView = createImageView(DebugName("ImageView for ", name), result->mViewInfo);
 
   if (data != nullptr) {
     auto cmd = allocateCommandBuffer("Upload to BackedImage");
     cmd->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
 
-    auto stagingBuffer =
-        createBackedBuffer("StagingBuffer for " + name, vk::BufferUsageFlagBits::eTransferSrc,
-            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-            dataSize, data);
+    auto stagingBuffer = createBackedBuffer(DebugName("StagingBuffer for ", name),
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        dataSize, data);
 
     vk::ImageMemoryBarrier barrier;
     barrier.srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
@@ -213,12 +257,15 @@ BackedImagePtr Device::createBackedImage(std::string const& name, vk::ImageCreat
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-BackedBufferPtr Device::createBackedBuffer(std::string const& name,
+BackedBufferPtr Device::createBackedBuffer(DebugName const& name,
     vk::BufferUsageFlags const& usage, vk::MemoryPropertyFlags const& properties,
     vk::DeviceSize dataSize, const void* data) const {
 
-  auto result   = std::make_shared<BackedBuffer>();
-  result->mName = name;
+  auto result = std::make_shared<BackedBuffer>();
+
+  if (isDebugNamingEnabled()) {
+    result->mName = name.toString();
+  }
 
   result->mBufferInfo.size        = dataSize;
   result->mBufferInfo.usage       = usage;
@@ -238,7 +285,7 @@ BackedBufferPtr Device::createBackedBuffer(std::string const& name,
   result->mMemoryInfo.memoryTypeIndex =
       mPhysicalDevice->findMemoryType(requirements.memoryTypeBits, properties);
 
-  result->mMemory = createMemory("Memory for " + name, result->mMemoryInfo);
+  result->mMemory = createMemory(DebugName("Memory for ", name), result->mMemoryInfo);
 
   mDevice->bindBufferMemory(*result->mBuffer, *result->mMemory, 0);
 
@@ -255,10 +302,10 @@ BackedBufferPtr Device::createBackedBuffer(std::string const& name,
     } else {
 
       // more difficult case, we need a staging buffer!
-      auto stagingBuffer =
-          createBackedBuffer("StagingBuffer for " + name, vk::BufferUsageFlagBits::eTransferSrc,
-              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-              dataSize, data);
+      auto stagingBuffer = createBackedBuffer(DebugName("StagingBuffer for ", name),
+          vk::BufferUsageFlagBits::eTransferSrc,
+          vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+          dataSize, data);
 
       auto cmd = allocateCommandBuffer("Upload to BackedBuffer");
       cmd->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
@@ -283,7 +330,7 @@ BackedBufferPtr Device::createBackedBuffer(std::string const& name,
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 BackedBufferPtr Device::createVertexBuffer(
-    std::string const& name, vk::DeviceSize dataSize, const void* data) const {
+    DebugName const& name, vk::DeviceSize dataSize, const void* data) const {
   return createBackedBuffer(name, vk::BufferUsageFlagBits::eVertexBuffer,
       vk::MemoryPropertyFlagBits::eDeviceLocal, dataSize, data);
 }
@@ -291,14 +338,14 @@ BackedBufferPtr Device::createVertexBuffer(
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 BackedBufferPtr Device::createIndexBuffer(
-    std::string const& name, vk::DeviceSize dataSize, const void* data) const {
+    DebugName const& name, vk::DeviceSize dataSize, const void* data) const {
   return createBackedBuffer(name, vk::BufferUsageFlagBits::eIndexBuffer,
       vk::MemoryPropertyFlagBits::eDeviceLocal, dataSize, data);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-BackedBufferPtr Device::createUniformBuffer(std::string const& name, vk::DeviceSize size) const {
+BackedBufferPtr Device::createUniformBuffer(DebugName const& name, vk::DeviceSize size) const {
   return createBackedBuffer(name,
       vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst,
       vk::MemoryPropertyFlagBits::eDeviceLocal, size);
@@ -306,7 +353,7 @@ BackedBufferPtr Device::createUniformBuffer(std::string const& name, vk::DeviceS
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-TexturePtr Device::createTexture(std::string const& name, vk::ImageCreateInfo imageInfo,
+TexturePtr Device::createTexture(DebugName const& name, vk::ImageCreateInfo imageInfo,
     vk::SamplerCreateInfo samplerInfo, vk::ImageViewType viewType,
     vk::ImageAspectFlags const& imageAspectMask, vk::ImageLayout layout,
     vk::ComponentMapping const& componentMapping, vk::DeviceSize dataSize, const void* data) const {
@@ -327,7 +374,7 @@ TexturePtr Device::createTexture(std::string const& name, vk::ImageCreateInfo im
 
   // create sampler
   result->mSamplerInfo = std::move(samplerInfo);
-  result->mSampler     = createSampler("Sampler for " + name, result->mSamplerInfo);
+  result->mSampler     = createSampler(DebugName("Sampler for ", name), result->mSamplerInfo);
 
   return result;
 }
@@ -380,310 +427,327 @@ TexturePtr Device::getSinglePixelTexture(std::array<uint8_t, 4> const& color) co
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::CommandBufferPtr Device::allocateCommandBuffer(
-    std::string const& name, QueueType type, vk::CommandBufferLevel level) const {
+    DebugName const& name, QueueType type, vk::CommandBufferLevel level) const {
   vk::CommandBufferAllocateInfo info;
   info.level              = level;
   info.commandPool        = *mCommandPools[Core::Utils::enumCast(type)];
   info.commandBufferCount = 1;
 
-  Core::Logger::traceCreation("vk::CommandBuffer", name);
+  ILLUSION_TRACE_CREATION("vk::CommandBuffer", name.toString());
 
   auto vkObject = mDevice->allocateCommandBuffers(info)[0];
   assignName(uint64_t(VkCommandBuffer(vkObject)), vk::ObjectType::eCommandBuffer, name);
 
-  auto device = mDevice;
-  auto pool   = mCommandPools[Core::Utils::enumCast(type)];
-  return VulkanPtr::create(vkObject, [device, pool, name](vk::CommandBuffer* obj) {
-    Core::Logger::traceDeletion("vk::CommandBuffer", name);
+  auto device    = mDevice;
+  auto pool      = mCommandPools[Core::Utils::enumCast(type)];
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, pool, traceName](vk::CommandBuffer* obj) {
+    ILLUSION_TRACE_DELETION("vk::CommandBuffer", traceName);
     device->freeCommandBuffers(*pool, *obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::BufferPtr Device::createBuffer(
-    std::string const& name, vk::BufferCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::Buffer", name);
+    DebugName const& name, vk::BufferCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::Buffer", name.toString());
 
   auto vkObject = mDevice->createBuffer(info);
   assignName(uint64_t(VkBuffer(vkObject)), vk::ObjectType::eBuffer, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Buffer* obj) {
-    Core::Logger::traceDeletion("vk::Buffer", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Buffer* obj) {
+    ILLUSION_TRACE_DELETION("vk::Buffer", traceName);
     device->destroyBuffer(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::CommandPoolPtr Device::createCommandPool(
-    std::string const& name, vk::CommandPoolCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::CommandPool", name);
+    DebugName const& name, vk::CommandPoolCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::CommandPool", name.toString());
 
   auto vkObject = mDevice->createCommandPool(info);
   assignName(uint64_t(VkCommandPool(vkObject)), vk::ObjectType::eCommandPool, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::CommandPool* obj) {
-    Core::Logger::traceDeletion("vk::CommandPool", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::CommandPool* obj) {
+    ILLUSION_TRACE_DELETION("vk::CommandPool", traceName);
     device->destroyCommandPool(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::DescriptorPoolPtr Device::createDescriptorPool(
-    std::string const& name, vk::DescriptorPoolCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::DescriptorPool", name);
+    DebugName const& name, vk::DescriptorPoolCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::DescriptorPool", name.toString());
 
   auto vkObject = mDevice->createDescriptorPool(info);
   assignName(uint64_t(VkDescriptorPool(vkObject)), vk::ObjectType::eDescriptorPool, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::DescriptorPool* obj) {
-    Core::Logger::traceDeletion("vk::DescriptorPool", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::DescriptorPool* obj) {
+    ILLUSION_TRACE_DELETION("vk::DescriptorPool", traceName);
     device->destroyDescriptorPool(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::DescriptorSetLayoutPtr Device::createDescriptorSetLayout(
-    std::string const& name, vk::DescriptorSetLayoutCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::DescriptorSetLayout", name);
+    DebugName const& name, vk::DescriptorSetLayoutCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::DescriptorSetLayout", name.toString());
 
   auto vkObject = mDevice->createDescriptorSetLayout(info);
   assignName(uint64_t(VkDescriptorSetLayout(vkObject)), vk::ObjectType::eDescriptorSetLayout, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::DescriptorSetLayout* obj) {
-    Core::Logger::traceDeletion("vk::DescriptorSetLayout", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::DescriptorSetLayout* obj) {
+    ILLUSION_TRACE_DELETION("vk::DescriptorSetLayout", traceName);
     device->destroyDescriptorSetLayout(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::DeviceMemoryPtr Device::createMemory(
-    std::string const& name, vk::MemoryAllocateInfo const& info) const {
-  Core::Logger::traceCreation("vk::DeviceMemory", name);
+    DebugName const& name, vk::MemoryAllocateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::DeviceMemory", name.toString());
 
   auto vkObject = mDevice->allocateMemory(info);
   assignName(uint64_t(VkDeviceMemory(vkObject)), vk::ObjectType::eDeviceMemory, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::DeviceMemory* obj) {
-    Core::Logger::traceDeletion("vk::DeviceMemory", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::DeviceMemory* obj) {
+    ILLUSION_TRACE_DELETION("vk::DeviceMemory", traceName);
     device->freeMemory(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-vk::FencePtr Device::createFence(std::string const& name, vk::FenceCreateFlags const& flags) const {
-  Core::Logger::traceCreation("vk::Fence", name);
+vk::FencePtr Device::createFence(DebugName const& name, vk::FenceCreateFlags const& flags) const {
+  ILLUSION_TRACE_CREATION("vk::Fence", name.toString());
 
   auto vkObject = mDevice->createFence({flags});
   assignName(uint64_t(VkFence(vkObject)), vk::ObjectType::eFence, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Fence* obj) {
-    Core::Logger::traceDeletion("vk::Fence", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Fence* obj) {
+    ILLUSION_TRACE_DELETION("vk::Fence", traceName);
     device->destroyFence(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::FramebufferPtr Device::createFramebuffer(
-    std::string const& name, vk::FramebufferCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::Framebuffer", name);
+    DebugName const& name, vk::FramebufferCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::Framebuffer", name.toString());
 
   auto vkObject = mDevice->createFramebuffer(info);
   assignName(uint64_t(VkFramebuffer(vkObject)), vk::ObjectType::eFramebuffer, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Framebuffer* obj) {
-    Core::Logger::traceDeletion("vk::Framebuffer", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Framebuffer* obj) {
+    ILLUSION_TRACE_DELETION("vk::Framebuffer", traceName);
     device->destroyFramebuffer(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-vk::ImagePtr Device::createImage(std::string const& name, vk::ImageCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::Image", name);
+vk::ImagePtr Device::createImage(DebugName const& name, vk::ImageCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::Image", name.toString());
 
   auto vkObject = mDevice->createImage(info);
   assignName(uint64_t(VkImage(vkObject)), vk::ObjectType::eImage, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Image* obj) {
-    Core::Logger::traceDeletion("vk::Image", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Image* obj) {
+    ILLUSION_TRACE_DELETION("vk::Image", traceName);
     device->destroyImage(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::ImageViewPtr Device::createImageView(
-    std::string const& name, vk::ImageViewCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::ImageView", name);
+    DebugName const& name, vk::ImageViewCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::ImageView", name.toString());
 
   auto vkObject = mDevice->createImageView(info);
   assignName(uint64_t(VkImageView(vkObject)), vk::ObjectType::eImageView, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::ImageView* obj) {
-    Core::Logger::traceDeletion("vk::ImageView", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::ImageView* obj) {
+    ILLUSION_TRACE_DELETION("vk::ImageView", traceName);
     device->destroyImageView(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::PipelinePtr Device::createComputePipeline(
-    std::string const& name, vk::ComputePipelineCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::Pipeline", name);
+    DebugName const& name, vk::ComputePipelineCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::Pipeline", name.toString());
 
-  auto vkObject = mDevice->createComputePipeline(nullptr, info);
+  auto vkObject = mDevice->createComputePipeline(*mPipelineCache, info);
   assignName(uint64_t(VkPipeline(vkObject)), vk::ObjectType::ePipeline, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Pipeline* obj) {
-    Core::Logger::traceDeletion("vk::Pipeline", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Pipeline* obj) {
+    ILLUSION_TRACE_DELETION("vk::Pipeline", traceName);
     device->destroyPipeline(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::PipelinePtr Device::createGraphicsPipeline(
-    std::string const& name, vk::GraphicsPipelineCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::Pipeline", name);
+    DebugName const& name, vk::GraphicsPipelineCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::Pipeline", name.toString());
 
-  auto vkObject = mDevice->createGraphicsPipeline(nullptr, info);
+  auto vkObject = mDevice->createGraphicsPipeline(*mPipelineCache, info);
   assignName(uint64_t(VkPipeline(vkObject)), vk::ObjectType::ePipeline, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Pipeline* obj) {
-    Core::Logger::traceDeletion("vk::Pipeline", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Pipeline* obj) {
+    ILLUSION_TRACE_DELETION("vk::Pipeline", traceName);
     device->destroyPipeline(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::PipelineLayoutPtr Device::createPipelineLayout(
-    std::string const& name, vk::PipelineLayoutCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::PipelineLayout", name);
+    DebugName const& name, vk::PipelineLayoutCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::PipelineLayout", name.toString());
 
   auto vkObject = mDevice->createPipelineLayout(info);
   assignName(uint64_t(VkPipelineLayout(vkObject)), vk::ObjectType::ePipelineLayout, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::PipelineLayout* obj) {
-    Core::Logger::traceDeletion("vk::PipelineLayout", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::PipelineLayout* obj) {
+    ILLUSION_TRACE_DELETION("vk::PipelineLayout", traceName);
     device->destroyPipelineLayout(*obj);
-    delete obj;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::QueryPoolPtr Device::createQueryPool(
+    DebugName const& name, vk::QueryPoolCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::QueryPool", name.toString());
+
+  auto vkObject = mDevice->createQueryPool(info);
+  assignName(uint64_t(VkQueryPool(vkObject)), vk::ObjectType::eQueryPool, name);
+
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::QueryPool* obj) {
+    ILLUSION_TRACE_DELETION("vk::QueryPool", traceName);
+    device->destroyQueryPool(*obj);
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::RenderPassPtr Device::createRenderPass(
-    std::string const& name, vk::RenderPassCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::RenderPass", name);
+    DebugName const& name, vk::RenderPassCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::RenderPass", name.toString());
 
   auto vkObject = mDevice->createRenderPass(info);
   assignName(uint64_t(VkRenderPass(vkObject)), vk::ObjectType::eRenderPass, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::RenderPass* obj) {
-    Core::Logger::traceDeletion("vk::RenderPass", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::RenderPass* obj) {
+    ILLUSION_TRACE_DELETION("vk::RenderPass", traceName);
     device->destroyRenderPass(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::SamplerPtr Device::createSampler(
-    std::string const& name, vk::SamplerCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::Sampler", name);
+    DebugName const& name, vk::SamplerCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::Sampler", name.toString());
 
   auto vkObject = mDevice->createSampler(info);
   assignName(uint64_t(VkSampler(vkObject)), vk::ObjectType::eSampler, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Sampler* obj) {
-    Core::Logger::traceDeletion("vk::Sampler", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Sampler* obj) {
+    ILLUSION_TRACE_DELETION("vk::Sampler", traceName);
     device->destroySampler(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::SemaphorePtr Device::createSemaphore(
-    std::string const& name, vk::SemaphoreCreateFlags const& flags) const {
-  Core::Logger::traceCreation("vk::Semaphore", name);
+    DebugName const& name, vk::SemaphoreCreateFlags const& flags) const {
+  ILLUSION_TRACE_CREATION("vk::Semaphore", name.toString());
 
   auto vkObject = mDevice->createSemaphore({flags});
   assignName(uint64_t(VkSemaphore(vkObject)), vk::ObjectType::eSemaphore, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::Semaphore* obj) {
-    Core::Logger::traceDeletion("vk::Semaphore", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::Semaphore* obj) {
+    ILLUSION_TRACE_DELETION("vk::Semaphore", traceName);
     device->destroySemaphore(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::ShaderModulePtr Device::createShaderModule(
-    std::string const& name, vk::ShaderModuleCreateInfo const& info) const {
-  Core::Logger::traceCreation("vk::ShaderModule", name);
+    DebugName const& name, vk::ShaderModuleCreateInfo const& info) const {
+  ILLUSION_TRACE_CREATION("vk::ShaderModule", name.toString());
 
   auto vkObject = mDevice->createShaderModule(info);
   assignName(uint64_t(VkShaderModule(vkObject)), vk::ObjectType::eShaderModule, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::ShaderModule* obj) {
-    Core::Logger::traceDeletion("vk::ShaderModule", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::ShaderModule* obj) {
+    ILLUSION_TRACE_DELETION("vk::ShaderModule", traceName);
     device->destroyShaderModule(*obj);
-    delete obj;
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 vk::SwapchainKHRPtr Device::createSwapChainKhr(
-    std::string const& name, vk::SwapchainCreateInfoKHR const& info) const {
-  Core::Logger::traceCreation("vk::SwapchainKHR", name);
+    DebugName const& name, vk::SwapchainCreateInfoKHR const& info) const {
+  ILLUSION_TRACE_CREATION("vk::SwapchainKHR", name.toString());
 
   auto vkObject = mDevice->createSwapchainKHR(info);
   assignName(uint64_t(VkSwapchainKHR(vkObject)), vk::ObjectType::eSwapchainKHR, name);
 
-  auto device = mDevice;
-  return VulkanPtr::create(vkObject, [device, name](vk::SwapchainKHR* obj) {
-    Core::Logger::traceDeletion("vk::SwapchainKHR", name);
+  auto device    = mDevice;
+  auto traceName = name.toTraceString();
+  return VulkanPtr::create(vkObject, [device, traceName](vk::SwapchainKHR* obj) {
+    ILLUSION_TRACE_DELETION("vk::SwapchainKHR", traceName);
     device->destroySwapchainKHR(*obj);
-    delete obj;
   });
 }
 
@@ -707,8 +771,57 @@ vk::Queue const& Device::getQueue(QueueType type) const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+vk::PipelineCachePtr const& Device::getPipelineCache() const {
+  return mPipelineCache;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PipelineObjectCachePtr const& Device::getPipelineObjectCache() const {
+  return mPipelineObjectCache;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Device::setPipelineManifest(PipelineManifestPtr const& manifest) {
+  mPipelineManifest = manifest;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PipelineManifestPtr const& Device::getPipelineManifest() const {
+  return mPipelineManifest;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Device::savePipelineCache() const {
+  if (mPipelineCacheFile.empty()) {
+    return false;
+  }
+
+  try {
+    auto data = mDevice->getPipelineCacheData(*mPipelineCache);
+    return Core::File(mPipelineCacheFile).saveAtomic(data);
+  } catch (std::exception const& e) {
+    Core::Logger::warning() << "Failed to save pipeline cache \"" << mPipelineCacheFile
+                            << "\": " << e.what() << std::endl;
+    return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Device::isDebugNamingEnabled() const {
+  return mSetObjectNameFunc != nullptr ||
+         (ILLUSION_MIN_LOG_LEVEL == 0 && Core::Logger::enableTrace);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void Device::waitForFences(
     std::vector<vk::FencePtr> const& fences, bool waitAll, uint64_t timeout) const {
+  ILLUSION_PROFILE_ZONE("Device::waitForFences");
   std::vector<vk::Fence> tmp(fences.size());
   for (size_t i(0); i < fences.size(); ++i) {
     tmp[i] = *fences[i];
@@ -717,6 +830,7 @@ void Device::waitForFences(
 }
 
 void Device::waitForFence(vk::FencePtr const& fence, uint64_t timeout) const {
+  ILLUSION_PROFILE_ZONE("Device::waitForFence");
   mDevice->waitForFences(*fence, 1u, timeout);
 }
 
@@ -765,23 +879,58 @@ vk::DevicePtr Device::createDevice(std::string const& name) const {
   createInfo.enabledExtensionCount   = static_cast<uint32_t>(DEVICE_EXTENSIONS.size());
   createInfo.ppEnabledExtensionNames = DEVICE_EXTENSIONS.data();
 
-  Core::Logger::traceCreation("vk::Device", name);
+  ILLUSION_TRACE_CREATION("vk::Device", name);
   return VulkanPtr::create(mPhysicalDevice->createDevice(createInfo), [name](vk::Device* obj) {
-    Core::Logger::traceDeletion("vk::Device", name);
+    ILLUSION_TRACE_DELETION("vk::Device", name);
     obj->destroy();
   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+vk::PipelineCachePtr Device::createPipelineCache() const {
+
+  // The mapping has to be kept alive until the vk::PipelineCache has been created.
+  Core::MappedFile data;
+  if (!mPipelineCacheFile.empty() && Core::File(mPipelineCacheFile).isValid()) {
+    data = Core::File(mPipelineCacheFile).map();
+  }
+
+  vk::PipelineCacheCreateInfo info;
+
+  if (isPipelineCacheCompatible(data, mPhysicalDevice->getProperties())) {
+    info.initialDataSize = data.getSize();
+    info.pInitialData    = data.getData();
+  } else if (!data.isEmpty()) {
+    Core::Logger::warning() << "Ignoring pipeline cache \"" << mPipelineCacheFile
+                            << "\": It has been created for another device or driver!"
+                            << std::endl;
+  }
+
+  auto name = "PipelineCache of " + getName();
+  ILLUSION_TRACE_CREATION("vk::PipelineCache", name);
+
+  auto vkObject = mDevice->createPipelineCache(info);
+  assignName(uint64_t(VkPipelineCache(vkObject)), vk::ObjectType::ePipelineCache, name);
+
+  auto device = mDevice;
+  return VulkanPtr::create(vkObject, [device, name](vk::PipelineCache* obj) {
+    ILLUSION_TRACE_DELETION("vk::PipelineCache", name);
+    device->destroyPipelineCache(*obj);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void Device::assignName(
-    uint64_t vulkanHandle, vk::ObjectType objectType, std::string const& name) const {
+    uint64_t vulkanHandle, vk::ObjectType objectType, DebugName const& name) const {
   vk::DebugUtilsObjectNameInfoEXT nameInfo;
 
   if (mSetObjectNameFunc != nullptr) {
+    auto nameString       = name.toString();
     nameInfo.objectType   = objectType;
     nameInfo.objectHandle = vulkanHandle;
-    nameInfo.pObjectName  = name.c_str();
+    nameInfo.pObjectName  = nameString.c_str();
     mSetObjectNameFunc(*mDevice, reinterpret_cast<VkDebugUtilsObjectNameInfoEXT*>(&nameInfo));
   }
 }
@@ -12,6 +12,7 @@
 #include "../Core/BitHash.hpp"
 #include "../Core/NamedObject.hpp"
 #include "../Core/StaticCreate.hpp"
+#include "DebugName.hpp"
 #include "fwd.hpp"
 
 #include <glm/glm.hpp>
@@ -24,14 +25,22 @@ namespace Illusion::Graphics {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // The Device is your main entry for creating Vulkan objects. Usually you will have exactly one   //
 // Device for your application.                                                                   //
+// All pipelines are created with a vk::PipelineCache owned by the Device. If a file name is      //
+// given, this cache is loaded from this file on construction and saved to it on destruction.     //
+// Then the driver does not have to compile the same pipelines again on the next start of the     //
+// application. Cache files which have been written for another device or driver are ignored.     //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
 
  public:
   // The device needs the physical device it should be created for. You can get one from your
-  // Instance. It is a good idea to give the object a descriptive name.
-  explicit Device(std::string const& name, PhysicalDeviceConstPtr physicalDevice);
+  // Instance. It is a good idea to give the object a descriptive name. If a pipelineCacheFile is
+  // given, the vk::PipelineCache is loaded from and saved to this file.
+  explicit Device(std::string const& name, PhysicalDeviceConstPtr physicalDevice,
+      std::string pipelineCacheFile = "");
+
+  // Saves the vk::PipelineCache if a pipelineCacheFile has been given.
   virtual ~Device();
 
   // high-level create methods ---------------------------------------------------------------------
@@ -40,7 +49,7 @@ class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
 
   // Creates a BackedImage and optionally uploads data to the GPU. This uses a BackedBuffer as
   // staging buffer.
-  BackedImagePtr createBackedImage(std::string const& name, vk::ImageCreateInfo info,
+  BackedImagePtr createBackedImage(DebugName const& name, vk::ImageCreateInfo info,
       vk::ImageViewType viewType, vk::ImageAspectFlags const& imageAspectMask,
       vk::MemoryPropertyFlags const& properties, vk::ImageLayout layout,
       vk::ComponentMapping const& componentMapping = vk::ComponentMapping(),
@@ -48,7 +57,7 @@ class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
 
   // Creates a BackedBuffer and optionally uploads data to the GPU. If the memory is eHostVisible
   // and eHostCoherent, the data will be uploaded by mapping. Else a staging buffer will be used.
-  BackedBufferPtr createBackedBuffer(std::string const& name, vk::BufferUsageFlags const& usage,
+  BackedBufferPtr createBackedBuffer(DebugName const& name, vk::BufferUsageFlags const& usage,
       vk::MemoryPropertyFlags const& properties, vk::DeviceSize dataSize,
       const void* data = nullptr) const;
 
@@ -56,10 +65,10 @@ class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
   // given data. You may use the convenience template-version below to directly upload objects such
   // as structs.
   BackedBufferPtr createVertexBuffer(
-      std::string const& name, vk::DeviceSize dataSize, const void* data) const;
+      DebugName const& name, vk::DeviceSize dataSize, const void* data) const;
 
   template <typename T>
-  BackedBufferPtr createVertexBuffer(std::string const& name, T const& data) const {
+  BackedBufferPtr createVertexBuffer(DebugName const& name, T const& data) const {
     return createVertexBuffer(name, sizeof(typename T::value_type) * data.size(), data.data());
   }
 
@@ -67,18 +76,18 @@ class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
   // given data. You may use the convenience template-version below to directly upload objects such
   // as structs.
   BackedBufferPtr createIndexBuffer(
-      std::string const& name, vk::DeviceSize dataSize, const void* data) const;
+      DebugName const& name, vk::DeviceSize dataSize, const void* data) const;
 
   template <typename T>
-  BackedBufferPtr createIndexBuffer(std::string const& name, T const& data) const {
+  BackedBufferPtr createIndexBuffer(DebugName const& name, T const& data) const {
     return createIndexBuffer(name, sizeof(typename T::value_type) * data.size(), data.data());
   }
 
   // Creates a device-local BackedBuffer with vk::BufferUsageFlagBits::eUniformBuffer and
   // vk::BufferUsageFlagBits::eTransferDst.
-  BackedBufferPtr createUniformBuffer(std::string const& name, vk::DeviceSize size) const;
+  BackedBufferPtr createUniformBuffer(DebugName const& name, vk::DeviceSize size) const;
 
-  TexturePtr createTexture(std::string const& name, vk::ImageCreateInfo imageInfo,
+  TexturePtr createTexture(DebugName const& name, vk::ImageCreateInfo imageInfo,
       vk::SamplerCreateInfo samplerInfo, vk::ImageViewType viewType,
       vk::ImageAspectFlags const& imageAspectMask, vk::ImageLayout layout,
       vk::ComponentMapping const& componentMapping = vk::ComponentMapping(),
@@ -101,32 +110,57 @@ class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
   // but for example a vk::CommandBufferPtr will also capture the vk::CommandPoolPtr it was
   // allocated from). This ensures that an object will not be deleted before all dependent objects
   // are deleted.
+  // The names are given as DebugNames. They are only turned into strings if isDebugNamingEnabled()
+  // returns true, so creating objects does not allocate memory for their names in release builds.
 
   // clang-format off
-  vk::CommandBufferPtr       allocateCommandBuffer(std::string const& name, QueueType = QueueType::eGeneric, vk::CommandBufferLevel = vk::CommandBufferLevel::ePrimary) const;
-  vk::BufferPtr              createBuffer(std::string const& name, vk::BufferCreateInfo const&) const;
-  vk::CommandPoolPtr         createCommandPool(std::string const& name, vk::CommandPoolCreateInfo const&) const;
-  vk::DescriptorPoolPtr      createDescriptorPool(std::string const& name, vk::DescriptorPoolCreateInfo const&) const;
-  vk::DescriptorSetLayoutPtr createDescriptorSetLayout(std::string const& name, vk::DescriptorSetLayoutCreateInfo const&) const;
-  vk::DeviceMemoryPtr        createMemory(std::string const& name, vk::MemoryAllocateInfo const&) const;
-  vk::FencePtr               createFence(std::string const& name, vk::FenceCreateFlags const& = vk::FenceCreateFlagBits::eSignaled) const;
-  vk::FramebufferPtr         createFramebuffer(std::string const& name, vk::FramebufferCreateInfo const&) const;
-  vk::ImagePtr               createImage(std::string const& name, vk::ImageCreateInfo const&) const;
-  vk::ImageViewPtr           createImageView(std::string const& name, vk::ImageViewCreateInfo const&) const;
-  vk::PipelinePtr            createComputePipeline(std::string const& name, vk::ComputePipelineCreateInfo const&) const;
-  vk::PipelinePtr            createGraphicsPipeline(std::string const& name, vk::GraphicsPipelineCreateInfo const&) const;
-  vk::PipelineLayoutPtr      createPipelineLayout(std::string const& name, vk::PipelineLayoutCreateInfo const&) const;
-  vk::RenderPassPtr          createRenderPass(std::string const& name, vk::RenderPassCreateInfo const&) const;
-  vk::SamplerPtr             createSampler(std::string const& name, vk::SamplerCreateInfo const&) const;
-  vk::SemaphorePtr           createSemaphore(std::string const& name, vk::SemaphoreCreateFlags const& = {}) const;
-  vk::ShaderModulePtr        createShaderModule(std::string const& name, vk::ShaderModuleCreateInfo const&) const;
-  vk::SwapchainKHRPtr        createSwapChainKhr(std::string const& name, vk::SwapchainCreateInfoKHR const&) const;
+  vk::CommandBufferPtr       allocateCommandBuffer(DebugName const& name, QueueType = QueueType::eGeneric, vk::CommandBufferLevel = vk::CommandBufferLevel::ePrimary) const;
+  vk::BufferPtr              createBuffer(DebugName const& name, vk::BufferCreateInfo const&) const;
+  vk::CommandPoolPtr         createCommandPool(DebugName const& name, vk::CommandPoolCreateInfo const&) const;
+  vk::DescriptorPoolPtr      createDescriptorPool(DebugName const& name, vk::DescriptorPoolCreateInfo const&) const;
+  vk::DescriptorSetLayoutPtr createDescriptorSetLayout(DebugName const& name, vk::DescriptorSetLayoutCreateInfo const&) const;
+  vk::DeviceMemoryPtr        createMemory(DebugName const& name, vk::MemoryAllocateInfo const&) const;
+  vk::FencePtr               createFence(DebugName const& name, vk::FenceCreateFlags const& = vk::FenceCreateFlagBits::eSignaled) const;
+  vk::FramebufferPtr         createFramebuffer(DebugName const& name, vk::FramebufferCreateInfo const&) const;
+  vk::ImagePtr               createImage(DebugName const& name, vk::ImageCreateInfo const&) const;
+  vk::ImageViewPtr           createImageView(DebugName const& name, vk::ImageViewCreateInfo const&) const;
+  vk::PipelinePtr            createComputePipeline(DebugName const& name, vk::ComputePipelineCreateInfo const&) const;
+  vk::PipelinePtr            createGraphicsPipeline(DebugName const& name, vk::GraphicsPipelineCreateInfo const&) const;
+  vk::PipelineLayoutPtr      createPipelineLayout(DebugName const& name, vk::PipelineLayoutCreateInfo const&) const;
+  vk::QueryPoolPtr           createQueryPool(DebugName const& name, vk::QueryPoolCreateInfo const&) const;
+  vk::RenderPassPtr          createRenderPass(DebugName const& name, vk::RenderPassCreateInfo const&) const;
+  vk::SamplerPtr             createSampler(DebugName const& name, vk::SamplerCreateInfo const&) const;
+  vk::SemaphorePtr           createSemaphore(DebugName const& name, vk::SemaphoreCreateFlags const& = {}) const;
+  vk::ShaderModulePtr        createShaderModule(DebugName const& name, vk::ShaderModuleCreateInfo const&) const;
+  vk::SwapchainKHRPtr        createSwapChainKhr(DebugName const& name, vk::SwapchainCreateInfoKHR const&) const;
   // clang-format on
 
   // vulkan getters --------------------------------------------------------------------------------
   vk::DevicePtr const&          getHandle() const;
   PhysicalDeviceConstPtr const& getPhysicalDevice() const;
   vk::Queue const&              getQueue(QueueType type) const;
+  vk::PipelineCachePtr const&   getPipelineCache() const;
+
+  // All CommandBuffers of this Device share their vk::Pipelines via this PipelineObjectCache.
+  PipelineObjectCachePtr const& getPipelineObjectCache() const;
+
+  // If a PipelineManifest is set, the CommandBuffers of this Device record a description of each
+  // vk::Pipeline they create to it. This should be set before any CommandBuffer is recorded.
+  void                       setPipelineManifest(PipelineManifestPtr const& manifest);
+  PipelineManifestPtr const& getPipelineManifest() const;
+
+  // Writes the current content of the vk::PipelineCache to the pipelineCacheFile given at
+  // construction time. The file is replaced atomically, so concurrently running applications and
+  // crashes cannot leave a corrupt cache file behind. This is called by the destructor; you may
+  // call it earlier, for example after a loading screen. Returns false if no pipelineCacheFile has
+  // been given or if saving failed.
+  bool savePipelineCache() const;
+
+  // Returns true if the Vulkan objects get debug names. This is the case if the Instance has been
+  // created in debug mode (so that vkSetDebugUtilsObjectNameEXT is available) or if trace output is
+  // enabled. If this returns false, the names passed to the create methods are not evaluated at all
+  // and the mName members of BackedImages and BackedBuffers stay empty.
+  bool isDebugNamingEnabled() const;
 
   // device interface forwarding -------------------------------------------------------------------
   void waitForFences(
@@ -137,11 +171,16 @@ class Device : public Core::StaticCreate<Device>, public Core::NamedObject {
   void waitIdle() const;
 
  private:
-  vk::DevicePtr createDevice(std::string const& name) const;
-  void assignName(uint64_t vulkanHandle, vk::ObjectType objectType, std::string const& name) const;
+  vk::DevicePtr        createDevice(std::string const& name) const;
+  vk::PipelineCachePtr createPipelineCache() const;
+  void assignName(uint64_t vulkanHandle, vk::ObjectType objectType, DebugName const& name) const;
 
   PhysicalDeviceConstPtr mPhysicalDevice;
   vk::DevicePtr          mDevice;
+  std::string            mPipelineCacheFile;
+  vk::PipelineCachePtr   mPipelineCache;
+  PipelineObjectCachePtr mPipelineObjectCache;
+  PipelineManifestPtr    mPipelineManifest;
 
   PFN_vkSetDebugUtilsObjectNameEXT mSetObjectNameFunc;
 
@@ -9,6 +9,7 @@
 #include "FrameGraph.hpp"
 
 #include "../Core/Logger.hpp"
+#include "../Core/Profiler.hpp"
 #include "../Core/Utils.hpp"
 #include "BackedImage.hpp"
 #include "CommandBuffer.hpp"
@@ -194,6 +195,13 @@ FrameGraph::FrameGraph(
       perFrame.mFrameFinishedFence      = device->createFence("FrameFinished " + prefix);
       return perFrame;
     }) {
+
+  // The primary CommandBuffers are submitted to the generic queue. If its timestampValidBits are
+  // zero, it does not support timestamps at all.
+  auto const& physicalDevice = mDevice->getPhysicalDevice();
+  mTimestampValidBits        = physicalDevice->getQueueFamilyProperties()
+                            [physicalDevice->getQueueFamily(QueueType::eGeneric)]
+                                .timestampValidBits;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -235,6 +243,23 @@ void FrameGraph::setOutput(WindowPtr const& window, Pass const& pass, Resource c
 
 void FrameGraph::process(ProcessingFlags const& flags) {
 
+  bool skipProfilerFrame = flags.contains(ProcessingFlagBits::eSkipProfilerFrame);
+
+  // If the Profiler's recording is finished with the next call to nextFrame(), the GPU timestamps
+  // of all frames which are still in flight have to be reported now. Else they would arrive after
+  // the trace has been written.
+  if (Core::Profiler::getRemainingRecordedFrames() == 1) {
+    flushTimestamps();
+  }
+
+  // The frame of the Profiler is finished before the zone below is opened, so that each frame
+  // contains one complete call of this method.
+  if (!skipProfilerFrame) {
+    Core::Profiler::nextFrame();
+  }
+
+  ILLUSION_PROFILE_ZONE("FrameGraph::process");
+
   // -------------------------------------------------------------------------------------------- //
   // ---------------------------------- graph validation phase ---------------------------------- //
   // -------------------------------------------------------------------------------------------- //
@@ -272,6 +297,11 @@ void FrameGraph::process(ProcessingFlags const& flags) {
   mDevice->waitForFence(perFrame.mFrameFinishedFence);
   mDevice->resetFence(perFrame.mFrameFinishedFence);
 
+  // Now the GPU timestamps of this frame are available as well.
+  if (!perFrame.mTimestampNames.empty()) {
+    reportTimestamps(perFrame);
+  }
+
   // If perFrame.mDirty is set, the render passes and physical resources need to be updated. This
   // could definitely be optimized with more fine-grained dirty flags, but as this should not happen
   // on a frame-to-frame basis, it seems to be ok to recreate everything from scratch here. To give
@@ -285,7 +315,7 @@ void FrameGraph::process(ProcessingFlags const& flags) {
   // * Create a RenderPass for each RenderPassInfo
   // * Create a secondary CommandBuffer for each RenderPass
   if (perFrame.mDirty) {
-    Core::Logger::debug() << "Constructing frame graph ..." << std::endl;
+    ILLUSION_DEBUG << "Constructing frame graph ..." << std::endl;
 
     // Compute logical pass execution order --------------------------------------------------------
 
@@ -302,7 +332,7 @@ void FrameGraph::process(ProcessingFlags const& flags) {
     std::list<Pass const*> passQueue;
     passQueue.push_back(mOutputPass);
 
-    Core::Logger::debug() << "  Resolving pass dependencies ..." << std::endl;
+    ILLUSION_DEBUG << "  Resolving pass dependencies ..." << std::endl;
 
     while (!passQueue.empty()) {
       // Pop the current pass from the queue.
@@ -311,9 +341,9 @@ void FrameGraph::process(ProcessingFlags const& flags) {
 
       // Skip passes without any resources.
       if (pass->mAttachments.empty()) {
-        Core::Logger::debug() << "    Skipping pass \"" + pass->mName +
-                                     "\" because it has no resources assigned."
-                              << std::endl;
+        ILLUSION_DEBUG << "    Skipping pass \"" + pass->mName +
+                              "\" because it has no resources assigned."
+                       << std::endl;
         continue;
       }
 
@@ -330,8 +360,8 @@ void FrameGraph::process(ProcessingFlags const& flags) {
         break;
       }
 
-      Core::Logger::debug() << "    Resolving dependencies of pass \"" + pass->mName + "\"..."
-                            << std::endl;
+      ILLUSION_DEBUG << "    Resolving dependencies of pass \"" + pass->mName + "\"..."
+                     << std::endl;
 
       // We start searching for preceding passes providing required resources at our current pass.
       auto currentPass = mPasses.rbegin();
@@ -342,7 +372,7 @@ void FrameGraph::process(ProcessingFlags const& flags) {
       // Now we have to find the passes which are in front of the current pass in the mPasses list
       // of the FrameGraph and write to to the resources of the current pass.
       for (auto const& attachment : pass->mAttachments) {
-        Core::Logger::debug() << "      resource \"" + attachment->mName + "\"" << std::endl;
+        ILLUSION_DEBUG << "      resource \"" + attachment->mName + "\"" << std::endl;
 
         // Step backwards through all Passes, collecting all passes writing to this attachment.
         auto previousPass = currentPass;
@@ -376,8 +406,8 @@ void FrameGraph::process(ProcessingFlags const& flags) {
                                        "\"!");
             }
             if (!previousUse->second.contains(AccessFlagBits::eWrite)) {
-              Core::Logger::debug()
-                  << "        is read-only in pass \"" + previousPass->mName + "\"." << std::endl;
+              ILLUSION_DEBUG << "        is read-only in pass \"" + previousPass->mName + "\"."
+                             << std::endl;
             } else {
               // In order to make sure that there are no duplicates in our queue, we first remove
               // all entries referencing the same pass.
@@ -385,12 +415,12 @@ void FrameGraph::process(ProcessingFlags const& flags) {
               passQueue.push_back(&(*previousPass));
               renderPass.mSubpasses[0].mDependencies.insert(&(*previousPass));
 
-              Core::Logger::debug()
-                  << "        is written by pass \"" + previousPass->mName + "\"." << std::endl;
+              ILLUSION_DEBUG << "        is written by pass \"" + previousPass->mName + "\"."
+                             << std::endl;
             }
           } else if (renderPass.mSubpasses[0].mDependencies.empty()) {
             if (access.containsOnly(AccessFlagBits::eWrite)) {
-              Core::Logger::debug() << "        is created by this pass." << std::endl;
+              ILLUSION_DEBUG << "        is created by this pass." << std::endl;
             } else {
               throw std::runtime_error("Frame graph construction failed: Input \"" +
                                        attachment->mName + "\" of pass \"" + pass->mName +
@@ -404,17 +434,17 @@ void FrameGraph::process(ProcessingFlags const& flags) {
       perFrame.mRenderPasses.push_back(renderPass);
     }
 
-    Core::Logger::debug() << "  Pass dependencies successfully resolved." << std::endl;
+    ILLUSION_DEBUG << "  Pass dependencies successfully resolved." << std::endl;
 
     // Now we have to reverse our list of passes as we collected it bottom-up.
     perFrame.mRenderPasses.reverse();
 
     // Print some debugging information.
-    Core::Logger::debug() << "  Logical pass execution order will be:" << std::endl;
+    ILLUSION_DEBUG << "  Logical pass execution order will be:" << std::endl;
     uint32_t counter = 0;
     for (auto const& p : perFrame.mRenderPasses) {
-      Core::Logger::debug() << "    Pass " << counter++ << " (\"" << p.mSubpasses[0].mPass->mName
-                            << "\")" << std::endl;
+      ILLUSION_DEBUG << "    Pass " << counter++ << " (\"" << p.mSubpasses[0].mPass->mName << "\")"
+                     << std::endl;
     }
 
     // Merge adjacent RenderPassInfos which can be executed as subpasses ---------------------------
@@ -487,9 +517,9 @@ void FrameGraph::process(ProcessingFlags const& flags) {
     }
 
     // Print some debugging information.
-    Core::Logger::debug() << "  Physical execution order will be:" << std::endl;
+    ILLUSION_DEBUG << "  Physical execution order will be:" << std::endl;
     for (auto const& pass : perFrame.mRenderPasses) {
-      Core::Logger::debug() << "    " << pass.mName << std::endl;
+      ILLUSION_DEBUG << "    " << pass.mName << std::endl;
     }
 
     // Identify resource usage per RenderPassInfo --------------------------------------------------
@@ -628,8 +658,7 @@ void FrameGraph::process(ProcessingFlags const& flags) {
       }
 
       // Then we can add the collected attachments to our RenderPass as attachments.
-      Core::Logger::debug() << "  Adding attachments to " << passIt->mRenderPass->getName()
-                            << std::endl;
+      ILLUSION_DEBUG << "  Adding attachments to " << passIt->mRenderPass->getName() << std::endl;
 
       for (auto attachment : passIt->mAttachments) {
 
@@ -716,15 +745,15 @@ void FrameGraph::process(ProcessingFlags const& flags) {
           attachmentInfo.mStoreOp = vk::AttachmentStoreOp::eStore;
         }
 
-        Core::Logger::debug() << "    \"" << attachment->mName << "\"" << std::endl;
-        Core::Logger::debug() << "      InitialLayout: "
-                              << vk::to_string(attachmentInfo.mInitialLayout) << std::endl;
-        Core::Logger::debug() << "      FinalLayout:   "
-                              << vk::to_string(attachmentInfo.mFinalLayout) << std::endl;
-        Core::Logger::debug() << "      LoadOp:        " << vk::to_string(attachmentInfo.mLoadOp)
-                              << std::endl;
-        Core::Logger::debug() << "      StoreOp:       " << vk::to_string(attachmentInfo.mStoreOp)
-                              << std::endl;
+        ILLUSION_DEBUG << "    \"" << attachment->mName << "\"" << std::endl;
+        ILLUSION_DEBUG << "      InitialLayout: " << vk::to_string(attachmentInfo.mInitialLayout)
+                       << std::endl;
+        ILLUSION_DEBUG << "      FinalLayout:   " << vk::to_string(attachmentInfo.mFinalLayout)
+                       << std::endl;
+        ILLUSION_DEBUG << "      LoadOp:        " << vk::to_string(attachmentInfo.mLoadOp)
+                       << std::endl;
+        ILLUSION_DEBUG << "      StoreOp:       " << vk::to_string(attachmentInfo.mStoreOp)
+                       << std::endl;
 
         passIt->mRenderPass->addAttachment(attachmentInfo);
       }
@@ -750,7 +779,7 @@ void FrameGraph::process(ProcessingFlags const& flags) {
 
     // We are done! A new frame graph has been constructed.
     perFrame.mDirty = false;
-    Core::Logger::debug() << "Frame graph construction done." << std::endl;
+    ILLUSION_DEBUG << "Frame graph construction done." << std::endl;
   }
 
   // -------------------------------------------------------------------------------------------- //
@@ -763,6 +792,32 @@ void FrameGraph::process(ProcessingFlags const& flags) {
   perFrame.mPrimaryCommandBuffer->reset();
   perFrame.mPrimaryCommandBuffer->begin();
 
+  // While the Profiler records a trace, we write a timestamp before and after each RenderPass. If
+  // another FrameGraph finishes the Profiler's frames, the recording may end before this frame's
+  // timestamps are available, so none are written in the last frame.
+  bool writeTimestamps =
+      Core::Profiler::isRecording() && mTimestampValidBits > 0 &&
+      (!skipProfilerFrame || Core::Profiler::getRemainingRecordedFrames() > 1) &&
+      mDevice->getPhysicalDevice()->getProperties().limits.timestampComputeAndGraphics;
+
+  if (writeTimestamps) {
+    uint32_t queryCount = 1 + 2 * static_cast<uint32_t>(perFrame.mRenderPasses.size());
+
+    if (perFrame.mTimestampQueryCount < queryCount) {
+      vk::QueryPoolCreateInfo info;
+      info.queryType  = vk::QueryType::eTimestamp;
+      info.queryCount = queryCount;
+
+      perFrame.mTimestampQueryPool  =
+          mDevice->createQueryPool(DebugName("Timestamps of ", getName()), info);
+      perFrame.mTimestampQueryCount = queryCount;
+    }
+
+    perFrame.mPrimaryCommandBuffer->resetQueryPool(perFrame.mTimestampQueryPool, 0, queryCount);
+    perFrame.mPrimaryCommandBuffer->writeTimestamp(
+        vk::PipelineStageFlagBits::eTopOfPipe, perFrame.mTimestampQueryPool, 0);
+  }
+
   // A thread count of zero will make use of all available cores.
   if (flags.contains(ProcessingFlagBits::eParallelSubpassRecording)) {
     mThreadPool.setThreadCount(0);
@@ -807,7 +862,11 @@ void FrameGraph::process(ProcessingFlags const& flags) {
 
       subpass.mSecondaryCommandBuffer->reset();
       subpass.mSecondaryCommandBuffer->begin(pass.mRenderPass, subpassCounter);
-      subpass.mSecondaryCommandBuffer->graphicsState().setViewports({{glm::vec2(pass.mExtent)}});
+      // The viewport is dynamic, so that all pipelines can be reused when the extent changes.
+      auto& graphicsState = subpass.mSecondaryCommandBuffer->graphicsState();
+      graphicsState.addDynamicState(vk::DynamicState::eViewport);
+      graphicsState.addDynamicState(vk::DynamicState::eScissor);
+      graphicsState.setViewports({{glm::vec2(pass.mExtent)}});
       subpass.mPass->mProcessCallback(subpass.mSecondaryCommandBuffer, inputAttachments);
       subpass.mSecondaryCommandBuffer->end();
       // });
@@ -817,6 +876,13 @@ void FrameGraph::process(ProcessingFlags const& flags) {
     // Wait until all passes are recorded.
     // mThreadPool.waitIdle();
 
+    if (writeTimestamps) {
+      uint32_t query = 1 + 2 * static_cast<uint32_t>(perFrame.mTimestampNames.size());
+      perFrame.mTimestampNames.push_back(pass.mName);
+      perFrame.mPrimaryCommandBuffer->writeTimestamp(
+          vk::PipelineStageFlagBits::eTopOfPipe, perFrame.mTimestampQueryPool, query);
+    }
+
     // Begin the RenderPass.
     perFrame.mPrimaryCommandBuffer->beginRenderPass(
         pass.mRenderPass, clearValues, vk::SubpassContents::eSecondaryCommandBuffers);
@@ -834,6 +900,11 @@ void FrameGraph::process(ProcessingFlags const& flags) {
     // End this RenderPass.
     perFrame.mPrimaryCommandBuffer->endRenderPass();
 
+    if (writeTimestamps) {
+      perFrame.mPrimaryCommandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe,
+          perFrame.mTimestampQueryPool, 2 * static_cast<uint32_t>(perFrame.mTimestampNames.size()));
+    }
+
     // As our attachments have been transitioned automatically to a final layout, we have to update
     // the mCurrentLayout member of the attachment images accordingly.
     for (auto& attachment : pass.mRenderPass->getAttachments()) {
@@ -843,6 +914,7 @@ void FrameGraph::process(ProcessingFlags const& flags) {
 
   // End and submit our primary CommandBuffer.
   perFrame.mPrimaryCommandBuffer->end();
+  perFrame.mSubmitTime = Core::Profiler::getTime();
   perFrame.mPrimaryCommandBuffer->submit({}, {}, {perFrame.mRenderFinishedSemaphore});
 
   // And finally present the output attachment on the output window as soon as the
@@ -889,9 +961,55 @@ void FrameGraph::clearDirty() {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void FrameGraph::reportTimestamps(PerFrame& perFrame) const {
+  uint32_t              queryCount = 1 + 2 * static_cast<uint32_t>(perFrame.mTimestampNames.size());
+  std::vector<uint64_t> timestamps(queryCount);
+
+  auto result = mDevice->getHandle()->getQueryPoolResults(*perFrame.mTimestampQueryPool, 0,
+      queryCount, queryCount * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+      vk::QueryResultFlagBits::e64);
+
+  if (result == vk::Result::eSuccess) {
+    // The timestampPeriod is the number of nanoseconds per timestamp tick.
+    double period = mDevice->getPhysicalDevice()->getProperties().limits.timestampPeriod;
+
+    // Only the lower timestampValidBits are meaningful. Masking the difference also handles a
+    // wrap-around of the counter between the first and a later timestamp.
+    uint64_t mask = mTimestampValidBits >= 64 ? ~0ull : (1ull << mTimestampValidBits) - 1;
+
+    auto toCpuTime = [&](uint64_t timestamp) {
+      return perFrame.mSubmitTime +
+             static_cast<int64_t>(((timestamp - timestamps[0]) & mask) * period);
+    };
+
+    // The GPU clock is not correlated with the CPU clock, the spans are only aligned to the time of
+    // submission. This is stated in the track name so that nobody reads too much into the offset
+    // between the CPU and the GPU tracks.
+    for (size_t i(0); i < perFrame.mTimestampNames.size(); ++i) {
+      Core::Profiler::addSpan("GPU (aligned to submission)", perFrame.mTimestampNames[i],
+          toCpuTime(timestamps[2 * i + 1]), toCpuTime(timestamps[2 * i + 2]));
+    }
+  }
+
+  perFrame.mTimestampNames.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameGraph::flushTimestamps() {
+  for (auto& perFrame : mPerFrame) {
+    if (!perFrame.mTimestampNames.empty()) {
+      mDevice->waitForFence(perFrame.mFrameFinishedFence);
+      reportTimestamps(perFrame);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void FrameGraph::validate() const {
 
-  Core::Logger::debug() << "Validating frame graph ..." << std::endl;
+  ILLUSION_DEBUG << "Validating frame graph ..." << std::endl;
 
   // Check whether each resource of each pass was actually created by this frame graph.
   for (auto const& pass : mPasses) {
@@ -976,7 +1094,7 @@ void FrameGraph::validate() const {
     }
   }
 
-  Core::Logger::debug() << "  all good." << std::endl;
+  ILLUSION_DEBUG << "  all good." << std::endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -33,7 +33,13 @@ namespace Illusion::Graphics {
 
 class FrameGraph : public Core::StaticCreate<FrameGraph>, public Core::NamedObject {
  public:
-  enum class ProcessingFlagBits { eNone = 0, eParallelSubpassRecording = 1 << 0 };
+  // eSkipProfilerFrame: process() does not call Core::Profiler::nextFrame(). Use this for all but
+  // one FrameGraph if several FrameGraphs are processed each frame.
+  enum class ProcessingFlagBits {
+    eNone                     = 0,
+    eParallelSubpassRecording = 1 << 0,
+    eSkipProfilerFrame        = 1 << 1
+  };
   typedef Core::Flags<ProcessingFlagBits> ProcessingFlags;
 
   enum class AccessFlagBits { eNone = 0, eRead = 1 << 0, eWrite = 1 << 1, eLoad = 1 << 2 };
@@ -127,7 +133,9 @@ class FrameGraph : public Core::StaticCreate<FrameGraph>, public Core::NamedObje
   // with the methods above, alse a std::runtime_error will be thrown.
   void setOutput(WindowPtr const& window, Pass const& pass, Resource const& attachment);
 
-  // This triggers construction and execution of the frame graph. Call this once per frame.
+  // This triggers construction and execution of the frame graph. Call this once per frame. Unless
+  // eSkipProfilerFrame is given, this also finishes the current frame of the Core::Profiler, so
+  // applications which use a FrameGraph must not call Core::Profiler::nextFrame() themselves.
   void process(ProcessingFlags const& flags = ProcessingFlagBits::eNone);
 
  private:
@@ -164,6 +172,15 @@ class FrameGraph : public Core::StaticCreate<FrameGraph>, public Core::NamedObje
     std::unordered_map<Resource const*, BackedImagePtr> mAllAttachments;
     std::list<RenderPassInfo>                           mRenderPasses;
     bool                                                mDirty = true;
+
+    // GPU timestamps are only written while the Profiler records a trace. The first query is
+    // written at the beginning of the primary CommandBuffer, followed by two queries for each
+    // RenderPass. mTimestampNames contains the names of these RenderPasses; it is empty if no
+    // timestamps have been written.
+    vk::QueryPoolPtr         mTimestampQueryPool;
+    uint32_t                 mTimestampQueryCount = 0;
+    std::vector<std::string> mTimestampNames;
+    int64_t                  mSubmitTime = 0;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -172,9 +189,19 @@ class FrameGraph : public Core::StaticCreate<FrameGraph>, public Core::NamedObje
   void clearDirty();
   void validate() const;
 
+  // Reads the GPU timestamps of the given per-frame resources and adds them as spans to the trace
+  // which is currently recorded by the Profiler. The GPU clock is aligned to the time when the
+  // primary CommandBuffer was submitted, so the time between submission and execution is not
+  // visible in the trace.
+  void reportTimestamps(PerFrame& perFrame) const;
+
+  // Waits for all frames in flight which have written GPU timestamps and reports them.
+  void flushTimestamps();
+
   DeviceConstPtr          mDevice;
   Core::ThreadPool        mThreadPool;
   FrameResource<PerFrame> mPerFrame;
+  uint32_t                mTimestampValidBits = 0;
 
   std::list<Resource> mResources;
   std::list<Pass>     mPasses;
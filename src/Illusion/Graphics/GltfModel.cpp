@@ -9,6 +9,7 @@
 #include "GltfModel.hpp"
 
 #include "../Core/Logger.hpp"
+#include "../Core/Profiler.hpp"
 #include "CommandBuffer.hpp"
 #include "Device.hpp"
 #include "Texture.hpp"
@@ -108,6 +109,7 @@ Model::Model(std::string const& name, DeviceConstPtr device, std::string const&
     : Core::NamedObject(name)
     , mDevice(std::move(device))
     , mRootNode(std::make_shared<Node>()) {
+  ILLUSION_PROFILE_ZONE("Gltf::Model::Model");
 
   // load the file ---------------------------------------------------------------------------------
   tinygltf::Model model;
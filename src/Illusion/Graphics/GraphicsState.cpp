@@ -983,4 +983,211 @@ Core::BitHash const& GraphicsState::getHash() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void GraphicsState::serialize(Core::BinaryWriter& writer) const {
+
+  // The dynamic state is written first, as it determines which values follow.
+  writer.write<uint32_t>(static_cast<uint32_t>(mDynamicState.size()));
+  for (auto dynamicState : mDynamicState) {
+    writer.write(dynamicState);
+  }
+
+  auto isDynamic = [this](vk::DynamicState state) { return mDynamicState.count(state) != 0u; };
+  auto writeBool = [&writer](bool value) { writer.write<uint8_t>(value ? 1 : 0); };
+
+  writeBool(mBlendLogicOpEnable);
+  writer.write(mBlendLogicOp);
+  writer.write<uint32_t>(static_cast<uint32_t>(mBlendAttachments.size()));
+  for (auto const& attachment : mBlendAttachments) {
+    writeBool(attachment.mBlendEnable);
+    writer.write(attachment.mSrcColorBlendFactor);
+    writer.write(attachment.mDstColorBlendFactor);
+    writer.write(attachment.mColorBlendOp);
+    writer.write(attachment.mSrcAlphaBlendFactor);
+    writer.write(attachment.mDstAlphaBlendFactor);
+    writer.write(attachment.mAlphaBlendOp);
+    writer.write(static_cast<uint32_t>(attachment.mColorWriteMask));
+  }
+  if (!isDynamic(vk::DynamicState::eBlendConstants)) {
+    writer.write(mBlendConstants);
+  }
+
+  writeBool(mDepthTestEnable);
+  writeBool(mDepthWriteEnable);
+  writer.write(mDepthCompareOp);
+  writeBool(mDepthBoundsTestEnable);
+  writeBool(mStencilTestEnable);
+  writer.write(mStencilFrontFailOp);
+  writer.write(mStencilFrontPassOp);
+  writer.write(mStencilFrontDepthFailOp);
+  writer.write(mStencilFrontCompareOp);
+  writer.write(mStencilBackFailOp);
+  writer.write(mStencilBackPassOp);
+  writer.write(mStencilBackDepthFailOp);
+  writer.write(mStencilBackCompareOp);
+  if (!isDynamic(vk::DynamicState::eStencilCompareMask)) {
+    writer.write(mStencilFrontCompareMask);
+    writer.write(mStencilBackCompareMask);
+  }
+  if (!isDynamic(vk::DynamicState::eStencilWriteMask)) {
+    writer.write(mStencilFrontWriteMask);
+    writer.write(mStencilBackWriteMask);
+  }
+  if (!isDynamic(vk::DynamicState::eStencilReference)) {
+    writer.write(mStencilFrontReference);
+    writer.write(mStencilBackReference);
+  }
+  if (!isDynamic(vk::DynamicState::eDepthBounds)) {
+    writer.write(mMinDepthBounds);
+    writer.write(mMaxDepthBounds);
+  }
+
+  writer.write(mTopology);
+  writeBool(mPrimitiveRestartEnable);
+
+  writer.write(mRasterizationSamples);
+  writeBool(mSampleShadingEnable);
+  writer.write(mMinSampleShading);
+  writer.write(mSampleMask);
+  writeBool(mAlphaToCoverageEnable);
+  writeBool(mAlphaToOneEnable);
+
+  writeBool(mDepthClampEnable);
+  writeBool(mRasterizerDiscardEnable);
+  writer.write(mPolygonMode);
+  writer.write(static_cast<uint32_t>(mCullMode));
+  writer.write(mFrontFace);
+  writeBool(mDepthBiasEnable);
+  if (!isDynamic(vk::DynamicState::eDepthBias)) {
+    writer.write(mDepthBiasConstantFactor);
+    writer.write(mDepthBiasClamp);
+    writer.write(mDepthBiasSlopeFactor);
+  }
+  if (!isDynamic(vk::DynamicState::eLineWidth)) {
+    writer.write(mLineWidth);
+  }
+
+  writer.write(mTessellationPatchControlPoints);
+
+  writer.write(mVertexInputBindings);
+  writer.write(mVertexInputAttributes);
+
+  // For dynamic viewports and scissors, only their number is relevant.
+  if (isDynamic(vk::DynamicState::eViewport)) {
+    writer.write<uint32_t>(static_cast<uint32_t>(mViewports.size()));
+  } else {
+    writer.write(mViewports);
+  }
+  if (isDynamic(vk::DynamicState::eScissor)) {
+    writer.write<uint32_t>(static_cast<uint32_t>(mScissors.size()));
+  } else {
+    writer.write(mScissors);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsState::deserialize(Core::BinaryReader& reader) {
+  reset();
+
+  auto dynamicStateCount = reader.read<uint32_t>();
+  for (uint32_t i(0); i < dynamicStateCount; ++i) {
+    mDynamicState.insert(reader.read<vk::DynamicState>());
+  }
+
+  auto isDynamic = [this](vk::DynamicState state) { return mDynamicState.count(state) != 0u; };
+  auto readBool  = [&reader]() { return reader.read<uint8_t>() != 0; };
+
+  mBlendLogicOpEnable = readBool();
+  reader.read(mBlendLogicOp);
+  mBlendAttachments.resize(reader.read<uint32_t>());
+  for (auto& attachment : mBlendAttachments) {
+    attachment.mBlendEnable = readBool();
+    reader.read(attachment.mSrcColorBlendFactor);
+    reader.read(attachment.mDstColorBlendFactor);
+    reader.read(attachment.mColorBlendOp);
+    reader.read(attachment.mSrcAlphaBlendFactor);
+    reader.read(attachment.mDstAlphaBlendFactor);
+    reader.read(attachment.mAlphaBlendOp);
+    attachment.mColorWriteMask = vk::ColorComponentFlags(reader.read<uint32_t>());
+  }
+  if (!isDynamic(vk::DynamicState::eBlendConstants)) {
+    reader.read(mBlendConstants);
+  }
+
+  mDepthTestEnable  = readBool();
+  mDepthWriteEnable = readBool();
+  reader.read(mDepthCompareOp);
+  mDepthBoundsTestEnable = readBool();
+  mStencilTestEnable     = readBool();
+  reader.read(mStencilFrontFailOp);
+  reader.read(mStencilFrontPassOp);
+  reader.read(mStencilFrontDepthFailOp);
+  reader.read(mStencilFrontCompareOp);
+  reader.read(mStencilBackFailOp);
+  reader.read(mStencilBackPassOp);
+  reader.read(mStencilBackDepthFailOp);
+  reader.read(mStencilBackCompareOp);
+  if (!isDynamic(vk::DynamicState::eStencilCompareMask)) {
+    reader.read(mStencilFrontCompareMask);
+    reader.read(mStencilBackCompareMask);
+  }
+  if (!isDynamic(vk::DynamicState::eStencilWriteMask)) {
+    reader.read(mStencilFrontWriteMask);
+    reader.read(mStencilBackWriteMask);
+  }
+  if (!isDynamic(vk::DynamicState::eStencilReference)) {
+    reader.read(mStencilFrontReference);
+    reader.read(mStencilBackReference);
+  }
+  if (!isDynamic(vk::DynamicState::eDepthBounds)) {
+    reader.read(mMinDepthBounds);
+    reader.read(mMaxDepthBounds);
+  }
+
+  reader.read(mTopology);
+  mPrimitiveRestartEnable = readBool();
+
+  reader.read(mRasterizationSamples);
+  mSampleShadingEnable = readBool();
+  reader.read(mMinSampleShading);
+  reader.read(mSampleMask);
+  mAlphaToCoverageEnable = readBool();
+  mAlphaToOneEnable      = readBool();
+
+  mDepthClampEnable        = readBool();
+  mRasterizerDiscardEnable = readBool();
+  reader.read(mPolygonMode);
+  mCullMode = vk::CullModeFlags(reader.read<uint32_t>());
+  reader.read(mFrontFace);
+  mDepthBiasEnable = readBool();
+  if (!isDynamic(vk::DynamicState::eDepthBias)) {
+    reader.read(mDepthBiasConstantFactor);
+    reader.read(mDepthBiasClamp);
+    reader.read(mDepthBiasSlopeFactor);
+  }
+  if (!isDynamic(vk::DynamicState::eLineWidth)) {
+    reader.read(mLineWidth);
+  }
+
+  reader.read(mTessellationPatchControlPoints);
+
+  reader.read(mVertexInputBindings);
+  reader.read(mVertexInputAttributes);
+
+  if (isDynamic(vk::DynamicState::eViewport)) {
+    mViewports.resize(reader.read<uint32_t>());
+  } else {
+    reader.read(mViewports);
+  }
+  if (isDynamic(vk::DynamicState::eScissor)) {
+    mScissors.resize(reader.read<uint32_t>());
+  } else {
+    reader.read(mScissors);
+  }
+
+  mDirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 } // namespace Illusion::Graphics
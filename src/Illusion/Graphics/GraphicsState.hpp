@@ -11,6 +11,7 @@
 
 #include "fwd.hpp"
 
+#include "../Core/BinaryStream.hpp"
 #include "../Core/BitHash.hpp"
 
 #include <glm/glm.hpp>
@@ -183,6 +184,9 @@ class GraphicsState {
   std::vector<vk::VertexInputAttributeDescription> const& getVertexInputAttributes() const;
 
   // Viewport State --------------------------------------------------------------------------------
+  // If vk::DynamicState::eViewport or vk::DynamicState::eScissor are part of the dynamic state,
+  // only the number of Viewports and Scissors is baked into the vk::Pipeline. The values are then
+  // set by the CommandBuffer whenever a vk::Pipeline is bound.
   void                                addViewport(Viewport const& val);
   void                                setViewports(std::vector<Viewport> const& val);
   std::vector<Viewport> const&        getViewports() const;
@@ -204,6 +208,14 @@ class GraphicsState {
   // -----------------------------------------------------------------------------------------------
   Core::BitHash const& getHash() const;
 
+  // Writes everything which is relevant for vk::Pipeline creation. Like for getHash(), values
+  // which are part of the dynamic state are skipped. This is used by the PipelineManifest.
+  void serialize(Core::BinaryWriter& writer) const;
+
+  // Reads a state which has been written with serialize(). All skipped values are reset to their
+  // defaults. This throws a std::runtime_error if the data is incomplete.
+  void deserialize(Core::BinaryReader& reader);
+
  private:
   DeviceConstPtr mDevice;
 
@@ -56,7 +56,7 @@ VkBool32 debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
   }
 
   if (messageSeverity == VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT) {
-    Core::Logger::trace() << message << std::endl;
+    ILLUSION_TRACE << message << std::endl;
   } else if (messageSeverity == VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
     Core::Logger::message() << message << std::endl;
   } else if (messageSeverity == VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
@@ -150,14 +150,13 @@ vk::SurfaceKHRPtr Instance::createSurface(std::string const& name, GLFWwindow* w
     throw std::runtime_error("Failed to create window surface!");
   }
 
-  Core::Logger::traceCreation("vk::SurfaceKHR", name);
+  ILLUSION_TRACE_CREATION("vk::SurfaceKHR", name);
 
   // copying instance to keep reference counting up until the surface is destroyed
   auto instance = mInstance;
   return VulkanPtr::create(vk::SurfaceKHR(tmp), [instance, name](vk::SurfaceKHR* obj) {
-    Core::Logger::traceDeletion("vk::SurfaceKHR", name);
+    ILLUSION_TRACE_DELETION("vk::SurfaceKHR", name);
     instance->destroySurfaceKHR(*obj);
-    delete obj;
   });
 }
 
@@ -225,12 +224,11 @@ vk::InstancePtr Instance::createInstance(std::string const& engine, std::string
     info.enabledLayerCount = 0;
   }
 
-  Core::Logger::traceCreation("vk::Instance", getName());
+  ILLUSION_TRACE_CREATION("vk::Instance", getName());
   auto name = getName();
   return VulkanPtr::create(vk::createInstance(info), [name](vk::Instance* obj) {
-    Core::Logger::traceDeletion("vk::Instance", name);
+    ILLUSION_TRACE_DELETION("vk::Instance", name);
     obj->destroy();
-    delete obj;
   });
 }
 
@@ -260,15 +258,14 @@ vk::DebugUtilsMessengerEXTPtr Instance::createDebugCallback() const {
   }
 
   auto name = "DebugCallback for " + getName();
-  Core::Logger::traceCreation("vk::DebugUtilsMessengerEXT", name);
+  ILLUSION_TRACE_CREATION("vk::DebugUtilsMessengerEXT", name);
   auto instance = mInstance;
   return VulkanPtr::create(
       vk::DebugUtilsMessengerEXT(tmp), [instance, name](vk::DebugUtilsMessengerEXT* obj) {
         auto destroyCallback = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(
             instance->getProcAddr("vkDestroyDebugUtilsMessengerEXT"));
-        Core::Logger::traceDeletion("vk::DebugUtilsMessengerEXT", name);
+        ILLUSION_TRACE_DELETION("vk::DebugUtilsMessengerEXT", name);
         destroyCallback(*instance, *obj, nullptr);
-        delete obj;
       });
 }
 
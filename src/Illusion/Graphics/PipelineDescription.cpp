@@ -0,0 +1,347 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PipelineDescription.hpp"
+
+#include "Device.hpp"
+#include "ShaderModule.hpp"
+
+#include <algorithm>
+
+namespace Illusion::Graphics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Core::BitHash PipelineDescription::getHash(QueueType type,
+    std::vector<ShaderModuleConstPtr> const& modules, GraphicsState const& graphicsState,
+    Core::BitHash const& renderPassHash, uint32_t subpass,
+    SpecialisationState const& specialisationState) {
+
+  Core::BitHash hash;
+
+  if (type != QueueType::eCompute) {
+    hash = graphicsState.getHash();
+  }
+
+  // The ids change when a ShaderModule is reloaded, so a new pipeline will be created then. The
+  // addresses of the handles cannot be used here, as they may be reused after a reload.
+  for (auto const& m : modules) {
+    hash.push<64>(m->getHandleId());
+  }
+
+  if (type != QueueType::eCompute) {
+    hash.push(renderPassHash);
+    hash.push<32>(subpass);
+  }
+
+  hash.push(specialisationState.getHash());
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<vk::ShaderModulePtr> PipelineDescription::getModuleHandles() const {
+  std::vector<vk::ShaderModulePtr> modules;
+  modules.reserve(mModules.size());
+  for (auto const& m : mModules) {
+    modules.push_back(m.second);
+  }
+  return modules;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::PipelinePtr PipelineDescription::create() const {
+
+  if (mType == QueueType::eCompute) {
+    if (mModules.size() != 1) {
+      throw std::runtime_error("Failed to create compute pipeline for \"" + mName +
+                               "\": There must be exactly one ShaderModule!");
+    }
+
+    vk::ComputePipelineCreateInfo info;
+    info.stage.stage               = mModules[0].first;
+    info.stage.module              = *mModules[0].second;
+    info.stage.pName               = "main";
+    info.stage.pSpecializationInfo = mSpecialisationState.getInfo();
+    info.layout                    = *mLayout;
+
+    return mDevice->createComputePipeline(DebugName("ComputePipeline of ", mName), info);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  std::vector<vk::PipelineShaderStageCreateInfo> stageInfos;
+  for (auto const& i : mModules) {
+    vk::PipelineShaderStageCreateInfo stageInfo;
+    stageInfo.stage               = i.first;
+    stageInfo.module              = *i.second;
+    stageInfo.pName               = "main";
+    stageInfo.pSpecializationInfo = mSpecialisationState.getInfo();
+    stageInfos.push_back(stageInfo);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineVertexInputStateCreateInfo vertexInputStateInfo;
+
+  std::vector<vk::VertexInputBindingDescription>   vertexInputBindingDescriptions;
+  std::vector<vk::VertexInputAttributeDescription> vertexInputAttributeDescriptions;
+  for (auto const& i : mGraphicsState.getVertexInputBindings()) {
+    vertexInputBindingDescriptions.emplace_back(i.binding, i.stride, i.inputRate);
+  }
+  for (auto const& i : mGraphicsState.getVertexInputAttributes()) {
+    vertexInputAttributeDescriptions.emplace_back(i.location, i.binding, i.format, i.offset);
+  }
+  vertexInputStateInfo.vertexBindingDescriptionCount =
+      static_cast<uint32_t>(vertexInputBindingDescriptions.size());
+  vertexInputStateInfo.pVertexBindingDescriptions = vertexInputBindingDescriptions.data();
+  vertexInputStateInfo.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(vertexInputAttributeDescriptions.size());
+  vertexInputStateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateInfo;
+  inputAssemblyStateInfo.topology = mGraphicsState.getTopology();
+  inputAssemblyStateInfo.primitiveRestartEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getPrimitiveRestartEnable());
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineTessellationStateCreateInfo tessellationStateInfo;
+  tessellationStateInfo.patchControlPoints = mGraphicsState.getTessellationPatchControlPoints();
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineViewportStateCreateInfo viewportStateInfo;
+  std::vector<vk::Viewport>           viewports;
+  std::vector<vk::Rect2D>             scissors;
+  for (auto const& i : mGraphicsState.getViewports()) {
+    viewports.emplace_back(
+        i.mOffset[0], i.mOffset[1], i.mExtend[0], i.mExtend[1], i.mMinDepth, i.mMaxDepth);
+  }
+
+  // use viewport as scissors if no scissors are defined
+  if (!mGraphicsState.getScissors().empty()) {
+    for (auto const& i : mGraphicsState.getScissors()) {
+      scissors.push_back({{i.mOffset[0], i.mOffset[1]}, {i.mExtend[0], i.mExtend[1]}});
+    }
+  } else {
+    for (auto const& i : mGraphicsState.getViewports()) {
+      scissors.push_back({{static_cast<int32_t>(i.mOffset[0]), static_cast<int32_t>(i.mOffset[1])},
+          {static_cast<uint32_t>(i.mExtend[0]), static_cast<uint32_t>(i.mExtend[1])}});
+    }
+  }
+  viewportStateInfo.viewportCount = static_cast<uint32_t>(viewports.size());
+  viewportStateInfo.pViewports    = viewports.data();
+  viewportStateInfo.scissorCount  = static_cast<uint32_t>(scissors.size());
+  viewportStateInfo.pScissors     = scissors.data();
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineRasterizationStateCreateInfo rasterizationStateInfo;
+  rasterizationStateInfo.depthClampEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getDepthClampEnable());
+  rasterizationStateInfo.rasterizerDiscardEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getRasterizerDiscardEnable());
+  rasterizationStateInfo.polygonMode = mGraphicsState.getPolygonMode();
+  rasterizationStateInfo.cullMode    = mGraphicsState.getCullMode();
+  rasterizationStateInfo.frontFace   = mGraphicsState.getFrontFace();
+  rasterizationStateInfo.depthBiasEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getDepthBiasEnable());
+  rasterizationStateInfo.depthBiasConstantFactor = mGraphicsState.getDepthBiasConstantFactor();
+  rasterizationStateInfo.depthBiasClamp          = mGraphicsState.getDepthBiasClamp();
+  rasterizationStateInfo.depthBiasSlopeFactor    = mGraphicsState.getDepthBiasSlopeFactor();
+  rasterizationStateInfo.lineWidth               = mGraphicsState.getLineWidth();
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineMultisampleStateCreateInfo multisampleStateInfo;
+  std::vector<uint32_t>                  sampleMask = mGraphicsState.getSampleMask();
+  multisampleStateInfo.rasterizationSamples = mGraphicsState.getRasterizationSamples();
+  multisampleStateInfo.sampleShadingEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getSampleShadingEnable());
+  multisampleStateInfo.minSampleShading = mGraphicsState.getMinSampleShading();
+  multisampleStateInfo.pSampleMask      = sampleMask.data();
+  multisampleStateInfo.alphaToCoverageEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getAlphaToCoverageEnable());
+  multisampleStateInfo.alphaToOneEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getAlphaToOneEnable());
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineDepthStencilStateCreateInfo depthStencilStateInfo;
+  depthStencilStateInfo.depthTestEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getDepthTestEnable());
+  depthStencilStateInfo.depthWriteEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getDepthWriteEnable());
+  depthStencilStateInfo.depthCompareOp = mGraphicsState.getDepthCompareOp();
+  depthStencilStateInfo.depthBoundsTestEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getDepthBoundsTestEnable());
+  depthStencilStateInfo.stencilTestEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getStencilTestEnable());
+  depthStencilStateInfo.front          = {mGraphicsState.getStencilFrontFailOp(),
+      mGraphicsState.getStencilFrontPassOp(), mGraphicsState.getStencilFrontDepthFailOp(),
+      mGraphicsState.getStencilFrontCompareOp(), mGraphicsState.getStencilFrontCompareMask(),
+      mGraphicsState.getStencilFrontWriteMask(), mGraphicsState.getStencilFrontReference()};
+  depthStencilStateInfo.back           = {mGraphicsState.getStencilBackFailOp(),
+      mGraphicsState.getStencilBackPassOp(), mGraphicsState.getStencilBackDepthFailOp(),
+      mGraphicsState.getStencilBackCompareOp(), mGraphicsState.getStencilBackCompareMask(),
+      mGraphicsState.getStencilBackWriteMask(), mGraphicsState.getStencilBackReference()};
+  depthStencilStateInfo.minDepthBounds = mGraphicsState.getMinDepthBounds();
+  depthStencilStateInfo.maxDepthBounds = mGraphicsState.getMaxDepthBounds();
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineColorBlendStateCreateInfo              colorBlendStateInfo;
+  std::vector<vk::PipelineColorBlendAttachmentState> pipelineColorBlendAttachments;
+
+  // use default blend attachments if none are defined
+  if (mGraphicsState.getBlendAttachments().empty()) {
+    for (size_t i(0); i < mSubpasses[mSubpass].mColorAttachments.size(); ++i) {
+      GraphicsState::BlendAttachment a;
+      pipelineColorBlendAttachments.emplace_back(static_cast<vk::Bool32>(a.mBlendEnable),
+          a.mSrcColorBlendFactor, a.mDstColorBlendFactor, a.mColorBlendOp, a.mSrcAlphaBlendFactor,
+          a.mDstAlphaBlendFactor, a.mAlphaBlendOp, a.mColorWriteMask);
+    }
+
+  } else {
+    for (auto const& i : mGraphicsState.getBlendAttachments()) {
+      pipelineColorBlendAttachments.emplace_back(static_cast<vk::Bool32>(i.mBlendEnable),
+          i.mSrcColorBlendFactor, i.mDstColorBlendFactor, i.mColorBlendOp, i.mSrcAlphaBlendFactor,
+          i.mDstAlphaBlendFactor, i.mAlphaBlendOp, i.mColorWriteMask);
+    }
+  }
+  colorBlendStateInfo.logicOpEnable =
+      static_cast<vk::Bool32>(mGraphicsState.getBlendLogicOpEnable());
+  colorBlendStateInfo.logicOp         = mGraphicsState.getBlendLogicOp();
+  colorBlendStateInfo.attachmentCount = static_cast<uint32_t>(pipelineColorBlendAttachments.size());
+  colorBlendStateInfo.pAttachments    = pipelineColorBlendAttachments.data();
+  colorBlendStateInfo.blendConstants[0] = mGraphicsState.getBlendConstants()[0];
+  colorBlendStateInfo.blendConstants[1] = mGraphicsState.getBlendConstants()[1];
+  colorBlendStateInfo.blendConstants[2] = mGraphicsState.getBlendConstants()[2];
+  colorBlendStateInfo.blendConstants[3] = mGraphicsState.getBlendConstants()[3];
+
+  // -----------------------------------------------------------------------------------------------
+  vk::PipelineDynamicStateCreateInfo dynamicStateInfo;
+  std::vector<vk::DynamicState>      dynamicState(
+      mGraphicsState.getDynamicState().begin(), mGraphicsState.getDynamicState().end());
+  dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicState.size());
+  dynamicStateInfo.pDynamicStates    = dynamicState.data();
+
+  // -----------------------------------------------------------------------------------------------
+  vk::GraphicsPipelineCreateInfo info;
+  info.stageCount          = static_cast<uint32_t>(stageInfos.size());
+  info.pStages             = stageInfos.data();
+  info.pVertexInputState   = &vertexInputStateInfo;
+  info.pInputAssemblyState = &inputAssemblyStateInfo;
+  info.pTessellationState  = &tessellationStateInfo;
+  info.pViewportState      = &viewportStateInfo;
+  info.pRasterizationState = &rasterizationStateInfo;
+  info.pMultisampleState   = &multisampleStateInfo;
+  info.pDepthStencilState  = &depthStencilStateInfo;
+  info.pColorBlendState    = &colorBlendStateInfo;
+  if (!mGraphicsState.getDynamicState().empty()) {
+    info.pDynamicState = &dynamicStateInfo;
+  }
+  info.renderPass = *mRenderPass;
+  info.subpass    = mSubpass;
+  info.layout     = *mLayout;
+
+  return mDevice->createGraphicsPipeline(DebugName("GraphicsPipeline of ", mName), info);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineDescription::serialize(Core::BinaryWriter& writer) const {
+  writer.write(mShaderName);
+  writer.write(mType);
+  mSpecialisationState.serialize(writer);
+
+  if (mType == QueueType::eCompute) {
+    return;
+  }
+
+  mGraphicsState.serialize(writer);
+
+  writer.write<uint32_t>(static_cast<uint32_t>(mAttachments.size()));
+  for (auto const& attachment : mAttachments) {
+    writer.write(attachment.format);
+    writer.write(attachment.samples);
+  }
+
+  writer.write<uint32_t>(static_cast<uint32_t>(mSubpasses.size()));
+  for (auto const& subpass : mSubpasses) {
+    writer.write(subpass.mPreSubpasses);
+    writer.write(subpass.mInputAttachments);
+    writer.write(subpass.mColorAttachments);
+    writer.write<uint8_t>(subpass.mDepthStencilAttachment ? 1 : 0);
+    writer.write(subpass.mDepthStencilAttachment.value_or(0));
+  }
+
+  writer.write(mSubpass);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineDescription::deserialize(Core::BinaryReader& reader) {
+  reader.read(mShaderName);
+  reader.read(mType);
+  mSpecialisationState.deserialize(reader);
+
+  if (mType == QueueType::eCompute) {
+    return;
+  }
+
+  mGraphicsState.deserialize(reader);
+
+  // Load and store operations and layouts are not relevant for render pass compatibility. The
+  // general layout can be used for all types of attachments.
+  mAttachments.resize(reader.read<uint32_t>());
+  for (auto& attachment : mAttachments) {
+    reader.read(attachment.format);
+    reader.read(attachment.samples);
+    attachment.loadOp         = vk::AttachmentLoadOp::eDontCare;
+    attachment.storeOp        = vk::AttachmentStoreOp::eDontCare;
+    attachment.stencilLoadOp  = vk::AttachmentLoadOp::eDontCare;
+    attachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+    attachment.initialLayout  = vk::ImageLayout::eUndefined;
+    attachment.finalLayout    = vk::ImageLayout::eGeneral;
+  }
+
+  mSubpasses.resize(reader.read<uint32_t>());
+  for (auto& subpass : mSubpasses) {
+    reader.read(subpass.mPreSubpasses);
+    reader.read(subpass.mInputAttachments);
+    reader.read(subpass.mColorAttachments);
+    bool hasDepthStencilAttachment = reader.read<uint8_t>() != 0;
+    auto depthStencilAttachment    = reader.read<uint32_t>();
+    if (hasDepthStencilAttachment) {
+      subpass.mDepthStencilAttachment = depthStencilAttachment;
+    }
+  }
+
+  reader.read(mSubpass);
+
+  // The indices are used for array accesses when the render pass is created, so we better check
+  // them here.
+  auto isValid = [this](std::vector<uint32_t> const& indices, size_t size) {
+    return std::all_of(indices.begin(), indices.end(), [size](uint32_t i) { return i < size; });
+  };
+
+  bool valid = mSubpass < mSubpasses.size();
+  for (auto const& subpass : mSubpasses) {
+    valid = valid && isValid(subpass.mPreSubpasses, mSubpasses.size()) &&
+            isValid(subpass.mInputAttachments, mAttachments.size()) &&
+            isValid(subpass.mColorAttachments, mAttachments.size()) &&
+            (!subpass.mDepthStencilAttachment ||
+                *subpass.mDepthStencilAttachment < mAttachments.size());
+  }
+
+  if (!valid) {
+    throw std::runtime_error("Failed to read pipeline description for shader \"" + mShaderName +
+                             "\": Invalid attachment or subpass index!");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Graphics
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_GRAPHICS_PIPELINE_DESCRIPTION_HPP
+#define ILLUSION_GRAPHICS_PIPELINE_DESCRIPTION_HPP
+
+#include "GraphicsState.hpp"
+#include "RenderPass.hpp"
+#include "SpecialisationState.hpp"
+
+namespace Illusion::Graphics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// A PipelineDescription contains everything which is needed to create a vk::Pipeline. It is a    //
+// copy of the state of a CommandBuffer, so the pipeline can be created on a worker thread while  //
+// the CommandBuffer records further commands. The PipelineManifest stores PipelineDescriptions   //
+// in files; only the members which are not Vulkan objects are serialized. Therefore the shader   //
+// is identified by its name.                                                                     //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct PipelineDescription {
+
+  // Returns the hash which identifies the vk::Pipeline for the given state in the caches of the
+  // CommandBuffers and in the PipelineObjectCache. For compute pipelines, the graphics state and
+  // the render pass are ignored.
+  static Core::BitHash getHash(QueueType type, std::vector<ShaderModuleConstPtr> const& modules,
+      GraphicsState const& graphicsState, Core::BitHash const& renderPassHash, uint32_t subpass,
+      SpecialisationState const& specialisationState);
+
+  // Creates a compute pipeline if mType is QueueType::eCompute, a graphics pipeline otherwise.
+  vk::PipelinePtr create() const;
+
+  // Returns the second elements of mModules.
+  std::vector<vk::ShaderModulePtr> getModuleHandles() const;
+
+  // Writes and reads all members which are not Vulkan objects. deserialize() throws a
+  // std::runtime_error if the data is incomplete.
+  void serialize(Core::BinaryWriter& writer) const;
+  void deserialize(Core::BinaryReader& reader);
+
+  DeviceConstPtr      mDevice;
+  std::string         mName;
+  std::string         mShaderName;
+  QueueType           mType;
+  GraphicsState       mGraphicsState;
+  SpecialisationState mSpecialisationState;
+
+  std::vector<std::pair<vk::ShaderStageFlagBits, vk::ShaderModulePtr>> mModules;
+  vk::PipelineLayoutPtr                                                mLayout;
+
+  // These are only used for graphics pipelines. Only the formats and sample counts of the
+  // attachments are relevant; mRenderPass has to be compatible to them.
+  vk::RenderPassPtr                      mRenderPass;
+  std::vector<vk::AttachmentDescription> mAttachments;
+  std::vector<RenderPass::Subpass>       mSubpasses;
+  uint32_t                               mSubpass = 0;
+};
+
+} // namespace Illusion::Graphics
+
+#endif // ILLUSION_GRAPHICS_PIPELINE_DESCRIPTION_HPP
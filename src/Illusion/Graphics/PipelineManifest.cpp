@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PipelineManifest.hpp"
+
+#include "../Core/BinaryStream.hpp"
+#include "../Core/File.hpp"
+#include "../Core/Logger.hpp"
+#include "../Core/Profiler.hpp"
+#include "Device.hpp"
+#include "PipelineDescription.hpp"
+#include "PipelineObjectCache.hpp"
+#include "PipelineReflection.hpp"
+#include "Shader.hpp"
+#include "ShaderModule.hpp"
+
+#include <unordered_map>
+#include <utility>
+
+namespace Illusion::Graphics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+// The file starts with these two values followed by the number of entries. The version has to be
+// incremented whenever the serialization of PipelineDescriptions changes.
+const uint32_t MANIFEST_MAGIC   = 0x4d504c49; // "ILPM"
+const uint32_t MANIFEST_VERSION = 1;
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PipelineManifest::PipelineManifest(std::string fileName)
+    : mFileName(std::move(fileName)) {
+
+  if (!mFileName.empty() && Core::File(mFileName).isValid()) {
+    load();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PipelineManifest::~PipelineManifest() {
+  if (mDirty) {
+    save();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineManifest::record(PipelineDescription const& description) {
+  Core::BinaryWriter writer;
+  description.serialize(writer);
+
+  auto const& data = writer.getData();
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  if (mEntries.emplace(data.begin(), data.end()).second) {
+    mDirty = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t PipelineManifest::replay(DeviceConstPtr const& device, ShaderResolver const& resolveShader,
+    Core::ThreadPool* threadPool) const {
+
+  ILLUSION_PROFILE_ZONE("PipelineManifest::replay");
+
+  // The entries are copied so that the CommandBuffers can record new entries in the meantime.
+  std::vector<std::string> entries;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    entries.assign(mEntries.begin(), mEntries.end());
+  }
+
+  auto const& cache = device->getPipelineObjectCache();
+
+  // Usually, many pipelines share the same render pass. As the pipelines only need a compatible
+  // render pass, one vk::RenderPass is created for each compatibility hash.
+  std::unordered_map<Core::BitHash, vk::RenderPassPtr> renderPasses;
+
+  uint32_t createdCount = 0;
+  uint32_t skippedCount = 0;
+
+  for (auto const& entry : entries) {
+    PipelineDescription description{
+        device, "", "", QueueType::eGeneric, GraphicsState(device), SpecialisationState()};
+
+    ShaderPtr     shader;
+    Core::BitHash hash;
+
+    try {
+      Core::BinaryReader reader(entry.data(), entry.size());
+      description.deserialize(reader);
+
+      shader = resolveShader(description.mShaderName);
+      if (!shader) {
+        ++skippedCount;
+        continue;
+      }
+
+      description.mName = description.mShaderName;
+
+      // This may compile the shader, so it may throw as well.
+      for (auto const& m : shader->getModules()) {
+        description.mModules.emplace_back(m->getStage(), m->getHandle());
+      }
+      description.mLayout = shader->getReflection()->getLayout();
+
+      Core::BitHash renderPassHash;
+
+      if (description.mType != QueueType::eCompute) {
+        renderPassHash =
+            RenderPass::getCompatibilityHash(description.mAttachments, description.mSubpasses);
+
+        auto& renderPass = renderPasses[renderPassHash];
+        if (!renderPass) {
+          renderPass = RenderPass::createHandle(device, DebugName("RenderPass of PipelineManifest"),
+              description.mAttachments, description.mSubpasses);
+        }
+        description.mRenderPass = renderPass;
+      }
+
+      hash = PipelineDescription::getHash(description.mType, shader->getModules(),
+          description.mGraphicsState, renderPassHash, description.mSubpass,
+          description.mSpecialisationState);
+
+      if (cache->contains(hash)) {
+        continue;
+      }
+
+      if (!threadPool) {
+        cache->prepare(hash, description.create(), description.getModuleHandles());
+      }
+
+    } catch (std::exception const& e) {
+      Core::Logger::warning() << "Failed to replay pipeline for shader \""
+                              << description.mShaderName << "\" from manifest \"" << mFileName
+                              << "\": " << e.what() << std::endl;
+      ++skippedCount;
+      continue;
+    }
+
+    if (threadPool) {
+      auto modules = description.getModuleHandles();
+      cache->createAsync(hash, *threadPool,
+          [description = std::move(description)]() { return description.create(); }, modules);
+    }
+
+    ++createdCount;
+  }
+
+  if (skippedCount > 0) {
+    Core::Logger::debug() << "Skipped " << skippedCount << " of " << entries.size()
+                          << " pipelines from manifest \"" << mFileName << "\"." << std::endl;
+  }
+
+  return createdCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineManifest::save() const {
+  if (mFileName.empty()) {
+    return false;
+  }
+
+  Core::BinaryWriter writer;
+  writer.write(MANIFEST_MAGIC);
+  writer.write(MANIFEST_VERSION);
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    writer.write<uint32_t>(static_cast<uint32_t>(mEntries.size()));
+    for (auto const& entry : mEntries) {
+      writer.write(entry);
+    }
+    mDirty = false;
+  }
+
+  if (!Core::File(mFileName).saveAtomic(writer.getData())) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDirty = true;
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t PipelineManifest::getSize() const {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mEntries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineManifest::clear() {
+  std::unique_lock<std::mutex> lock(mMutex);
+  mDirty = mDirty || !mEntries.empty();
+  mEntries.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineManifest::load() {
+  try {
+    auto               data = Core::File(mFileName).map();
+    Core::BinaryReader reader(data.getData(), data.getSize());
+
+    if (reader.read<uint32_t>() != MANIFEST_MAGIC || reader.read<uint32_t>() != MANIFEST_VERSION) {
+      throw std::runtime_error("Unsupported file format!");
+    }
+
+    auto count = reader.read<uint32_t>();
+    for (uint32_t i(0); i < count; ++i) {
+      mEntries.insert(reader.read<std::string>());
+    }
+  } catch (std::exception const& e) {
+    Core::Logger::warning() << "Ignoring pipeline manifest \"" << mFileName << "\": " << e.what()
+                            << std::endl;
+    mEntries.clear();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Graphics
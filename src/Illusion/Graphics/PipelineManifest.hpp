@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_GRAPHICS_PIPELINE_MANIFEST_HPP
+#define ILLUSION_GRAPHICS_PIPELINE_MANIFEST_HPP
+
+#include "../Core/StaticCreate.hpp"
+#include "../Core/ThreadPool.hpp"
+#include "PipelineDescription.hpp"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace Illusion::Graphics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Even with a persistent vk::PipelineCache, vk::Pipelines are only created when they are used    //
+// for the first time - which may cause hitches during rendering. A PipelineManifest records the  //
+// PipelineDescription of each vk::Pipeline which is created during a session. On the next start  //
+// of the application, the manifest can be replayed during the loading phase; the resulting       //
+// vk::Pipelines are stored in the Device's PipelineObjectCache, so that the CommandBuffers will  //
+// find them there when they need them.                                                           //
+//                                                                                                //
+// auto manifest = Graphics::PipelineManifest::create("pipelines.manifest");                      //
+// device->setPipelineManifest(manifest);                                                         //
+// manifest->replay(device, [&](std::string const& name) { return shaders[name]; }, &threadPool); //
+//                                                                                                //
+// Shaders are identified by their names, so these should be unique. Render passes are created by //
+// the manifest; they only have to be compatible to those used during recording. The manifest     //
+// file should be deleted when the shaders change significantly, else pipelines which are not     //
+// needed anymore will be replayed. All methods are thread-safe.                                  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class PipelineManifest : public Core::StaticCreate<PipelineManifest> {
+ public:
+  // Returns the Shader with the given name or nullptr if it is not available. Descriptions of
+  // unavailable shaders are skipped during replay.
+  using ShaderResolver = std::function<ShaderPtr(std::string const& name)>;
+
+  // If a file name is given, the recorded descriptions are loaded from this file. A missing or
+  // invalid file results in an empty manifest.
+  explicit PipelineManifest(std::string fileName = "");
+
+  // Saves the manifest if a fileName has been given and something has been recorded.
+  virtual ~PipelineManifest();
+
+  PipelineManifest(PipelineManifest const& other) = delete;
+  PipelineManifest& operator=(PipelineManifest const& other) = delete;
+
+  // Adds the given description unless an identical one has been recorded before. This is called by
+  // the CommandBuffers of a Device whenever they create a new vk::Pipeline, see
+  // Device::setPipelineManifest().
+  void record(PipelineDescription const& description);
+
+  // Creates the vk::Pipelines for all recorded descriptions whose Shader can be resolved and which
+  // are not already in the PipelineObjectCache of the given Device. They are kept alive by the
+  // PipelineObjectCache until a CommandBuffer uses them. If a ThreadPool is given, the pipelines
+  // are created in parallel and this returns immediately; use ThreadPool::waitIdle() or
+  // PipelineObjectCache::getPendingCount() to wait for them. Returns the number of vk::Pipelines
+  // which are created.
+  uint32_t replay(DeviceConstPtr const& device, ShaderResolver const& resolveShader,
+      Core::ThreadPool* threadPool = nullptr) const;
+
+  // Writes all recorded descriptions to the fileName given at construction time. The file is
+  // replaced atomically. This is called by the destructor; you may call it earlier. Returns false
+  // if no fileName has been given or if saving failed.
+  bool save() const;
+
+  // Returns the number of recorded descriptions.
+  size_t getSize() const;
+
+  // Removes all recorded descriptions.
+  void clear();
+
+ private:
+  void load();
+
+  std::string                     mFileName;
+  std::unordered_set<std::string> mEntries;
+  mutable bool                    mDirty = false;
+  mutable std::mutex              mMutex;
+};
+
+} // namespace Illusion::Graphics
+
+#endif // ILLUSION_GRAPHICS_PIPELINE_MANIFEST_HPP
@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PipelineObjectCache.hpp"
+
+#include "../Core/Logger.hpp"
+
+#include <algorithm>
+
+namespace Illusion::Graphics {
+
+namespace {
+
+// Returns true if one of the given vk::ShaderModules has been deleted.
+template <typename T>
+bool anyExpired(T const& modules) {
+  return std::any_of(
+      modules.begin(), modules.end(), [](auto const& module) { return module.expired(); });
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::PipelinePtr PipelineObjectCache::get(Core::BitHash const& hash) {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return getImpl(hash);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::PipelinePtr PipelineObjectCache::add(
+    Core::BitHash const& hash, vk::PipelinePtr const& pipeline) {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (auto existing = getImpl(hash)) {
+    return existing;
+  }
+
+  mPipelines[hash] = pipeline;
+  cleanup();
+
+  return pipeline;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::PipelinePtr PipelineObjectCache::createAsync(Core::BitHash const& hash,
+    Core::ThreadPool& threadPool, std::function<vk::PipelinePtr()> create,
+    std::vector<vk::ShaderModulePtr> const& modules) {
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (auto existing = getImpl(hash)) {
+      return existing;
+    }
+
+    // A pipeline which failed before would most likely fail again. Trying it on each flush() would
+    // print an error each frame.
+    if (isFailedImpl(hash)) {
+      return nullptr;
+    }
+
+    if (!mPending.insert(hash).second) {
+      return nullptr;
+    }
+  }
+
+  ModuleList weakModules(modules.begin(), modules.end());
+
+  // The task keeps this PipelineObjectCache alive until the pipeline has been created. Whatever
+  // happens, the hash has to be removed from mPending. Else it would never be created again.
+  threadPool.submit([self = shared_from_this(), hash, create = std::move(create),
+                        weakModules = std::move(weakModules)]() mutable {
+    vk::PipelinePtr pipeline;
+
+    try {
+      pipeline = create();
+    } catch (std::exception const& e) {
+      Core::Logger::error() << "Failed to create pipeline asynchronously: " << e.what()
+                            << std::endl;
+    } catch (...) {
+      Core::Logger::error() << "Failed to create pipeline asynchronously: Unknown exception!"
+                            << std::endl;
+    }
+
+    std::unique_lock<std::mutex> lock(self->mMutex);
+    self->mPending.erase(hash);
+    if (pipeline) {
+      self->mPrepared[hash] = {std::move(pipeline), std::move(weakModules)};
+    } else {
+      self->mFailed[hash] = std::move(weakModules);
+    }
+    self->cleanup();
+  });
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineObjectCache::prepare(Core::BitHash const& hash, vk::PipelinePtr const& pipeline,
+    std::vector<vk::ShaderModulePtr> const& modules) {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (containsImpl(hash)) {
+    return false;
+  }
+
+  mPrepared[hash] = {pipeline, ModuleList(modules.begin(), modules.end())};
+  cleanup();
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineObjectCache::contains(Core::BitHash const& hash) const {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return containsImpl(hash) || mPending.find(hash) != mPending.end() || isFailedImpl(hash);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineObjectCache::isPending(Core::BitHash const& hash) const {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mPending.find(hash) != mPending.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineObjectCache::isFailed(Core::BitHash const& hash) const {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return isFailedImpl(hash);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t PipelineObjectCache::getPendingCount() const {
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mPending.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t PipelineObjectCache::getSize() const {
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  auto alive = std::count_if(mPipelines.begin(), mPipelines.end(),
+      [](auto const& entry) { return !entry.second.expired(); });
+
+  return mPrepared.size() + static_cast<size_t>(alive);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::PipelinePtr PipelineObjectCache::getImpl(Core::BitHash const& hash) {
+
+  // Pipelines which have been created asynchronously or ahead of time are only referenced by
+  // mPrepared. When they are retrieved for the first time, the caller takes over the ownership.
+  auto prepared = mPrepared.find(hash);
+  if (prepared != mPrepared.end()) {
+    auto pipeline = std::move(prepared->second.mPipeline);
+    mPrepared.erase(prepared);
+    mPipelines[hash] = pipeline;
+    return pipeline;
+  }
+
+  auto it = mPipelines.find(hash);
+  if (it == mPipelines.end()) {
+    return nullptr;
+  }
+
+  auto pipeline = it->second.lock();
+  if (!pipeline) {
+    mPipelines.erase(it);
+  }
+
+  return pipeline;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineObjectCache::containsImpl(Core::BitHash const& hash) const {
+  if (mPrepared.find(hash) != mPrepared.end()) {
+    return true;
+  }
+
+  auto it = mPipelines.find(hash);
+  return it != mPipelines.end() && !it->second.expired();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PipelineObjectCache::isFailedImpl(Core::BitHash const& hash) const {
+  auto it = mFailed.find(hash);
+  if (it == mFailed.end()) {
+    return false;
+  }
+
+  // If one of the vk::ShaderModules has been deleted, the hash will not be requested again.
+  if (anyExpired(it->second)) {
+    mFailed.erase(it);
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineObjectCache::cleanup() {
+
+  // Entries of deleted pipelines are only removed when they are looked up again. In order to keep
+  // the maps from growing indefinitely, all of them are removed whenever their size has doubled.
+  if (mPipelines.size() + mPrepared.size() + mFailed.size() >= mNextCleanup) {
+    removeExpired();
+    mNextCleanup =
+        std::max(mNextCleanup, (mPipelines.size() + mPrepared.size() + mFailed.size()) * 2);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PipelineObjectCache::removeExpired() {
+  auto it = mPipelines.begin();
+  while (it != mPipelines.end()) {
+    if (it->second.expired()) {
+      it = mPipelines.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Prepared pipelines of deleted vk::ShaderModules would never be retrieved.
+  auto prepared = mPrepared.begin();
+  while (prepared != mPrepared.end()) {
+    if (anyExpired(prepared->second.mModules)) {
+      prepared = mPrepared.erase(prepared);
+    } else {
+      ++prepared;
+    }
+  }
+
+  auto failed = mFailed.begin();
+  while (failed != mFailed.end()) {
+    if (anyExpired(failed->second)) {
+      failed = mFailed.erase(failed);
+    } else {
+      ++failed;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace Illusion::Graphics
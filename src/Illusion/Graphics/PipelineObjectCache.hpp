@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILLUSION_GRAPHICS_PIPELINE_OBJECT_CACHE_HPP
+#define ILLUSION_GRAPHICS_PIPELINE_OBJECT_CACHE_HPP
+
+#include "../Core/BitHash.hpp"
+#include "../Core/ThreadPool.hpp"
+#include "fwd.hpp"
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Illusion::Graphics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The PipelineObjectCache shares vk::Pipelines between all CommandBuffers of a Device. Without   //
+// it, each CommandBuffer would create its own copy of the same vk::Pipeline - with several       //
+// frames in flight and one CommandBuffer per frame, each pipeline would be created several       //
+// times.                                                                                         //
+// The pipelines are identified by the same hash the CommandBuffers use for their internal        //
+// caches. The PipelineObjectCache only stores weak references: the CommandBuffers keep the       //
+// pipelines they have used recently alive, and a vk::Pipeline is deleted as soon as no           //
+// CommandBuffer references it anymore.                                                           //
+// Pipelines can also be created asynchronously on a Core::ThreadPool with createAsync() or ahead //
+// of time with prepare(). Such a pipeline is kept alive by the PipelineObjectCache until it has  //
+// been retrieved once or until one of the vk::ShaderModules it has been created from is deleted. //
+// There is one instance per Device, see Device::getPipelineObjectCache(). All methods are        //
+// thread-safe.                                                                                   //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class PipelineObjectCache : public std::enable_shared_from_this<PipelineObjectCache> {
+ public:
+  // Returns the vk::Pipeline which has been stored for the given hash. Returns nullptr if there is
+  // none or if it has already been deleted.
+  vk::PipelinePtr get(Core::BitHash const& hash);
+
+  // Stores the given vk::Pipeline. If another thread has stored a vk::Pipeline for the same hash in
+  // the meantime, this is returned instead and the given one should be discarded.
+  vk::PipelinePtr add(Core::BitHash const& hash, vk::PipelinePtr const& pipeline);
+
+  // Stores the given vk::Pipeline like createAsync() does: It is kept alive until it has been
+  // retrieved once or until one of the given vk::ShaderModules has been deleted (the hash cannot be
+  // requested anymore then). This is used for pipelines which are created before they are actually
+  // needed, for example by the PipelineManifest. Returns false if there already is a vk::Pipeline
+  // for the given hash; the given one should be discarded then.
+  bool prepare(Core::BitHash const& hash, vk::PipelinePtr const& pipeline,
+      std::vector<vk::ShaderModulePtr> const& modules);
+
+  // Returns the vk::Pipeline for the given hash if there is one. Else the given function is
+  // submitted to the threadPool in order to create it and nullptr is returned. Once the function
+  // has finished, get() and createAsync() will return the new vk::Pipeline. While the function is
+  // running, it will not be submitted again for the same hash. If it throws, an error is printed
+  // and the hash is marked as failed: createAsync() will not try again as long as all given
+  // vk::ShaderModules are alive. Once one of them has been deleted (for example because the
+  // Shader has been reloaded), the failure is forgotten.
+  vk::PipelinePtr createAsync(Core::BitHash const& hash, Core::ThreadPool& threadPool,
+      std::function<vk::PipelinePtr()> create, std::vector<vk::ShaderModulePtr> const& modules);
+
+  // Returns true if there is a vk::Pipeline for the given hash, if it is currently created by
+  // createAsync() or if this has failed. In contrast to get(), this does not retrieve prepared
+  // vk::Pipelines.
+  bool contains(Core::BitHash const& hash) const;
+
+  // Returns true if the vk::Pipeline for the given hash is currently created by createAsync().
+  bool isPending(Core::BitHash const& hash) const;
+
+  // Returns true if createAsync() has failed to create the vk::Pipeline for the given hash and if
+  // the vk::ShaderModules it has been created from are still alive.
+  bool isFailed(Core::BitHash const& hash) const;
+
+  // Returns the number of vk::Pipelines which are currently created by createAsync().
+  size_t getPendingCount() const;
+
+  // Returns the number of stored vk::Pipelines which are still alive.
+  size_t getSize() const;
+
+ private:
+  typedef std::vector<std::weak_ptr<const vk::ShaderModule>> ModuleList;
+
+  struct PreparedPipeline {
+    vk::PipelinePtr mPipeline;
+    ModuleList      mModules;
+  };
+
+  // These require mMutex to be locked.
+  vk::PipelinePtr getImpl(Core::BitHash const& hash);
+  bool            containsImpl(Core::BitHash const& hash) const;
+  bool            isFailedImpl(Core::BitHash const& hash) const;
+  void            cleanup();
+  void            removeExpired();
+
+  std::unordered_map<Core::BitHash, std::weak_ptr<const vk::Pipeline>> mPipelines;
+  std::unordered_map<Core::BitHash, PreparedPipeline>                  mPrepared;
+  std::unordered_set<Core::BitHash>                                    mPending;
+  mutable std::unordered_map<Core::BitHash, ModuleList>                mFailed;
+  size_t                                                               mNextCleanup = 64;
+  mutable std::mutex                                                   mMutex;
+};
+
+} // namespace Illusion::Graphics
+
+#endif // ILLUSION_GRAPHICS_PIPELINE_OBJECT_CACHE_HPP
@@ -70,6 +70,113 @@ vk::RenderPassPtr const& RenderPass::getHandle() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+Core::BitHash const& RenderPass::getCompatibilityHash() const {
+  return mCompatibilityHash;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Core::BitHash RenderPass::getCompatibilityHash(
+    std::vector<vk::AttachmentDescription> const& attachments,
+    std::vector<Subpass> const&                   subpasses) {
+
+  // Render passes are compatible if their attachments have the same formats and sample counts and
+  // if their subpasses are identical. The dependencies are derived from mPreSubpasses.
+  Core::BitHash hash;
+  hash.push<32>(static_cast<uint32_t>(attachments.size()));
+  for (auto const& a : attachments) {
+    hash.push<32>(a.format);
+    hash.push<7>(a.samples);
+  }
+
+  auto pushIndices = [&hash](std::vector<uint32_t> const& indices) {
+    hash.push<32>(static_cast<uint32_t>(indices.size()));
+    for (uint32_t i : indices) {
+      hash.push<32>(i);
+    }
+  };
+
+  hash.push<32>(static_cast<uint32_t>(subpasses.size()));
+  for (auto const& subpass : subpasses) {
+    pushIndices(subpass.mPreSubpasses);
+    pushIndices(subpass.mInputAttachments);
+    pushIndices(subpass.mColorAttachments);
+    hash.push<1>(subpass.mDepthStencilAttachment.has_value());
+    hash.push<32>(subpass.mDepthStencilAttachment.value_or(0));
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+vk::RenderPassPtr RenderPass::createHandle(DeviceConstPtr const& device, DebugName const& name,
+    std::vector<vk::AttachmentDescription> const& attachments,
+    std::vector<Subpass> const&                   subpasses) {
+
+  std::vector<vk::AttachmentReference> attachmentRefs;
+
+  for (auto const& a : attachments) {
+    vk::AttachmentReference attachmentRef;
+    attachmentRef.layout     = a.finalLayout;
+    attachmentRef.attachment = static_cast<uint32_t>(attachmentRefs.size());
+
+    attachmentRefs.emplace_back(attachmentRef);
+  }
+
+  std::vector<vk::SubpassDescription>               subpassInfos(subpasses.size());
+  std::vector<std::vector<vk::AttachmentReference>> inputAttachmentRefs(subpasses.size());
+  std::vector<std::vector<vk::AttachmentReference>> colorAttachmentRefs(subpasses.size());
+
+  for (size_t i(0); i < subpasses.size(); ++i) {
+
+    for (uint32_t attachment : subpasses[i].mInputAttachments) {
+      inputAttachmentRefs[i].push_back(attachmentRefs[attachment]);
+    }
+
+    for (uint32_t attachment : subpasses[i].mColorAttachments) {
+      colorAttachmentRefs[i].push_back(attachmentRefs[attachment]);
+    }
+
+    if (subpasses[i].mDepthStencilAttachment) {
+      subpassInfos[i].pDepthStencilAttachment =
+          &attachmentRefs[*subpasses[i].mDepthStencilAttachment];
+    }
+
+    subpassInfos[i].pipelineBindPoint    = vk::PipelineBindPoint::eGraphics;
+    subpassInfos[i].inputAttachmentCount = static_cast<uint32_t>(inputAttachmentRefs[i].size());
+    subpassInfos[i].pInputAttachments    = inputAttachmentRefs[i].data();
+    subpassInfos[i].colorAttachmentCount = static_cast<uint32_t>(colorAttachmentRefs[i].size());
+    subpassInfos[i].pColorAttachments    = colorAttachmentRefs[i].data();
+  }
+
+  std::vector<vk::SubpassDependency> dependencies;
+  for (size_t dst(0); dst < subpasses.size(); ++dst) {
+    for (auto src : subpasses[dst].mPreSubpasses) {
+      vk::SubpassDependency dependency;
+      dependency.srcSubpass    = src;
+      dependency.dstSubpass    = static_cast<uint32_t>(dst);
+      dependency.srcStageMask  = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+      dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+      dependency.dstStageMask  = vk::PipelineStageFlagBits::eFragmentShader;
+      dependency.dstAccessMask = vk::AccessFlagBits::eInputAttachmentRead;
+      dependencies.emplace_back(dependency);
+    }
+  }
+
+  vk::RenderPassCreateInfo info;
+  info.attachmentCount = static_cast<uint32_t>(attachments.size());
+  info.pAttachments    = attachments.data();
+  info.subpassCount    = static_cast<uint32_t>(subpassInfos.size());
+  info.pSubpasses      = subpassInfos.data();
+  info.dependencyCount = static_cast<uint32_t>(dependencies.size());
+  info.pDependencies   = dependencies.data();
+
+  return device->createRenderPass(name, info);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void RenderPass::addAttachment(Attachment const& attachment) {
   // Make sure that extent is the same.
   if (!mAttachments.empty() &&
@@ -134,7 +241,6 @@ void RenderPass::clearSubpasses() {
 void RenderPass::createRenderPass() {
 
   std::vector<vk::AttachmentDescription> attachments;
-  std::vector<vk::AttachmentReference>   attachmentRefs;
 
   for (auto const& a : mAttachments) {
     vk::AttachmentDescription attachment;
@@ -145,80 +251,26 @@ void RenderPass::createRenderPass() {
     attachment.loadOp        = a.mLoadOp;
     attachment.storeOp       = a.mStoreOp;
 
-    vk::AttachmentReference attachmentRef;
-    attachmentRef.layout     = a.mFinalLayout;
-    attachmentRef.attachment = static_cast<uint32_t>(attachments.size());
-
     attachments.emplace_back(attachment);
-    attachmentRefs.emplace_back(attachmentRef);
   }
 
-  auto& subpasses = mSubpasses;
-
   // create default subpass if none are specified
-  std::vector<Subpass> defaultSubpass(1);
+  if (mSubpasses.empty()) {
+    Subpass defaultSubpass;
 
-  if (subpasses.empty()) {
     for (size_t i(0); i < attachments.size(); ++i) {
       if (Utils::isColorFormat(attachments[i].format)) {
-        defaultSubpass[0].mColorAttachments.push_back(i);
+        defaultSubpass.mColorAttachments.push_back(i);
       } else {
-        defaultSubpass[0].mDepthStencilAttachment = i;
+        defaultSubpass.mDepthStencilAttachment = i;
       }
     }
 
-    subpasses = defaultSubpass;
-  }
-
-  std::vector<vk::SubpassDescription>               subpassInfos(subpasses.size());
-  std::vector<std::vector<vk::AttachmentReference>> inputAttachmentRefs(subpasses.size());
-  std::vector<std::vector<vk::AttachmentReference>> colorAttachmentRefs(subpasses.size());
-
-  for (size_t i(0); i < subpasses.size(); ++i) {
-
-    for (uint32_t attachment : subpasses[i].mInputAttachments) {
-      inputAttachmentRefs[i].push_back(attachmentRefs[attachment]);
-    }
-
-    for (uint32_t attachment : subpasses[i].mColorAttachments) {
-      colorAttachmentRefs[i].push_back(attachmentRefs[attachment]);
-    }
-
-    if (subpasses[i].mDepthStencilAttachment) {
-      subpassInfos[i].pDepthStencilAttachment =
-          &attachmentRefs[*subpasses[i].mDepthStencilAttachment];
-    }
-
-    subpassInfos[i].pipelineBindPoint    = vk::PipelineBindPoint::eGraphics;
-    subpassInfos[i].inputAttachmentCount = static_cast<uint32_t>(inputAttachmentRefs[i].size());
-    subpassInfos[i].pInputAttachments    = inputAttachmentRefs[i].data();
-    subpassInfos[i].colorAttachmentCount = static_cast<uint32_t>(colorAttachmentRefs[i].size());
-    subpassInfos[i].pColorAttachments    = colorAttachmentRefs[i].data();
+    mSubpasses.push_back(defaultSubpass);
   }
 
-  std::vector<vk::SubpassDependency> dependencies;
-  for (size_t dst(0); dst < subpasses.size(); ++dst) {
-    for (auto src : subpasses[dst].mPreSubpasses) {
-      vk::SubpassDependency dependency;
-      dependency.srcSubpass    = src;
-      dependency.dstSubpass    = static_cast<uint32_t>(dst);
-      dependency.srcStageMask  = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-      dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-      dependency.dstStageMask  = vk::PipelineStageFlagBits::eFragmentShader;
-      dependency.dstAccessMask = vk::AccessFlagBits::eInputAttachmentRead;
-      dependencies.emplace_back(dependency);
-    }
-  }
-
-  vk::RenderPassCreateInfo info;
-  info.attachmentCount = static_cast<uint32_t>(attachments.size());
-  info.pAttachments    = attachments.data();
-  info.subpassCount    = static_cast<uint32_t>(subpassInfos.size());
-  info.pSubpasses      = subpassInfos.data();
-  info.dependencyCount = static_cast<uint32_t>(dependencies.size());
-  info.pDependencies   = dependencies.data();
-
-  mRenderPass = mDevice->createRenderPass(getName(), info);
+  mRenderPass        = createHandle(mDevice, getName(), attachments, mSubpasses);
+  mCompatibilityHash = getCompatibilityHash(attachments, mSubpasses);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
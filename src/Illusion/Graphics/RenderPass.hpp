@@ -78,6 +78,26 @@ class RenderPass : public Core::StaticCreate<RenderPass>, public Core::NamedObje
   // init() before.
   vk::RenderPassPtr const& getHandle() const;
 
+  // Returns a hash of everything which is relevant for render pass compatibility as defined by the
+  // Vulkan specification: The formats and sample counts of the attachments and the structure of
+  // the subpasses. Layouts, load and store operations and the extent are not included. Pipelines
+  // created for one render pass can be used with all render passes with the same hash, so the
+  // CommandBuffer uses this hash to identify its pipelines. This is updated by init().
+  Core::BitHash const& getCompatibilityHash() const;
+
+  // Computes the compatibility hash for a render pass with the given attachments and subpasses.
+  // Only the formats and sample counts of the attachments are used.
+  static Core::BitHash getCompatibilityHash(
+      std::vector<vk::AttachmentDescription> const& attachments,
+      std::vector<Subpass> const&                   subpasses);
+
+  // Creates a vk::RenderPass with the given attachments and subpasses. The subpass dependencies
+  // are derived from Subpass::mPreSubpasses. This is used by init(); the PipelineManifest uses it
+  // to create render passes which are compatible to those used when the manifest was recorded.
+  static vk::RenderPassPtr createHandle(DeviceConstPtr const& device, DebugName const& name,
+      std::vector<vk::AttachmentDescription> const& attachments,
+      std::vector<Subpass> const&                   subpasses);
+
   // attachment api --------------------------------------------------------------------------------
 
   // Adding an attachment with a size which differs from previously added attachments will throw a
@@ -109,6 +129,7 @@ class RenderPass : public Core::StaticCreate<RenderPass>, public Core::NamedObje
   vk::FramebufferPtr      mFramebuffer;
   std::vector<Attachment> mAttachments;
   std::vector<Subpass>    mSubpasses;
+  Core::BitHash           mCompatibilityHash;
 };
 
 } // namespace Illusion::Graphics
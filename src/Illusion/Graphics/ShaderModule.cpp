@@ -13,6 +13,7 @@
 #include "spirv.hpp"
 
 #include <SPIRV/GLSL.std.450.h>
+#include <atomic>
 #include <spirv_glsl.hpp>
 #include <utility>
 
@@ -27,6 +28,11 @@ namespace {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// This is incremented for each vk::ShaderModule which is created, see getHandleId().
+std::atomic<uint64_t> handleCounter{0};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 // Map spirv-types to Illusion's PipelineResource::BaseTypes.
 std::unordered_map<spirv_cross::SPIRType::BaseType, PipelineResource::BaseType>
     spirvTypeToBaseType = {
@@ -136,6 +142,13 @@ vk::ShaderModulePtr ShaderModule::getHandle() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+uint64_t ShaderModule::getHandleId() const {
+  reload();
+  return mHandleId;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 vk::ShaderStageFlagBits ShaderModule::getStage() const {
   reload();
   return mStage;
@@ -165,6 +178,7 @@ void ShaderModule::reload() const {
       info.codeSize = spirv.size() * 4;
       info.pCode    = spirv.data();
       mHandle       = mDevice->createShaderModule(getName(), info);
+      mHandleId     = ++handleCounter;
     } catch (std::runtime_error const& e) {
       Core::Logger::error() << "Shader reloading failed. " << e.what() << std::endl;
     }
@@ -41,6 +41,11 @@ class ShaderModule : public Core::StaticCreate<ShaderModule>, public Core::Named
   // happen when shader files are changed on disc.
   vk::ShaderModulePtr getHandle() const;
 
+  // Returns a number which identifies the current vk::ShaderModule. It changes with each reload and
+  // is unique among all ShaderModules of the application. In contrast to the address of the handle
+  // it is never reused, so it can be used to identify pipelines which were created with it.
+  uint64_t getHandleId() const;
+
   // Get the shader stage this module was constructed for.
   vk::ShaderStageFlagBits getStage() const;
 
@@ -58,6 +63,7 @@ class ShaderModule : public Core::StaticCreate<ShaderModule>, public Core::Named
 
   // lazy state ------------------------------------------------------------------------------------
   mutable vk::ShaderModulePtr           mHandle;
+  mutable uint64_t                      mHandleId = 0;
   mutable std::vector<PipelineResource> mResources;
 };
 
@@ -9,6 +9,7 @@
 #include "ShaderSource.hpp"
 
 #include "../Core/File.hpp"
+#include "../Core/FileWatcher.hpp"
 #include "../Core/Logger.hpp"
 
 #include <SPIRV/GlslangToSpv.h>
@@ -20,6 +21,7 @@
 #include <glslang/OSDependent/osinclude.h>
 #include <glslang/Public/ShaderLang.h>
 
+#include <string_view>
 #include <utility>
 
 namespace Illusion::Graphics {
@@ -72,17 +74,19 @@ class Includer : public DirStackFileIncluder {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-std::vector<uint32_t> compile(std::string const& code, std::string const& fileName,
+std::vector<uint32_t> compile(std::string_view code, std::string const& fileName,
     vk::ShaderStageFlagBits vkStage, EShMessages messages, std::vector<Core::File>& includedFiles) {
 
   glslang::InitializeProcess();
 
   auto        stage     = shaderStageMapping.at(vkStage);
-  const char* codes     = code.c_str();
+  const char* codes     = code.data();
+  const int   lengths   = static_cast<int>(code.size());
   const char* fileNames = fileName.c_str();
 
+  // The code is passed with its length, as a mapped file is not null-terminated.
   glslang::TShader shader(stage);
-  shader.setStringsWithLengthsAndNames(&codes, nullptr, &fileNames, 1);
+  shader.setStringsWithLengthsAndNames(&codes, &lengths, &fileNames, 1);
   shader.setEntryPoint("main");
   shader.setSourceEntryPoint("main");
   shader.setPreamble("#extension GL_GOOGLE_include_directive : require");
@@ -137,20 +141,39 @@ ShaderFile::ShaderFile(std::string const& fileName, bool reloadOnChanges)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool ShaderFile::isDirty() const {
-  if (mReloadOnChanges) {
+  return mDirty || (mChanged && mChanged->load(std::memory_order_relaxed));
+}
 
-    if (mFile.changedOnDisc()) {
-      mDirty |= true;
-    }
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> ShaderFile::getSpirv(vk::ShaderStageFlagBits stage) {
+  mDirty = false;
+
+  if (!mReloadOnChanges) {
+    return loadSpirv(stage);
+  }
 
+  // The file is watched before it is read, so that changes during compilation are not missed. The
+  // includes are only known afterwards. They are watched even if the compilation fails, as the
+  // error may be fixed in one of them.
+  auto& watcher = Core::FileWatcher::get();
+  mChanged      = std::make_shared<std::atomic_bool>(false);
+  watcher.watch(mFile.getFileName(), mChanged);
+
+  auto watchIncludes = [&]() {
     for (auto const& f : mIncludedFiles) {
-      if (f.changedOnDisc()) {
-        mDirty |= true;
-      }
+      watcher.watch(f.getFileName(), mChanged);
     }
+  };
+
+  try {
+    auto spirv = loadSpirv(stage);
+    watchIncludes();
+    return spirv;
+  } catch (...) {
+    watchIncludes();
+    throw;
   }
-
-  return mDirty;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -178,9 +201,9 @@ GlslFile::GlslFile(std::string const& fileName, bool reloadOnChanges)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-std::vector<uint32_t> GlslFile::getSpirv(vk::ShaderStageFlagBits stage) {
-  mDirty = false;
-  return compile(mFile.getContent<std::string>(), mFile.getFileName(), stage,
+std::vector<uint32_t> GlslFile::loadSpirv(vk::ShaderStageFlagBits stage) {
+  auto mapping = mFile.map();
+  return compile(mapping.getString(), mFile.getFileName(), stage,
       EShMessages(EShMsgSpvRules | EShMsgVulkanRules), mIncludedFiles);
 }
 
@@ -210,9 +233,9 @@ HlslFile::HlslFile(std::string const& fileName, bool reloadOnChanges)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-std::vector<uint32_t> HlslFile::getSpirv(vk::ShaderStageFlagBits stage) {
-  mDirty = false;
-  return compile(mFile.getContent<std::string>(), mFile.getFileName(), stage,
+std::vector<uint32_t> HlslFile::loadSpirv(vk::ShaderStageFlagBits stage) {
+  auto mapping = mFile.map();
+  return compile(mapping.getString(), mFile.getFileName(), stage,
       EShMessages(EShMsgSpvRules | EShMsgVulkanRules | EShMsgReadHlsl), mIncludedFiles);
 }
 
@@ -242,9 +265,10 @@ SpirvFile::SpirvFile(std::string const& fileName, bool reloadOnChanges)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-std::vector<uint32_t> SpirvFile::getSpirv(vk::ShaderStageFlagBits /*stage*/) {
-  mDirty = false;
-  return mFile.getContent<std::vector<uint32_t>>();
+std::vector<uint32_t> SpirvFile::loadSpirv(vk::ShaderStageFlagBits /*stage*/) {
+  auto mapping = mFile.map();
+  auto code    = mapping.getData<uint32_t>();
+  return std::vector<uint32_t>(code, code + mapping.getCount<uint32_t>());
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -13,6 +13,8 @@
 #include "../Core/StaticCreate.hpp"
 #include "fwd.hpp"
 
+#include <atomic>
+#include <memory>
 #include <variant>
 
 namespace Illusion::Graphics {
@@ -35,19 +37,31 @@ class ShaderSource {
 
 // -------------------------------------------------------------------------------------------------
 
-// This (abstract) derived class for file based sources handles the reloading of changed files.
+// This (abstract) derived class for file based sources handles the reloading of changed files. The
+// file and all of its includes are observed by the global Core::FileWatcher, so isDirty() is only
+// an atomic load and can be called as often as needed. Derived classes implement loadSpirv().
 class ShaderFile : public ShaderSource {
  public:
   ShaderFile(std::string const& fileName, bool reloadOnChanges);
-  bool isDirty() const override;
+
+  bool                  isDirty() const override;
+  std::vector<uint32_t> getSpirv(vk::ShaderStageFlagBits stage) final;
 
  protected:
+  // Reads the file and returns the Spir-V code. The included files have to be stored in
+  // mIncludedFiles.
+  virtual std::vector<uint32_t> loadSpirv(vk::ShaderStageFlagBits stage) = 0;
+
   Core::File mFile;
   bool       mReloadOnChanges;
 
   // lazy state
   mutable bool                    mDirty = true;
   mutable std::vector<Core::File> mIncludedFiles;
+
+  // This is set by the Core::FileWatcher when the file or one of its includes changes. A new flag
+  // is used for each load, the watches of the old flag expire together with it.
+  std::shared_ptr<std::atomic_bool> mChanged;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -74,7 +88,8 @@ class GlslFile : public ShaderFile, public Core::StaticCreate<GlslFile> {
  public:
   GlslFile(std::string const& fileName, bool reloadOnChanges = true);
 
-  std::vector<uint32_t> getSpirv(vk::ShaderStageFlagBits stage) override;
+ protected:
+  std::vector<uint32_t> loadSpirv(vk::ShaderStageFlagBits stage) override;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -92,7 +107,8 @@ class HlslFile : public ShaderFile, public Core::StaticCreate<HlslFile> {
  public:
   HlslFile(std::string const& fileName, bool reloadOnChanges = true);
 
-  std::vector<uint32_t> getSpirv(vk::ShaderStageFlagBits stage) override;
+ protected:
+  std::vector<uint32_t> loadSpirv(vk::ShaderStageFlagBits stage) override;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -110,7 +126,8 @@ class SpirvFile : public ShaderFile, public Core::StaticCreate<SpirvFile> {
  public:
   SpirvFile(std::string const& fileName, bool reloadOnChanges = true);
 
-  std::vector<uint32_t> getSpirv(vk::ShaderStageFlagBits stage) override;
+ protected:
+  std::vector<uint32_t> loadSpirv(vk::ShaderStageFlagBits stage) override;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -12,6 +12,23 @@ namespace Illusion::Graphics {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+SpecialisationState::SpecialisationState(SpecialisationState const& other)
+    : mValues(other.mValues) {
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SpecialisationState& SpecialisationState::operator=(SpecialisationState const& other) {
+  if (this != &other) {
+    mValues = other.mValues;
+    mDirty  = true;
+  }
+
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SpecialisationState::setIntegerConstant(uint32_t constantID, int32_t value) {
   set(constantID, *reinterpret_cast<uint32_t*>(&value));
 }
@@ -61,7 +78,7 @@ vk::SpecializationInfo const* SpecialisationState::getInfo() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Core::BitHash SpecialisationState::getHash() const {
+Core::BitHash const& SpecialisationState::getHash() const {
   update();
 
   return mHash;
@@ -69,6 +86,28 @@ Core::BitHash SpecialisationState::getHash() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void SpecialisationState::serialize(Core::BinaryWriter& writer) const {
+  writer.write<uint32_t>(static_cast<uint32_t>(mValues.size()));
+  for (auto const& value : mValues) {
+    writer.write(value.first);
+    writer.write(value.second);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SpecialisationState::deserialize(Core::BinaryReader& reader) {
+  reset();
+
+  auto count = reader.read<uint32_t>();
+  for (uint32_t i(0); i < count; ++i) {
+    auto constantID = reader.read<uint32_t>();
+    set(constantID, reader.read<uint32_t>());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SpecialisationState::set(uint32_t constantID, uint32_t value) {
   auto it = mValues.find(constantID);
   if (it != mValues.end() && it->second == value) {
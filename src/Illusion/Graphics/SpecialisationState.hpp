@@ -11,6 +11,7 @@
 
 #include "fwd.hpp"
 
+#include "../Core/BinaryStream.hpp"
 #include "../Core/BitHash.hpp"
 
 #include <map>
@@ -26,6 +27,13 @@ namespace Illusion::Graphics {
 
 class SpecialisationState {
  public:
+  SpecialisationState() = default;
+
+  // The vk::SpecializationInfo points to internal data, so copies only take the values and build
+  // their own vk::SpecializationInfo when needed.
+  SpecialisationState(SpecialisationState const& other);
+  SpecialisationState& operator=(SpecialisationState const& other);
+
   // Sets a scalar integer specialization constant to the given value. You have to ensure that the
   // specialization constant with this ID is actually of that type. Else undefined behavior awaits.
   void setIntegerConstant(uint32_t constantID, int32_t value);
@@ -51,7 +59,12 @@ class SpecialisationState {
 
   // Returns a hash to uniquely identify a set of specialization constants. This is used by the
   // CommandBuffer to determine whether a new vk::Pipeline has to be created.
-  Core::BitHash getHash() const;
+  Core::BitHash const& getHash() const;
+
+  // Writes all values so that they can be restored with deserialize(). This is used by the
+  // PipelineManifest. deserialize() throws a std::runtime_error if the data is incomplete.
+  void serialize(Core::BinaryWriter& writer) const;
+  void deserialize(Core::BinaryReader& reader);
 
  private:
   void set(uint32_t constantID, uint32_t value);
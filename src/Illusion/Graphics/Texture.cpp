@@ -9,6 +9,8 @@
 #include "Texture.hpp"
 
 #include "../Core/Logger.hpp"
+#include "../Core/MappedFile.hpp"
+#include "../Core/Profiler.hpp"
 #include "BackedBuffer.hpp"
 #include "CommandBuffer.hpp"
 #include "Device.hpp"
@@ -48,9 +50,27 @@ uint32_t Texture::getMaxMipmapLevels(uint32_t width, uint32_t height) {
 TexturePtr Texture::createFromFile(std::string const& name, DeviceConstPtr const& device,
     std::string const& fileName, vk::SamplerCreateInfo samplerInfo, bool generateMipmaps,
     vk::ComponentMapping const& componentMapping) {
+  ILLUSION_PROFILE_ZONE("Texture::createFromFile");
+
+  // Both gli and stb_image parse the file directly from the mapped memory.
+  Core::MappedFile mapping(fileName);
+  if (mapping.isEmpty()) {
+    throw std::runtime_error("Failed to load texture " + fileName + ": File is empty!");
+  }
+
+  return createFromMemory(name, device, mapping.getData(), mapping.getSize(), samplerInfo,
+      generateMipmaps, componentMapping);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TexturePtr Texture::createFromMemory(std::string const& name, DeviceConstPtr const& device,
+    void const* data, size_t size, vk::SamplerCreateInfo samplerInfo, bool generateMipmaps,
+    vk::ComponentMapping const& componentMapping) {
+  ILLUSION_PROFILE_ZONE("Texture::createFromMemory");
 
   // first try loading with gli
-  gli::texture texture(gli::load(fileName));
+  gli::texture texture(gli::load(static_cast<char const*>(data), size));
   if (!texture.empty()) {
 
     vk::ImageType     type;
@@ -64,7 +84,7 @@ TexturePtr Texture::createFromFile(std::string const& name, DeviceConstPtr const
       viewType = vk::ImageViewType::e3D;
     } else {
       throw std::runtime_error(
-          "Failed to load texture " + fileName + ": Unsupported texture target!");
+          "Failed to load texture " + name + ": Unsupported texture target!");
     }
 
     auto format(static_cast<vk::Format>(texture.format()));
@@ -112,18 +132,21 @@ TexturePtr Texture::createFromFile(std::string const& name, DeviceConstPtr const
 
   // then try stb_image
   int   width, height, components, bytes;
-  void* data;
+  void* pixels;
+
+  auto buffer = static_cast<stbi_uc const*>(data);
+  int  length = static_cast<int>(size);
 
-  if (stbi_is_hdr(fileName.c_str()) != 0) {
-    data  = stbi_loadf(fileName.c_str(), &width, &height, &components, 4);
-    bytes = 4;
+  if (stbi_is_hdr_from_memory(buffer, length) != 0) {
+    pixels = stbi_loadf_from_memory(buffer, length, &width, &height, &components, 4);
+    bytes  = 4;
   } else {
-    data  = stbi_load(fileName.c_str(), &width, &height, &components, 4);
-    bytes = 1;
+    pixels = stbi_load_from_memory(buffer, length, &width, &height, &components, 4);
+    bytes  = 1;
   }
 
-  if (data != nullptr) {
-    uint64_t size = width * height * bytes * 4;
+  if (pixels != nullptr) {
+    uint64_t pixelSize = width * height * bytes * 4;
 
     vk::Format format;
     if (bytes == 1) {
@@ -155,9 +178,9 @@ TexturePtr Texture::createFromFile(std::string const& name, DeviceConstPtr const
 
     auto result = device->createTexture(name, imageInfo, samplerInfo, vk::ImageViewType::e2D,
         vk::ImageAspectFlagBits::eColor, vk::ImageLayout::eShaderReadOnlyOptimal, componentMapping,
-        size, data);
+        pixelSize, pixels);
 
-    stbi_image_free(data);
+    stbi_image_free(pixels);
 
     if (generateMipmaps) {
       updateMipmaps(device, result);
@@ -168,7 +191,7 @@ TexturePtr Texture::createFromFile(std::string const& name, DeviceConstPtr const
 
   std::string error(stbi_failure_reason());
 
-  throw std::runtime_error("Failed to load texture " + fileName + ": " + error);
+  throw std::runtime_error("Failed to load texture " + name + ": " + error);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -176,6 +199,7 @@ TexturePtr Texture::createFromFile(std::string const& name, DeviceConstPtr const
 TexturePtr Texture::createCubemapFrom360PanoramaFile(std::string const& name,
     DeviceConstPtr const& device, std::string const& fileName, uint32_t size,
     vk::SamplerCreateInfo samplerInfo, bool generateMipmaps) {
+  ILLUSION_PROFILE_ZONE("Texture::createCubemapFrom360PanoramaFile");
 
   std::string glsl = R"(
     #version 450
@@ -257,7 +281,8 @@ TexturePtr Texture::createCubemapFrom360PanoramaFile(std::string const& name,
   auto outputCubemap = device->createTexture(name, imageInfo, samplerInfo, vk::ImageViewType::eCube,
       vk::ImageAspectFlagBits::eColor, vk::ImageLayout::eGeneral);
 
-  auto cmd = CommandBuffer::create("CommandBuffer for " + name, device, QueueType::eCompute);
+  auto cmd =
+      CommandBuffer::create(DebugName("CommandBuffer for ", name), device, QueueType::eCompute);
   cmd->bindingState().setTexture(panorama, 0, 0);
   cmd->bindingState().setStorageImage(outputCubemap, 0, 1);
 
@@ -281,6 +306,8 @@ TexturePtr Texture::createCubemapFrom360PanoramaFile(std::string const& name,
 
 TexturePtr Texture::createPrefilteredIrradianceCubemap(std::string const& name,
     DeviceConstPtr const& device, uint32_t size, TexturePtr const& inputCubemap) {
+  ILLUSION_PROFILE_ZONE("Texture::createPrefilteredIrradianceCubemap");
+
   std::string glsl = R"(
     #version 450
 
@@ -379,7 +406,8 @@ TexturePtr Texture::createPrefilteredIrradianceCubemap(std::string const& name,
   auto outputCubemap = device->createTexture(name, imageInfo, device->createSamplerInfo(),
       vk::ImageViewType::eCube, vk::ImageAspectFlagBits::eColor, vk::ImageLayout::eGeneral);
 
-  auto cmd = CommandBuffer::create("CommandBuffer for " + name, device, QueueType::eCompute);
+  auto cmd =
+      CommandBuffer::create(DebugName("CommandBuffer for ", name), device, QueueType::eCompute);
   cmd->bindingState().setTexture(inputCubemap, 0, 0);
   cmd->bindingState().setStorageImage(outputCubemap, 0, 1);
 
@@ -399,6 +427,8 @@ TexturePtr Texture::createPrefilteredIrradianceCubemap(std::string const& name,
 
 TexturePtr Texture::createPrefilteredReflectionCubemap(std::string const& name,
     DeviceConstPtr const& device, uint32_t size, TexturePtr const& inputCubemap) {
+  ILLUSION_PROFILE_ZONE("Texture::createPrefilteredReflectionCubemap");
+
   std::string glsl = R"(
     #version 450
 
@@ -563,7 +593,8 @@ TexturePtr Texture::createPrefilteredReflectionCubemap(std::string const& name,
   auto outputCubemap = device->createTexture(name, imageInfo, samplerInfo, vk::ImageViewType::eCube,
       vk::ImageAspectFlagBits::eColor, vk::ImageLayout::eGeneral);
 
-  auto cmd = CommandBuffer::create("CommandBuffer for " + name, device, QueueType::eCompute);
+  auto cmd =
+      CommandBuffer::create(DebugName("CommandBuffer for ", name), device, QueueType::eCompute);
   cmd->bindingState().setTexture(inputCubemap, 0, 0);
 
   cmd->begin();
@@ -577,7 +608,7 @@ TexturePtr Texture::createPrefilteredReflectionCubemap(std::string const& name,
     auto mipViewInfo                          = outputCubemap->mViewInfo;
     mipViewInfo.subresourceRange.baseMipLevel = i;
     mipViewInfo.subresourceRange.levelCount   = 1;
-    auto mipView = device->createImageView("ImageView for " + name, mipViewInfo);
+    auto mipView = device->createImageView(DebugName("ImageView for ", name), mipViewInfo);
 
     cmd->pushConstants(static_cast<float>(i));
     cmd->bindingState().setStorageImage(outputCubemap, mipView, 0, 1);
@@ -598,6 +629,7 @@ TexturePtr Texture::createPrefilteredReflectionCubemap(std::string const& name,
 
 TexturePtr Texture::createBRDFLuT(
     std::string const& name, DeviceConstPtr const& device, uint32_t size) {
+  ILLUSION_PROFILE_ZONE("Texture::createBRDFLuT");
 
   std::string glsl = R"(
     #version 450
@@ -725,7 +757,8 @@ TexturePtr Texture::createBRDFLuT(
   auto outputImage = device->createTexture(name, imageInfo, device->createSamplerInfo(),
       vk::ImageViewType::e2D, vk::ImageAspectFlagBits::eColor, vk::ImageLayout::eGeneral);
 
-  auto cmd = CommandBuffer::create("CommandBuffer for " + name, device, QueueType::eCompute);
+  auto cmd =
+      CommandBuffer::create(DebugName("CommandBuffer for ", name), device, QueueType::eCompute);
   cmd->bindingState().setStorageImage(outputImage, 0, 0);
 
   cmd->begin();
@@ -743,6 +776,7 @@ TexturePtr Texture::createBRDFLuT(
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void Texture::updateMipmaps(DeviceConstPtr const& device, TexturePtr const& texture) {
+  ILLUSION_PROFILE_ZONE("Texture::updateMipmaps");
 
   if (!formatSupportsLinearSampling(device, texture->mImageInfo.format)) {
     throw std::runtime_error(
@@ -36,6 +36,15 @@ struct Texture : public BackedImage {
       bool                        generateMipmaps  = true,
       vk::ComponentMapping const& componentMapping = vk::ComponentMapping());
 
+  // Same as above, but the file's content is given as a block of memory. This can be used together
+  // with the Core::FileLoader: The file is read on an I/O thread and decoded from the mapped memory
+  // afterwards. The name is used in error messages instead of a file name.
+  static TexturePtr createFromMemory(std::string const& name, DeviceConstPtr const& device,
+      void const* data, size_t size,
+      vk::SamplerCreateInfo       samplerInfo      = Device::createSamplerInfo(),
+      bool                        generateMipmaps  = true,
+      vk::ComponentMapping const& componentMapping = vk::ComponentMapping());
+
   // This will create a cubemap from an equirectangular panorama image. For example, you can
   // directly use the images from https://hdrihaven.com/ This is done with a compute shader.
   static TexturePtr createCubemapFrom360PanoramaFile(std::string const& name,
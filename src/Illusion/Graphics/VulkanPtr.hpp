@@ -9,8 +9,10 @@
 #ifndef ILLUSION_GRAPHICS_VULKAN_PTR_HPP
 #define ILLUSION_GRAPHICS_VULKAN_PTR_HPP
 
-#include <functional>
+#include "../Core/PoolAllocator.hpp"
+
 #include <memory>
+#include <utility>
 
 namespace Illusion::Graphics::VulkanPtr {
 
@@ -21,29 +23,50 @@ namespace Illusion::Graphics::VulkanPtr {
 // reference to the "parent" which is responsible for the destruction. This ensures that all      //
 // "children" will be deleted before the destructor of the "parent" is called.                    //
 // The Device class makes extenive use of this pattern, but it is also used in other classes.     //
+// Some Vulkan objects such as descriptor sets or command buffers are created very frequently.    //
+// Therefore the wrapped object, the deleter and the reference counts are stored in one single    //
+// memory block which is taken from a Core::BlockPool. Once the pool is warmed up, creating such  //
+// a std::shared_ptr does not allocate memory anymore.                                            //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Helper template
-template <typename T>
-struct Identity {
-  typedef T type;
+// The object which is actually stored in the pooled memory block. The deleter is called with a
+// pointer to the wrapped object when the last std::shared_ptr to it is released. The Vulkan object
+// is a base class, so a std::shared_ptr to the Holder can be converted to a std::shared_ptr to the
+// Vulkan object without an aliasing copy.
+template <typename T, typename Deleter>
+struct Holder : public T {
+  Holder(T const& object, Deleter&& deleter)
+      : T(object)
+      , mDeleter(std::move(deleter)) {
+  }
+
+  ~Holder() {
+    mDeleter(static_cast<T*>(this));
+  }
+
+  Holder(Holder const& other) = delete;
+  Holder& operator=(Holder const& other) = delete;
+
+  Deleter mDeleter;
 };
 
 // The function takes two arguments. The first is the Vulkan object to be wrapped, the second is the
 // deleter lambda which should capture a std::shared_ptr to the object which created the wrapped
-// object.
+// object. The deleter must not free the given pointer, this is done by the std::shared_ptr.
 // Here is an example how we could create a vk::Image, device is a std::shared_ptr to a vk::Device.
 //
 // vk::ImageCreateInfo info;
 // auto ptr = VulkanPtr::create(device->createImage(info), [device](vk::Image* obj) {
 //   device->destroyImage(*obj);
-//   delete obj;
 // });
 //
-template <typename T>
-std::shared_ptr<T> create(
-    T const& vkObject, typename Identity<std::function<void(T* obj)>>::type deleter) {
-  return std::shared_ptr<T>(new T{vkObject}, deleter);
+template <typename T, typename Deleter>
+std::shared_ptr<T> create(T const& vkObject, Deleter deleter) {
+  auto holder = std::allocate_shared<Holder<T, Deleter>>(
+      Core::PoolAllocator<Holder<T, Deleter>>(), vkObject, std::move(deleter));
+
+  // The holder is moved into the returned std::shared_ptr, so the reference count is not touched.
+  return std::shared_ptr<T>(std::move(holder));
 }
 
 } // namespace Illusion::Graphics::VulkanPtr
@@ -28,6 +28,8 @@ class FrameResourceIndex;
 class GlslShader;
 class Instance;
 class PhysicalDevice;
+class PipelineManifest;
+class PipelineObjectCache;
 class PipelineReflection;
 class RenderPass;
 class LazyRenderPass;
@@ -62,6 +64,10 @@ typedef std::shared_ptr<Instance>                      InstancePtr;
 typedef std::shared_ptr<const Instance>                InstanceConstPtr;
 typedef std::shared_ptr<PhysicalDevice>                PhysicalDevicePtr;
 typedef std::shared_ptr<const PhysicalDevice>          PhysicalDeviceConstPtr;
+typedef std::shared_ptr<PipelineManifest>              PipelineManifestPtr;
+typedef std::shared_ptr<const PipelineManifest>        PipelineManifestConstPtr;
+typedef std::shared_ptr<PipelineObjectCache>           PipelineObjectCachePtr;
+typedef std::shared_ptr<const PipelineObjectCache>     PipelineObjectCacheConstPtr;
 typedef std::shared_ptr<PipelineReflection>            PipelineReflectionPtr;
 typedef std::shared_ptr<const PipelineReflection>      PipelineReflectionConstPtr;
 typedef std::shared_ptr<RenderPass>                    RenderPassPtr;
@@ -120,7 +126,9 @@ typedef std::shared_ptr<const vk::Image>                  ImagePtr;
 typedef std::shared_ptr<const vk::ImageView>              ImageViewPtr;
 typedef std::shared_ptr<const vk::Instance>               InstancePtr;
 typedef std::shared_ptr<const vk::Pipeline>               PipelinePtr;
+typedef std::shared_ptr<const vk::PipelineCache>          PipelineCachePtr;
 typedef std::shared_ptr<const vk::PipelineLayout>         PipelineLayoutPtr;
+typedef std::shared_ptr<const vk::QueryPool>              QueryPoolPtr;
 typedef std::shared_ptr<const vk::RenderPass>             RenderPassPtr;
 typedef std::shared_ptr<const vk::Sampler>                SamplerPtr;
 typedef std::shared_ptr<const vk::Semaphore>              SemaphorePtr;
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/AnimationSystem.hpp>
+
+#include <doctest.h>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::AnimationSystem") {
+  AnimationSystem system;
+
+  SUBCASE("Checking easing curves") {
+    std::vector<Float> properties(5);
+
+    system.animate(properties[0], 10.f, 1.0, AnimationDirection::eLinear);
+    system.animate(properties[1], 10.f, 1.0, AnimationDirection::eIn);
+    system.animate(properties[2], 10.f, 1.0, AnimationDirection::eOut);
+    system.animate(properties[3], 10.f, 1.0, AnimationDirection::eInOut);
+    system.animate(properties[4], 10.f, 1.0, AnimationDirection::eOutIn);
+
+    CHECK(system.getAnimationCount() == 5);
+
+    // With an exponent of zero, the ease-in curve is t³.
+    system.update(0.25);
+    CHECK(properties[0].get() == doctest::Approx(2.5f));
+    CHECK(properties[1].get() == doctest::Approx(0.15625f));
+    CHECK(properties[2].get() == doctest::Approx(5.78125f));
+    CHECK(properties[3].get() == doctest::Approx(0.625f));
+    CHECK(properties[4].get() == doctest::Approx(4.375f));
+
+    system.update(0.5);
+    CHECK(properties[0].get() == doctest::Approx(7.5f));
+    CHECK(properties[1].get() == doctest::Approx(4.21875f));
+    CHECK(properties[2].get() == doctest::Approx(9.84375f));
+    CHECK(properties[3].get() == doctest::Approx(9.375f));
+    CHECK(properties[4].get() == doctest::Approx(5.625f));
+
+    // Finished animations are set exactly to their end value and removed.
+    system.update(0.5);
+    for (auto const& property : properties) {
+      CHECK(property.get() == 10.f);
+      CHECK(!system.isAnimated(property));
+    }
+
+    CHECK(system.getAnimationCount() == 0);
+  }
+
+  SUBCASE("Checking many animations") {
+    // Use a count which is not a multiple of the SIMD width.
+    std::vector<Float> properties(37);
+
+    for (size_t i(0); i < properties.size(); ++i) {
+      properties[i] = static_cast<float>(i);
+      system.animate(properties[i], i + 1.f, i + 1.0, AnimationDirection::eLinear);
+    }
+
+    system.update(0.5);
+
+    for (size_t i(0); i < properties.size(); ++i) {
+      CHECK(properties[i].get() == doctest::Approx(i + 0.5f / (i + 1.f)));
+    }
+
+    // Every second animation is stopped, the others have to continue properly.
+    for (size_t i(0); i < properties.size(); i += 2) {
+      CHECK(system.stop(properties[i]));
+    }
+
+    CHECK(!system.stop(properties[0]));
+    CHECK(system.getAnimationCount() == properties.size() / 2);
+
+    system.update(0.5);
+
+    for (size_t i(0); i < properties.size(); ++i) {
+      float expected = i % 2 == 0 ? i + 0.5f / (i + 1.f) : i + 1.f / (i + 1.f);
+      CHECK(properties[i].get() == doctest::Approx(expected));
+    }
+  }
+
+  SUBCASE("Checking delays and notifications") {
+    Float    property(1.f);
+    uint32_t changes = 0;
+
+    property.onChange().connect([&](float) {
+      ++changes;
+      return true;
+    });
+
+    system.animate(property, 2.f, 1.0, AnimationDirection::eLinear, AnimationLoop::eNone, 0.0, 1.0);
+
+    // During the delay, the Property is not touched at all.
+    system.update(0.5);
+    system.update(0.5);
+    CHECK(property.get() == 1.f);
+    CHECK(changes == 0);
+
+    system.update(0.5);
+    CHECK(property.get() == doctest::Approx(1.5f));
+    CHECK(changes == 1);
+
+    // Replacing the animation starts from the current value.
+    system.animate(property, 0.5f, 1.0, AnimationDirection::eLinear);
+    CHECK(system.getAnimationCount() == 1);
+
+    system.update(0.5);
+    CHECK(property.get() == doctest::Approx(1.f));
+    CHECK(changes == 2);
+  }
+
+  SUBCASE("Checking loops") {
+    Float repeat(0.f);
+    Float toggle(0.f);
+
+    system.animate(repeat, 1.f, 1.0, AnimationDirection::eLinear, AnimationLoop::eRepeat);
+    system.animate(toggle, 1.f, 1.0, AnimationDirection::eLinear, AnimationLoop::eToggle);
+
+    system.update(1.0);
+    CHECK(repeat.get() == 0.f);
+    CHECK(toggle.get() == 1.f);
+
+    system.update(0.25);
+    CHECK(repeat.get() == doctest::Approx(0.25f));
+    CHECK(toggle.get() == doctest::Approx(0.75f));
+
+    CHECK(system.getAnimationCount() == 2);
+
+    system.clear();
+    CHECK(system.getAnimationCount() == 0);
+  }
+
+  SUBCASE("Modifying animations from signal handlers") {
+    Float first(0.f);
+    Float second(0.f);
+
+    // When the first animation changes its value, the second is stopped and the first is restarted.
+    first.onChange().connect([&](float value) {
+      if (value == 1.f) {
+        system.stop(second);
+        system.animate(first, 0.f, 1.0, AnimationDirection::eLinear);
+      }
+      return true;
+    });
+
+    system.animate(first, 1.f, 1.0, AnimationDirection::eLinear);
+    system.animate(second, 1.f, 2.0, AnimationDirection::eLinear);
+
+    system.update(1.0);
+    CHECK(first.get() == 1.f);
+    CHECK(second.get() == doctest::Approx(0.5f));
+    CHECK(system.isAnimated(first));
+    CHECK(!system.isAnimated(second));
+
+    system.update(0.5);
+    CHECK(first.get() == doctest::Approx(0.5f));
+    CHECK(second.get() == doctest::Approx(0.5f));
+  }
+}
+
+} // namespace Illusion::Core
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/BinaryStream.hpp>
+
+#include <doctest.h>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::BinaryStream") {
+  BinaryWriter writer;
+
+  SUBCASE("Reading written values") {
+    writer.write<uint32_t>(42);
+    writer.write(-1.5f);
+    writer.write(std::string("Foo Bar"));
+    writer.write(std::vector<uint16_t>{1, 2, 3});
+    writer.write(std::string());
+
+    auto const&  data = writer.getData();
+    BinaryReader reader(data.data(), data.size());
+
+    CHECK(reader.read<uint32_t>() == 42);
+    CHECK(reader.read<float>() == -1.5f);
+    CHECK(reader.read<std::string>() == "Foo Bar");
+    CHECK(reader.read<std::vector<uint16_t>>() == std::vector<uint16_t>{1, 2, 3});
+    CHECK(reader.read<std::string>().empty());
+    CHECK(reader.isAtEnd());
+  }
+
+  SUBCASE("Reading beyond the end") {
+    writer.write<uint16_t>(42);
+
+    auto const&  data = writer.getData();
+    BinaryReader reader(data.data(), data.size());
+
+    CHECK_THROWS_AS(reader.read<uint32_t>(), std::runtime_error);
+  }
+
+  SUBCASE("Reading corrupt sizes") {
+    // The size is read first, so no memory should be allocated for this.
+    writer.write<uint32_t>(0xffffffff);
+    writer.write<uint32_t>(0);
+
+    auto const&  data = writer.getData();
+    BinaryReader reader(data.data(), data.size());
+
+    CHECK_THROWS_AS(reader.read<std::vector<uint64_t>>(), std::runtime_error);
+  }
+}
+
+} // namespace Illusion::Core
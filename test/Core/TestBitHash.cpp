@@ -10,6 +10,8 @@
 
 #include <doctest.h>
 
+#include <unordered_set>
+
 namespace Illusion::Core {
 
 TEST_CASE("Illusion::Core::BitHash") {
@@ -19,6 +21,67 @@ TEST_CASE("Illusion::Core::BitHash") {
     hash.push<32>(42);
     CHECK(hash.size() == 32);
   }
+
+  SUBCASE("Pushing bits across word boundaries") {
+    for (uint32_t i(0); i < 10; ++i) {
+      hash.push<7>(i);
+    }
+    hash.push<64>(uint64_t(-1));
+    CHECK(hash.size() == 134);
+
+    // The same values pushed in a different way must result in an equal BitHash.
+    BitHash other;
+    BitHash first;
+    BitHash second;
+    for (uint32_t i(0); i < 5; ++i) {
+      first.push<7>(i);
+    }
+    for (uint32_t i(5); i < 10; ++i) {
+      second.push<7>(i);
+    }
+    second.push<32>(uint32_t(-1));
+    second.push<32>(uint32_t(-1));
+    other.push(first);
+    other.push(second);
+
+    CHECK(other == hash);
+    CHECK(other.getDigest() == hash.getDigest());
+    CHECK(std::hash<BitHash>()(other) == std::hash<BitHash>()(hash));
+  }
+
+  SUBCASE("Comparing BitHashes") {
+    BitHash other;
+
+    // Only the given number of bits is used.
+    hash.push<4>(0xff);
+    other.push<4>(0x0f);
+    CHECK(hash == other);
+
+    // Hashes of different length are not equal, even if all bits are zero.
+    hash.push<3>(0);
+    CHECK(hash != other);
+    CHECK(other < hash);
+
+    other.push<3>(1);
+    CHECK(hash != other);
+    CHECK(hash.getDigest() != other.getDigest());
+
+    hash.clear();
+    CHECK(hash.empty());
+    CHECK(hash == BitHash());
+  }
+
+  SUBCASE("Using BitHashes in unordered containers") {
+    std::unordered_set<BitHash> set;
+
+    for (uint32_t i(0); i < 100; ++i) {
+      hash.push<1>(i % 3 == 0);
+      set.insert(hash);
+    }
+
+    CHECK(set.size() == 100);
+    CHECK(set.count(hash) == 1);
+  }
 }
 
 } // namespace Illusion::Core
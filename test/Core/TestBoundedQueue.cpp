@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/BoundedQueue.hpp>
+
+#include <doctest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::BoundedQueue") {
+
+  SUBCASE("Single threaded push and pop") {
+    BoundedQueue<int> queue(5);
+    CHECK(queue.getCapacity() == 8);
+    CHECK(queue.isEmptyHint());
+
+    for (int i(0); i < 8; ++i) {
+      CHECK(queue.tryPush(i));
+    }
+
+    // The queue is full now.
+    CHECK(!queue.tryPush(8));
+    CHECK(queue.getSizeHint() == 8);
+
+    // The values are returned in FIFO order.
+    int value = -1;
+    for (int i(0); i < 8; ++i) {
+      CHECK(queue.tryPop(value));
+      CHECK(value == i);
+    }
+
+    CHECK(!queue.tryPop(value));
+    CHECK(queue.isEmptyHint());
+  }
+
+  SUBCASE("Failed pushes do not consume the value") {
+    BoundedQueue<std::unique_ptr<int>> queue(2);
+    CHECK(queue.tryPush(std::make_unique<int>(0)));
+    CHECK(queue.tryPush(std::make_unique<int>(1)));
+
+    auto value = std::make_unique<int>(2);
+    CHECK(!queue.tryPush(std::move(value)));
+    CHECK(value);
+
+    BoundedQueue<std::string> strings(2);
+    std::string               text("This string is too long for the small string optimization.");
+    CHECK(strings.tryPush(text));
+    CHECK(strings.tryPush(std::move(text)));
+
+    text = "Not pushed";
+    CHECK(!strings.tryPush(std::move(text)));
+    CHECK(text == "Not pushed");
+
+    std::string result;
+    CHECK(strings.tryPop(result));
+    CHECK(result == "This string is too long for the small string optimization.");
+  }
+
+  SUBCASE("Bulk push and pop") {
+    BoundedQueue<int> queue(8);
+    std::vector<int>  input{0, 1, 2, 3, 4, 5};
+    std::vector<int>  output(6);
+
+    CHECK(queue.tryPush(input.data(), 6) == 6);
+
+    // There is space for two more values only.
+    CHECK(queue.tryPush(input.data(), 6) == 2);
+
+    CHECK(queue.tryPop(output.data(), 4) == 4);
+    CHECK(output[0] == 0);
+    CHECK(output[3] == 3);
+
+    // Now the ring buffer wraps around.
+    CHECK(queue.tryPush(input.data(), 6) == 4);
+    CHECK(queue.getSizeHint() == 8);
+
+    std::vector<int> all(16);
+    CHECK(queue.tryPop(all.data(), 16) == 8);
+    CHECK(all == std::vector<int>{4, 5, 0, 1, 0, 1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0});
+  }
+
+  SUBCASE("Multiple producers and consumers") {
+    BoundedQueue<uint64_t> queue(64);
+
+    const uint32_t producerCount = 4;
+    const uint32_t consumerCount = 4;
+    const uint64_t valueCount    = 10000;
+
+    std::vector<std::thread> threads;
+    std::vector<uint64_t>    sums(consumerCount);
+
+    // Each producer pushes the values 1 to valueCount; half of them in bulk.
+    for (uint32_t p(0); p < producerCount; ++p) {
+      threads.emplace_back([&]() {
+        for (uint64_t i(1); i <= valueCount; i += 2) {
+          queue.push(i);
+
+          uint64_t next = i + 1;
+          while (queue.tryPush(&next, 1) == 0) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    // Each consumer pops the same number of values, some of them in bulk.
+    for (uint32_t c(0); c < consumerCount; ++c) {
+      threads.emplace_back([&, c]() {
+        uint64_t popped = 0;
+        while (popped < valueCount) {
+          uint64_t values[4];
+          size_t   count = queue.tryPop(values, std::min<uint64_t>(4, valueCount - popped));
+
+          if (count == 0) {
+            queue.pop(values[0]);
+            count = 1;
+          }
+
+          for (size_t i(0); i < count; ++i) {
+            sums[c] += values[i];
+          }
+
+          popped += count;
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    uint64_t sum = 0;
+    for (auto s : sums) {
+      sum += s;
+    }
+
+    CHECK(sum == producerCount * valueCount * (valueCount + 1) / 2);
+    CHECK(queue.isEmptyHint());
+  }
+}
+
+} // namespace Illusion::Core
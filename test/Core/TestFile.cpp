@@ -9,7 +9,11 @@
 #include <Illusion/Core/File.hpp>
 
 #include <doctest.h>
+#include <algorithm>
+#include <atomic>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 namespace Illusion::Core {
 
@@ -89,6 +93,90 @@ TEST_CASE("Illusion::Core::File") {
     // Which should make it invalid again.
     CHECK(testFile.isValid() == false);
   }
+
+  SUBCASE("Map files") {
+    // Redirect cout to a ostringstream as we want to generate a warning with the next call.
+    std::ostringstream oss;
+    auto               coutBuffer = std::cout.rdbuf();
+    std::cout.rdbuf(oss.rdbuf());
+
+    // Mapping a non-existent file should result in an empty mapping.
+    testFile.setFileName("/invalid/invalid.txt");
+    auto invalid = testFile.map();
+
+    // Restore normal cout behavior.
+    std::cout.rdbuf(coutBuffer);
+
+    CHECK(oss.str() != "");
+    CHECK(invalid.isEmpty());
+    CHECK(invalid.getData() == nullptr);
+    CHECK_THROWS_AS(MappedFile("/invalid/invalid.txt"), std::runtime_error);
+
+    // Now we write some 32 bit words.
+    testFile.setFileName("testFile.bin");
+    std::vector<uint32_t> write = {0x07230203, 42, 43, 44};
+    testFile.save(write);
+
+    auto mapping = testFile.map();
+    CHECK(mapping.getSize() == write.size() * sizeof(uint32_t));
+    CHECK(mapping.getCount<uint32_t>() == write.size());
+    CHECK(std::equal(write.begin(), write.end(), mapping.getData<uint32_t>()));
+    CHECK(!testFile.changedOnDisc());
+
+    // The mapping can be moved, the data stays at the same address.
+    auto const* data  = mapping.getData();
+    MappedFile  moved = std::move(mapping);
+    CHECK(mapping.isEmpty());
+    CHECK(moved.getData() == data);
+
+    // Empty files result in an empty mapping without a warning.
+    testFile.save(std::string());
+    CHECK(MappedFile(testFile.getFileName()).isEmpty());
+
+    // Text files can be accessed as a string_view.
+    testFile.save(std::string("Foo Bar"));
+    CHECK(testFile.map().getString() == "Foo Bar");
+
+    testFile.remove();
+  }
+
+  SUBCASE("Save files atomically") {
+    testFile.setFileName("testFile.txt");
+    testFile.save(std::string("Foo"));
+
+    // The old content is replaced.
+    CHECK(testFile.saveAtomic(std::string("Foo Bar")));
+    CHECK(testFile.getContent<std::string>() == "Foo Bar");
+
+    // Concurrent saves use different temporary files, so the result is one of the saved contents.
+    std::vector<std::thread> threads;
+    std::atomic_uint         failures = 0;
+    for (char c : {'a', 'b', 'c', 'd'}) {
+      threads.emplace_back([&testFile, &failures, c]() {
+        for (int i(0); i < 20; ++i) {
+          if (!testFile.saveAtomic(std::string(10000, c))) {
+            ++failures;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    CHECK(failures == 0u);
+    auto content = testFile.getContent<std::string>();
+    CHECK(content.size() == 10000);
+    CHECK(content == std::string(10000, content[0]));
+
+    // Renaming makes the instance point to the new file.
+    CHECK(testFile.rename("testFileRenamed.txt"));
+    CHECK(testFile.getFileName() == "testFileRenamed.txt");
+    CHECK(testFile.getContent<std::string>() == content);
+    CHECK(!File("testFile.txt").isValid());
+
+    testFile.remove();
+  }
 }
 
 } // namespace Illusion::Core
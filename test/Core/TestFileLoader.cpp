@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/File.hpp>
+#include <Illusion/Core/FileLoader.hpp>
+
+#include <doctest.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::FileLoader") {
+  File file("testFileLoader.txt");
+  file.save(std::string("Foo Bar"));
+
+  FileLoader loader;
+
+  SUBCASE("Loading files") {
+    auto request = loader.load(file.getFileName());
+    auto invalid = loader.load("/invalid/invalid.txt");
+
+    CHECK(request.mFile.get().getString() == "Foo Bar");
+    CHECK_THROWS_AS(invalid.mFile.get(), std::runtime_error);
+    CHECK(loader.getPendingCount() == 0);
+  }
+
+#if !defined(_WIN32)
+  SUBCASE("Prioritizing and cancelling requests") {
+    // Opening a named pipe for reading blocks until someone opens it for writing. We use this to
+    // keep the I/O thread busy while we modify the queue.
+    std::string pipes[] = {"testFileLoader.fifo0", "testFileLoader.fifo1"};
+    for (auto const& pipe : pipes) {
+      mkfifo(pipe.c_str(), 0600);
+    }
+
+    auto unblock = [](std::string const& pipe) { close(open(pipe.c_str(), O_WRONLY)); };
+
+    auto waitForPendingCount = [&](size_t count) {
+      while (loader.getPendingCount() != count) {
+        std::this_thread::yield();
+      }
+    };
+
+    auto blocker = loader.load(pipes[0]);
+    waitForPendingCount(0);
+
+    auto low       = loader.load(file.getFileName(), 0);
+    auto high      = loader.load(pipes[1], 10);
+    auto cancelled = loader.load(file.getFileName(), 5);
+    CHECK(loader.getPendingCount() == 3);
+
+    // The blocker has already been picked up by the I/O thread.
+    CHECK(!loader.cancel(blocker));
+    CHECK(loader.cancel(cancelled));
+    CHECK_THROWS_AS(cancelled.mFile.get(), std::runtime_error);
+
+    // The high-priority request has to be processed before the low-priority request, so the I/O
+    // thread will block again.
+    unblock(pipes[0]);
+    CHECK(blocker.mFile.get().isEmpty());
+
+    waitForPendingCount(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(loader.getPendingCount() == 1);
+    CHECK(low.mFile.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+
+    CHECK(loader.setPriority(low, 20));
+    CHECK(!loader.setPriority(high, 20));
+
+    unblock(pipes[1]);
+    CHECK(high.mFile.get().isEmpty());
+    CHECK(low.mFile.get().getString() == "Foo Bar");
+
+    for (auto const& pipe : pipes) {
+      std::remove(pipe.c_str());
+    }
+  }
+#endif
+
+  file.remove();
+}
+
+} // namespace Illusion::Core
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/File.hpp>
+#include <Illusion/Core/FileWatcher.hpp>
+
+#include <doctest.h>
+
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Illusion::Core {
+
+namespace {
+
+// The FileWatcher sets the flags asynchronously, so we have to wait a bit. This returns false if
+// the flag has not been set within a few seconds.
+bool waitFor(std::atomic_bool const& flag) {
+  for (int i(0); i < 5000 && !flag; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return flag;
+}
+
+} // namespace
+
+TEST_CASE("Illusion::Core::FileWatcher") {
+  File file("testFileWatcher.txt");
+  file.save(std::string("Foo"));
+
+  SUBCASE("Detecting changes with inotify") {
+    FileWatcher watcher(FileWatcher::Mode::eNative, std::chrono::milliseconds(10));
+
+#if defined(__linux__)
+    CHECK(watcher.getMode() == FileWatcher::Mode::eNative);
+#endif
+
+    auto flag = std::make_shared<std::atomic_bool>(false);
+    watcher.watch(file.getFileName(), flag);
+    watcher.watch(file.getFileName(), flag);
+    CHECK(watcher.getWatchCount() == 1);
+
+    // Writing another file in the same directory must not set the flag.
+    File other("testFileWatcherOther.txt");
+    other.save(std::string("Bar"));
+    other.remove();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!*flag);
+
+    // Then we modify the watched file.
+    file.save(std::string("Bar"));
+    CHECK(waitFor(*flag));
+
+    // Once the flag is released, the file is not watched anymore.
+    flag.reset();
+    watcher.watch(other.getFileName(), std::make_shared<std::atomic_bool>(false));
+    CHECK(watcher.getWatchCount() == 0);
+  }
+
+  SUBCASE("Detecting changes by polling") {
+    FileWatcher watcher(FileWatcher::Mode::ePolling, std::chrono::milliseconds(10));
+    CHECK(watcher.getMode() == FileWatcher::Mode::ePolling);
+
+    auto flag = std::make_shared<std::atomic_bool>(false);
+    watcher.watch(file.getFileName(), flag);
+
+    // The last write time has a resolution of one second, so we remove the file instead of
+    // modifying it.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!*flag);
+
+    file.remove();
+    CHECK(waitFor(*flag));
+  }
+
+  SUBCASE("Watching files in non-existent directories") {
+    FileWatcher watcher(FileWatcher::Mode::eNative, std::chrono::milliseconds(10));
+
+    auto flag = std::make_shared<std::atomic_bool>(false);
+    watcher.watch("/invalid/invalid.txt", flag);
+    CHECK(watcher.getWatchCount() == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!*flag);
+  }
+
+#if defined(__linux__)
+  SUBCASE("Watching a directory under several names") {
+    FileWatcher watcher(FileWatcher::Mode::eNative, std::chrono::milliseconds(10));
+
+    mkdir("testFileWatcherDir", 0755);
+    File nested("testFileWatcherDir/testFileWatcher.txt");
+    nested.save(std::string("Foo"));
+
+    auto flag  = std::make_shared<std::atomic_bool>(false);
+    auto alias = std::make_shared<std::atomic_bool>(false);
+    watcher.watch("testFileWatcherDir/testFileWatcher.txt", flag);
+    watcher.watch("./testFileWatcherDir/testFileWatcher.txt", alias);
+
+    // Removing the directory notifies both names. Afterwards, the files are polled.
+    nested.remove();
+    rmdir("testFileWatcherDir");
+    CHECK(waitFor(*flag));
+    CHECK(waitFor(*alias));
+
+    // Once the directory has been created again, it is watched with inotify again. A new file in
+    // it must not use the watch of the removed directory.
+    mkdir("testFileWatcherDir", 0755);
+    auto other = std::make_shared<std::atomic_bool>(false);
+    watcher.watch("./testFileWatcherDir/testFileWatcherOther.txt", other);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    File otherFile("testFileWatcherDir/testFileWatcherOther.txt");
+    otherFile.save(std::string("Bar"));
+    CHECK(waitFor(*other));
+
+    otherFile.remove();
+    rmdir("testFileWatcherDir");
+  }
+#endif
+
+  file.remove();
+}
+
+} // namespace Illusion::Core
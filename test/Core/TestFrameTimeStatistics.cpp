@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/FrameTimeStatistics.hpp>
+
+#include <doctest.h>
+
+#include <sstream>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::FrameTimeStatistics") {
+  FrameTimeStatistics<100> statistics;
+
+  SUBCASE("Checking percentiles") {
+    // 1ms, 2ms, ... 100ms
+    for (int i(1); i <= 100; ++i) {
+      statistics.add(i * 0.001);
+    }
+
+    // The reported values may be up to 6.25% larger than the actual frame times.
+    CHECK(statistics.pP50.get() >= 0.050);
+    CHECK(statistics.pP50.get() <= 0.050 * 1.0625);
+    CHECK(statistics.pP95.get() >= 0.095);
+    CHECK(statistics.pP95.get() <= 0.095 * 1.0625);
+    CHECK(statistics.pP99.get() >= 0.099);
+    CHECK(statistics.pP99.get() <= 0.099 * 1.0625);
+    CHECK(statistics.pMax.get() == 0.1);
+    CHECK(statistics.getPercentile(0.5) == statistics.pP50.get());
+
+    // Small values are exact to the microsecond.
+    for (int i(1); i < 16; ++i) {
+      statistics.reset();
+      statistics.add(i * 0.000001);
+      CHECK(statistics.pP50.get() == i * 0.000001);
+    }
+  }
+
+  SUBCASE("Checking the sliding window") {
+    statistics.add(1.0);
+    for (int i(0); i < 99; ++i) {
+      statistics.add(0.01);
+    }
+    CHECK(statistics.pMax.get() == 1.0);
+    CHECK(statistics.pP99.get() >= 0.01);
+    CHECK(statistics.pP99.get() <= 0.01 * 1.0625);
+
+    // Now the long frame drops out of the window.
+    statistics.add(0.02);
+    CHECK(statistics.pMax.get() == 0.02);
+
+    for (int i(0); i < 100; ++i) {
+      statistics.add(0.005);
+    }
+    CHECK(statistics.pMax.get() == 0.005);
+    CHECK(statistics.pP50.get() <= 0.005 * 1.0625);
+    CHECK(statistics.getFrameCount() == 201);
+  }
+
+  SUBCASE("Checking hitches") {
+    statistics.pHitchThreshold = 0.05;
+    statistics.add(0.01);
+    statistics.add(0.06);
+    statistics.add(0.04);
+    statistics.add(0.1);
+    CHECK(statistics.pHitches.get() == 2);
+
+    statistics.reset();
+    CHECK(statistics.pHitches.get() == 0);
+    CHECK(statistics.pMax.get() == 0.0);
+  }
+
+  SUBCASE("Checking CSV output") {
+    std::stringstream stream;
+    FrameTimeStatistics<100>::printCSVHeader(stream);
+    statistics.add(0.1);
+    statistics.printCSV(stream);
+
+    std::string header, line;
+    std::getline(stream, header);
+    std::getline(stream, line);
+    CHECK(header == "frame,frameTime,p50,p95,p99,max,hitches");
+    CHECK(line.find("1,0.1,") == 0);
+    CHECK(line.substr(line.rfind(',')) == ",1");
+  }
+}
+
+} // namespace Illusion::Core
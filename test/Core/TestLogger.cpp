@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/Logger.hpp>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace Illusion::Core {
+
+namespace {
+// Returns the number of lines in the given file which start with the given string.
+uint32_t countLines(std::string const& fileName, std::string const& start) {
+  std::ifstream file(fileName);
+  std::string   line;
+  uint32_t      count = 0;
+  while (std::getline(file, line)) {
+    if (line.compare(0, start.size(), start) == 0) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// A thread-safe stream buffer which counts the written line breaks.
+class LineCounter : public std::streambuf {
+ public:
+  int overflow(int c) override {
+    if (c == '\n') {
+      ++mLines;
+    }
+    return c;
+  }
+
+  std::streamsize xsputn(char const* s, std::streamsize count) override {
+    mLines += static_cast<uint32_t>(std::count(s, s + count, '\n'));
+    return count;
+  }
+
+  std::atomic_uint mLines{0};
+};
+} // namespace
+
+TEST_CASE("Illusion::Core::Logger") {
+  const std::string fileName    = "TestLogger.log";
+  const uint32_t    threadCount = 4;
+  const uint32_t    lineCount   = 1000;
+
+  bool enableColorOutput    = Logger::enableColorOutput;
+  Logger::enableColorOutput = false;
+
+  auto logFromThreads = [&]() {
+    std::vector<std::thread> threads;
+    for (uint32_t t(0); t < threadCount; ++t) {
+      threads.emplace_back([t]() {
+        for (uint32_t i(0); i < lineCount; ++i) {
+          Logger::message() << "Thread " << t << " line " << i << std::endl;
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  SUBCASE("Asynchronous output with blocking policy") {
+    Logger::enableAsyncOutput(16, Logger::OverflowPolicy::eBlock, fileName);
+    logFromThreads();
+    Logger::flushAsyncOutput();
+    CHECK(Logger::getDroppedMessages() == 0);
+    Logger::disableAsyncOutput();
+
+    CHECK(countLines(fileName, "[ILLUSION][M] Thread") == threadCount * lineCount);
+  }
+
+  SUBCASE("Asynchronous output with dropping policy") {
+    Logger::enableAsyncOutput(16, Logger::OverflowPolicy::eDrop, fileName);
+    logFromThreads();
+    Logger::flushAsyncOutput();
+    uint64_t dropped = Logger::getDroppedMessages();
+    Logger::disableAsyncOutput();
+
+    // Each line has either been written or dropped.
+    CHECK(countLines(fileName, "[ILLUSION][M] Thread") + dropped == threadCount * lineCount);
+  }
+
+  SUBCASE("Disabling asynchronous output while other threads are logging") {
+    // Lines which are logged after the asynchronous output has been disabled are written to
+    // std::cout directly. We count them in order to make sure that no line is lost.
+    LineCounter captured;
+    auto        coutBuffer = std::cout.rdbuf(&captured);
+
+    Logger::enableAsyncOutput(16, Logger::OverflowPolicy::eBlock, fileName);
+    std::thread logger(logFromThreads);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    Logger::disableAsyncOutput();
+    logger.join();
+
+    std::cout.rdbuf(coutBuffer);
+
+    uint32_t writtenLines = countLines(fileName, "[ILLUSION][M] Thread");
+    CHECK(writtenLines + captured.mLines == threadCount * lineCount);
+  }
+
+  SUBCASE("Lazy evaluation of the logging macros") {
+    uint32_t evaluations = 0;
+    auto     getName     = [&]() {
+      ++evaluations;
+      return std::string("Object");
+    };
+
+    bool enableTrace     = Logger::enableTrace;
+    bool enableMessage   = Logger::enableMessage;
+    Logger::enableTrace   = false;
+    Logger::enableMessage = false;
+
+    ILLUSION_TRACE_CREATION("Test", getName());
+    ILLUSION_TRACE_DELETION("Test", getName());
+    ILLUSION_TRACE << getName() << std::endl;
+    ILLUSION_MESSAGE << getName() << std::endl;
+    CHECK(evaluations == 0);
+
+    // Enabled levels are evaluated, unless they are stripped at compile time.
+    Logger::enableTrace   = true;
+    Logger::enableMessage = true;
+
+    ILLUSION_TRACE_CREATION("Test", getName());
+    CHECK(evaluations == (ILLUSION_MIN_LOG_LEVEL <= 0 ? 1 : 0));
+
+    evaluations = 0;
+    ILLUSION_MESSAGE << getName() << std::endl;
+    CHECK(evaluations == (ILLUSION_MIN_LOG_LEVEL <= 2 ? 1 : 0));
+
+    Logger::enableTrace   = enableTrace;
+    Logger::enableMessage = enableMessage;
+  }
+
+  std::remove(fileName.c_str());
+  Logger::enableColorOutput = enableColorOutput;
+}
+
+} // namespace Illusion::Core
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/ParallelFor.hpp>
+
+#include <doctest.h>
+#include <functional>
+#include <numeric>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::ParallelFor") {
+  ThreadPool pool(4, ThreadPool::Scheduling::eWorkStealing);
+
+  SUBCASE("Each index is visited exactly once") {
+    std::vector<uint32_t> visits(10000, 0);
+    parallelFor(pool, 0, visits.size(), [&](size_t i) { ++visits[i]; });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](uint32_t v) { return v == 1; }));
+  }
+
+  SUBCASE("Sub-ranges respect the grain size") {
+    std::atomic_uint elements = 0;
+    std::atomic_bool tooLarge = false;
+    parallelForRange(pool, 10, 1000,
+        [&](size_t begin, size_t end) {
+          elements += end - begin;
+          tooLarge = tooLarge || (end - begin > 7);
+        },
+        7);
+    CHECK(elements == 990u);
+    CHECK(!tooLarge);
+  }
+
+  SUBCASE("Empty ranges") {
+    bool called = false;
+    parallelFor(pool, 5, 5, [&](size_t) { called = true; });
+    CHECK(!called);
+    CHECK(parallelReduce(pool, 5, 5, 42, [](size_t i) { return int(i); }, std::plus<int>()) == 42);
+  }
+
+  SUBCASE("Reductions") {
+    std::vector<uint64_t> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto sum = parallelReduce(pool, 0, values.size(), uint64_t(0),
+        [&](size_t i) { return values[i]; }, std::plus<uint64_t>());
+    CHECK(sum == std::accumulate(values.begin(), values.end(), uint64_t(0)));
+
+    auto max = parallelReduce(pool, 0, values.size(), uint64_t(0),
+        [&](size_t i) { return values[i]; },
+        [](uint64_t a, uint64_t b) { return std::max(a, b); }, 33);
+    CHECK(max == 99999u);
+  }
+
+  SUBCASE("Nested loops") {
+    std::atomic_uint counter = 0;
+    parallelFor(pool, 0, 100,
+        [&](size_t) { parallelFor(pool, 0, 100, [&](size_t) { ++counter; }, 10); }, 1);
+    CHECK(counter == 10000u);
+  }
+}
+
+} // namespace Illusion::Core
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/Profiler.hpp>
+
+#include <doctest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Illusion::Core {
+
+namespace {
+Profiler::ZoneStatistics const* findZone(
+    std::vector<Profiler::ZoneStatistics> const& statistics, std::string const& name) {
+  for (auto const& zone : statistics) {
+    if (zone.mName == name) {
+      return &zone;
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+TEST_CASE("Illusion::Core::Profiler") {
+  Profiler::setEnabled(true);
+  Profiler::setFrameWindow(10);
+
+  SUBCASE("Checking nested zones") {
+    for (uint32_t frame(0); frame < 20; ++frame) {
+      {
+        ILLUSION_PROFILE_ZONE("TestProfiler::Frame");
+        for (uint32_t i(0); i < 3; ++i) {
+          ILLUSION_PROFILE_ZONE("TestProfiler::Child");
+        }
+      }
+      Profiler::nextFrame();
+    }
+
+    auto statistics = Profiler::getStatistics();
+    auto frame      = findZone(statistics, "TestProfiler::Frame");
+    auto child      = findZone(statistics, "TestProfiler::Child");
+
+    REQUIRE(frame);
+    REQUIRE(child);
+
+    // Children directly follow their parent.
+    CHECK(child == frame + 1);
+    CHECK(child->mParent == static_cast<uint32_t>(frame - statistics.data()));
+    CHECK(child->mDepth == frame->mDepth + 1);
+
+    CHECK(frame->mFrames == 10);
+    CHECK(frame->mCalls == 1);
+    CHECK(child->mCalls == 3);
+    CHECK(frame->mMin <= frame->mAvg);
+    CHECK(frame->mAvg <= frame->mP99);
+    CHECK(frame->mP99 <= frame->mMax);
+  }
+
+  SUBCASE("Checking zones which span several frames") {
+    {
+      ILLUSION_PROFILE_ZONE("TestProfiler::Outer");
+      Profiler::nextFrame();
+
+      auto statistics = Profiler::getStatistics();
+      auto outer      = findZone(statistics, "TestProfiler::Outer");
+      REQUIRE(outer);
+      CHECK(outer->mFrames == 0);
+
+      ILLUSION_PROFILE_ZONE("TestProfiler::Inner");
+    }
+    Profiler::nextFrame();
+
+    // Zones are evaluated in the frame in which they end.
+    auto statistics = Profiler::getStatistics();
+    auto outer      = findZone(statistics, "TestProfiler::Outer");
+    auto inner      = findZone(statistics, "TestProfiler::Inner");
+    REQUIRE(outer);
+    REQUIRE(inner);
+    CHECK(outer->mFrames == 1);
+    CHECK(inner == outer + 1);
+  }
+
+  SUBCASE("Checking zones of several threads") {
+    std::vector<std::thread> threads;
+    for (uint32_t t(0); t < 4; ++t) {
+      threads.emplace_back([]() {
+        for (uint32_t i(0); i < 100; ++i) {
+          ILLUSION_PROFILE_ZONE("TestProfiler::Thread");
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    Profiler::nextFrame();
+
+    auto statistics = Profiler::getStatistics();
+    auto zone       = findZone(statistics, "TestProfiler::Thread");
+    REQUIRE(zone);
+    CHECK(zone->mCalls == 400);
+    CHECK(zone->mParent == Profiler::NO_PARENT);
+  }
+
+  SUBCASE("Checking full buffers") {
+    uint64_t dropped = Profiler::getDroppedZones();
+
+    for (uint32_t i(0); i < 100000; ++i) {
+      ILLUSION_PROFILE_ZONE("TestProfiler::Overflow");
+    }
+
+    Profiler::nextFrame();
+
+    auto statistics = Profiler::getStatistics();
+    auto zone       = findZone(statistics, "TestProfiler::Overflow");
+    REQUIRE(zone);
+    CHECK(zone->mCalls + Profiler::getDroppedZones() - dropped == 100000);
+  }
+
+  SUBCASE("Recording traces") {
+    const std::string fileName = "TestProfiler.json";
+
+    Profiler::setEnabled(false);
+    Profiler::startRecording(fileName, 2);
+    CHECK(Profiler::isRecording());
+    CHECK(Profiler::isEnabled());
+    CHECK_THROWS(Profiler::startRecording(fileName, 2));
+    CHECK(Profiler::getRemainingRecordedFrames() == 2);
+
+    std::thread thread([]() {
+      Profiler::setThreadName("TestProfiler \"Worker\"");
+      ILLUSION_PROFILE_ZONE("TestProfiler::Worker");
+    });
+    thread.join();
+
+    for (uint32_t frame(0); frame < 3; ++frame) {
+      {
+        ILLUSION_PROFILE_ZONE("TestProfiler::Recorded");
+      }
+      int64_t now = Profiler::getTime();
+      Profiler::addSpan("GPU", "TestProfiler::Pass", now, now + 1000);
+      Profiler::nextFrame();
+      CHECK(Profiler::getRemainingRecordedFrames() == (frame < 2 ? 1 - frame : 0));
+    }
+
+    CHECK(!Profiler::isRecording());
+    CHECK(!Profiler::isEnabled());
+
+    std::ifstream     file(fileName);
+    std::stringstream content;
+    content << file.rdbuf();
+    file.close();
+    std::remove(fileName.c_str());
+
+    std::string json = content.str();
+    CHECK(json.find(R"({"traceEvents":[)") == 0);
+    CHECK(json.find(R"("args":{"name":"TestProfiler \"Worker\""})") != std::string::npos);
+    CHECK(json.find(R"("args":{"name":"GPU"})") != std::string::npos);
+    CHECK(json.find(R"("name":"TestProfiler::Worker","ph":"X")") != std::string::npos);
+    CHECK(json.rfind("]}\n") == json.size() - 3);
+
+    // Only the first two frames have been recorded.
+    size_t count = 0;
+    for (size_t pos = json.find("TestProfiler::Recorded"); pos != std::string::npos;
+         pos        = json.find("TestProfiler::Recorded", pos + 1)) {
+      ++count;
+    }
+    CHECK(count == 2);
+  }
+
+  SUBCASE("Checking disabled profiler") {
+    Profiler::setEnabled(false);
+    {
+      ILLUSION_PROFILE_ZONE("TestProfiler::Disabled");
+    }
+    Profiler::nextFrame();
+
+    auto statistics = Profiler::getStatistics();
+    CHECK(!findZone(statistics, "TestProfiler::Disabled"));
+  }
+
+  Profiler::clearStatistics();
+  Profiler::setEnabled(false);
+}
+
+} // namespace Illusion::Core
@@ -9,6 +9,9 @@
 #include <Illusion/Core/Property.hpp>
 
 #include <doctest.h>
+#include <memory>
+#include <stdexcept>
+#include <thread>
 
 namespace Illusion::Core {
 
@@ -95,6 +98,144 @@ TEST_CASE("Illusion::Core::Property") {
     otherDouble = 42.0;
     CHECK(pDouble.get() == 128.0);
   }
+
+  SUBCASE("Testing PropertyTransactions") {
+    Double   otherDouble;
+    uint32_t changes      = 0;
+    uint32_t otherChanges = 0;
+    double   otherValue   = 0.0;
+
+    otherDouble.connectFrom(pDouble);
+
+    pDouble.onChange().connect([&](double) {
+      ++changes;
+      return true;
+    });
+
+    otherDouble.onChange().connect([&](double value) {
+      ++otherChanges;
+      otherValue = value;
+      return true;
+    });
+
+    {
+      PropertyTransaction transaction;
+      CHECK(PropertyTransaction::isActive());
+
+      for (uint32_t i(1); i <= 10; ++i) {
+        pDouble = i;
+
+        // Nested transactions do not emit anything.
+        PropertyTransaction nested;
+        pDouble.touch();
+      }
+
+      // The value is changed immediately, but nothing has been emitted yet.
+      CHECK(pDouble.get() == 10.0);
+      CHECK(otherDouble.get() == 0.0);
+      CHECK(changes == 0);
+    }
+
+    CHECK(!PropertyTransaction::isActive());
+
+    // Now the connected Property has been updated as well - with one notification only. The final
+    // value should be passed to the callbacks.
+    CHECK(otherDouble.get() == 10.0);
+    CHECK(otherValue == 10.0);
+    CHECK(changes == 1);
+    CHECK(otherChanges == 1);
+
+    // Properties may be destroyed during a transaction.
+    {
+      PropertyTransaction transaction;
+      Double              temporary;
+      temporary = 42.0;
+    }
+
+    // Without a transaction, each change is emitted.
+    pDouble = 1.0;
+    pDouble = 2.0;
+    CHECK(changes == 3);
+  }
+
+  SUBCASE("Testing PropertyTransactions which restore the value") {
+    uint32_t changes = 0;
+
+    pDouble = 1.0;
+    pDouble.onChange().connect([&](double) {
+      ++changes;
+      return true;
+    });
+
+    // Setting a Property back to its original value does not emit anything.
+    {
+      PropertyTransaction transaction;
+      pDouble = 2.0;
+      pDouble = 1.0;
+    }
+
+    CHECK(changes == 0);
+
+    // Unless it has been touched.
+    {
+      PropertyTransaction transaction;
+      pDouble = 2.0;
+      pDouble.touch();
+      pDouble = 1.0;
+    }
+
+    CHECK(changes == 1);
+  }
+
+  SUBCASE("Testing PropertyTransactions with throwing callbacks") {
+    Double otherDouble;
+    double otherValue = 0.0;
+
+    pDouble.onChange().connect([](double) -> bool { throw std::runtime_error("Failure!"); });
+    otherDouble.onChange().connect([&](double value) {
+      otherValue = value;
+      return true;
+    });
+
+    // commit() rethrows the exception once all Properties have emitted their signals.
+    {
+      PropertyTransaction transaction;
+      pDouble     = 1.0;
+      otherDouble = 2.0;
+      CHECK_THROWS(transaction.commit());
+      CHECK(!PropertyTransaction::isActive());
+      CHECK(otherValue == 2.0);
+    }
+
+    // The destructor discards the exception.
+    {
+      PropertyTransaction transaction;
+      pDouble     = 2.0;
+      otherDouble = 3.0;
+    }
+
+    CHECK(!PropertyTransaction::isActive());
+    CHECK(otherValue == 3.0);
+  }
+
+  SUBCASE("Testing Properties which are destroyed on another thread") {
+    auto     temporary = std::make_unique<Double>();
+    uint32_t changes   = 0;
+
+    pDouble.onChange().connect([&](double) {
+      ++changes;
+      return true;
+    });
+
+    PropertyTransaction transaction;
+    *temporary = 1.0;
+    pDouble    = 1.0;
+
+    std::thread([&temporary]() { temporary.reset(); }).join();
+
+    transaction.commit();
+    CHECK(changes == 1);
+  }
 }
 
 } // namespace Illusion::Core
@@ -9,6 +9,9 @@
 #include <Illusion/Core/Signal.hpp>
 
 #include <doctest.h>
+#include <memory>
+#include <stdexcept>
+#include <thread>
 
 namespace Illusion::Core {
 
@@ -83,6 +86,78 @@ TEST_CASE("Illusion::Core::Signal") {
     simpleSignal.emit();
 
     CHECK(count == 1);
+    CHECK(simpleSignal.getConnectionCount() == 0);
+  }
+
+  SUBCASE("Testing Signal modifications from within callbacks") {
+    uint32_t count = 0;
+
+    // This callback connects another callback and emits the signal once more. This must neither
+    // deadlock nor call the new callback in the current emit().
+    simpleSignal.connect([&]() {
+      if (++count == 1) {
+        simpleSignal.connect([&]() {
+          count += 10;
+          return true;
+        });
+        simpleSignal.emit();
+      }
+      return true;
+    });
+
+    simpleSignal.emit();
+
+    CHECK(count == 12);
+    CHECK(simpleSignal.getConnectionCount() == 2);
+  }
+
+  SUBCASE("Testing Signal callbacks which throw") {
+    auto data = std::make_shared<int>(0);
+
+    auto id = simpleSignal.connect([data]() -> bool { throw std::runtime_error("Foo"); });
+    CHECK_THROWS_AS(simpleSignal.emit(), std::runtime_error);
+
+    // The list containing the callback can only be deleted if the throwing emit() is not
+    // considered to be running anymore.
+    simpleSignal.disconnect(id);
+    CHECK(data.use_count() == 1);
+  }
+
+  SUBCASE("Testing release of callbacks which disconnect themselves") {
+    auto data = std::make_shared<int>(0);
+
+    // The list containing the callback is replaced while it is used by emit(). Its captures have
+    // to be released once the emit() has finished, even if nothing is connected afterwards.
+    simpleSignal.connect([data]() { return false; });
+    simpleSignal.emit();
+    CHECK(simpleSignal.getConnectionCount() == 0);
+    CHECK(data.use_count() == 1);
+  }
+
+  SUBCASE("Testing concurrent emit and connect") {
+    std::atomic_uint count = 0;
+
+    simpleSignal.connect([&]() {
+      ++count;
+      return true;
+    });
+
+    // One thread emits while the other connects and disconnects other callbacks.
+    std::thread emitter([&]() {
+      for (uint32_t i(0); i < 1000; ++i) {
+        simpleSignal.emit();
+      }
+    });
+
+    for (uint32_t i(0); i < 1000; ++i) {
+      auto id = simpleSignal.connect([]() { return true; });
+      simpleSignal.disconnect(id);
+    }
+
+    emitter.join();
+
+    CHECK(count == 1000u);
+    CHECK(simpleSignal.getConnectionCount() == 1);
   }
 }
 
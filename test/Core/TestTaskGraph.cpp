@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/TaskGraph.hpp>
+
+#include <doctest.h>
+#include <stdexcept>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::TaskGraph") {
+  ThreadPool pool(4, ThreadPool::Scheduling::eWorkStealing);
+  TaskGraph  graph(pool);
+
+  SUBCASE("Dependencies are respected") {
+
+    // A diamond: a -> (b, c) -> d. Each node stores the step in which it was executed.
+    std::atomic_uint step = 0;
+    uint32_t         a = 0, b = 0, c = 0, d = 0;
+
+    auto nodeA = graph.addNode([&]() { a = ++step; });
+    auto nodeB = graph.addNode([&]() { b = ++step; });
+    auto nodeC = graph.addNode([&]() { c = ++step; });
+    auto nodeD = graph.addNode([&]() { d = ++step; });
+
+    graph.addDependency(nodeA, nodeB);
+    graph.addDependency(nodeA, nodeC);
+    graph.addDependency(nodeB, nodeD);
+    graph.addDependency(nodeC, nodeD);
+
+    CHECK(graph.getNodeCount() == 4);
+
+    // The graph can be executed multiple times.
+    for (uint32_t i(0); i < 10; ++i) {
+      step = 0;
+      graph.execute();
+
+      CHECK(a == 1);
+      CHECK(b > a);
+      CHECK(c > a);
+      CHECK(d == 4);
+    }
+  }
+
+  SUBCASE("Wide graphs") {
+    std::atomic_uint counter = 0;
+    uint32_t         seen    = 0;
+    auto             root    = graph.addNode([]() {});
+    auto             sink    = graph.addNode([&]() { seen = counter; });
+
+    for (uint32_t i(0); i < 1000; ++i) {
+      auto node = graph.addNode([&]() { ++counter; });
+      graph.addDependency(root, node);
+      graph.addDependency(node, sink);
+    }
+
+    graph.execute();
+    CHECK(counter == 1000u);
+    CHECK(seen == 1000u);
+  }
+
+  SUBCASE("Cycles are detected") {
+    auto nodeA = graph.addNode([]() {});
+    auto nodeB = graph.addNode([]() {});
+    graph.addDependency(nodeA, nodeB);
+    graph.addDependency(nodeB, nodeA);
+
+    CHECK_THROWS(graph.run());
+    CHECK_THROWS(graph.addDependency(nodeA, 42));
+  }
+
+  SUBCASE("Exceptions skip the successors") {
+    bool executed = false;
+    auto nodeA    = graph.addNode([]() { throw std::runtime_error("Failure!"); });
+    auto nodeB    = graph.addNode([&]() { executed = true; });
+    graph.addDependency(nodeA, nodeB);
+
+    CHECK_THROWS(graph.execute());
+    CHECK(!executed);
+  }
+}
+
+} // namespace Illusion::Core
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Core/TaskGroup.hpp>
+
+#include <doctest.h>
+#include <stdexcept>
+
+namespace Illusion::Core {
+
+TEST_CASE("Illusion::Core::TaskGroup") {
+
+  // A single thread is enough to run nested groups, as the waiting thread executes the pending
+  // tasks itself.
+  ThreadPool pool(1, ThreadPool::Scheduling::eWorkStealing);
+
+  SUBCASE("Waiting for tasks") {
+    std::atomic_uint counter = 0;
+    TaskGroup        group(pool);
+
+    for (uint32_t i(0); i < 1000; ++i) {
+      group.run([&]() { ++counter; });
+    }
+
+    group.wait();
+    CHECK(group.isDone());
+    CHECK(counter == 1000u);
+  }
+
+  SUBCASE("Nested groups") {
+    std::atomic_uint counter = 0;
+    TaskGroup        outer(pool);
+
+    for (uint32_t i(0); i < 10; ++i) {
+      outer.run([&]() {
+        TaskGroup inner(pool);
+        for (uint32_t j(0); j < 10; ++j) {
+          inner.run([&]() { ++counter; });
+        }
+        inner.wait();
+      });
+    }
+
+    outer.wait();
+    CHECK(counter == 100u);
+  }
+
+  SUBCASE("Exceptions are rethrown by wait()") {
+    TaskGroup group(pool);
+    group.run([]() { throw std::runtime_error("Failure!"); });
+    CHECK_THROWS(group.wait());
+
+    // The exception is only thrown once.
+    CHECK_NOTHROW(group.wait());
+  }
+
+  SUBCASE("The calling thread helps in waitIdle()") {
+    std::atomic_uint counter = 0;
+    pool.setThreadCount(2);
+
+    for (uint32_t i(0); i < 1000; ++i) {
+      pool.enqueue([&]() { ++counter; });
+    }
+
+    pool.waitIdle();
+    CHECK(counter == 1000u);
+    CHECK(pool.getPendingTasks() == 0);
+  }
+}
+
+} // namespace Illusion::Core
@@ -8,9 +8,13 @@
 
 #include <Illusion/Core/ThreadPool.hpp>
 
+#include <array>
+#include <cstdint>
 #include <doctest.h>
-#include <iostream>
+#include <future>
 #include <random>
+#include <stdexcept>
+#include <vector>
 
 namespace Illusion::Core {
 
@@ -50,4 +54,121 @@ TEST_CASE("Illusion::Core::ThreadPool") {
   CHECK(counter == 1000u);
 }
 
+TEST_CASE("Illusion::Core::ThreadPool work stealing") {
+  ThreadPool pool(4, ThreadPool::Scheduling::eWorkStealing);
+  CHECK(pool.getThreadCount() == 4);
+  CHECK(pool.getScheduling() == ThreadPool::Scheduling::eWorkStealing);
+
+  // Each outer task enqueues some inner tasks. These are pushed to the deque of the worker and may
+  // be stolen by the other workers.
+  std::atomic_uint counter = 0;
+  for (uint32_t i(0); i < 100; ++i) {
+    pool.enqueue([&]() {
+      for (uint32_t j(0); j < 100; ++j) {
+        pool.enqueue([&]() { ++counter; });
+      }
+    });
+  }
+
+  pool.waitIdle();
+
+  CHECK(counter == 10000u);
+  CHECK(pool.getRunningTasks() == 0);
+  CHECK(pool.getPendingTasks() == 0);
+
+  SUBCASE("Tasks survive a change of the thread count") {
+    counter = 0;
+    for (uint32_t i(0); i < 100; ++i) {
+      pool.enqueue([&]() {
+        for (uint32_t j(0); j < 10; ++j) {
+          pool.enqueue([&]() { ++counter; });
+        }
+      });
+    }
+
+    pool.setThreadCount(2);
+    pool.waitIdle();
+
+    CHECK(counter == 1000u);
+  }
+
+  SUBCASE("Futures return the task results") {
+    auto result = pool.enqueue([&pool]() { return pool.enqueue([]() { return 42; }).get(); });
+    CHECK(result.get() == 42);
+  }
+}
+
+TEST_CASE("Illusion::Core::ThreadPool allocation-free submission") {
+  ThreadPool pool(4, ThreadPool::Scheduling::eWorkStealing);
+
+  std::atomic_uint counter = 0;
+
+  // This simulates one frame: Some fire-and-forget tasks and some tasks returning a result.
+  auto frame = [&]() {
+    for (uint32_t i(0); i < 1000; ++i) {
+      pool.submit([&counter]() { ++counter; });
+    }
+
+    std::vector<std::future<uint32_t>> results;
+    results.reserve(100);
+    for (uint32_t i(0); i < 100; ++i) {
+      results.push_back(pool.enqueue([i]() { return i; }));
+    }
+
+    uint32_t sum = 0;
+    for (auto& result : results) {
+      sum += result.get();
+    }
+
+    pool.waitIdle();
+
+    return sum;
+  };
+
+  // The first frames may allocate, the queues and the BlockPool have to grow.
+  for (uint32_t i(0); i < 10; ++i) {
+    frame();
+  }
+
+  // Now the queues and the BlockPools of the std::promises should not grow anymore.
+  size_t   blocksBefore   = BlockPoolStatistics::getAllocatedBlocks();
+  size_t   capacityBefore = pool.getQueueCapacity();
+  uint32_t sum            = frame();
+
+  CHECK(sum == 4950u);
+  CHECK(counter == 11000u);
+  CHECK(BlockPoolStatistics::getAllocatedBlocks() == blocksBefore);
+  CHECK(pool.getQueueCapacity() == capacityBefore);
+
+  SUBCASE("BlockPools recycle their blocks") {
+    PoolAllocator<std::array<uint8_t, 123>> allocator;
+
+    size_t before = BlockPoolStatistics::getAllocatedBlocks();
+    auto   first  = allocator.allocate(1);
+    allocator.deallocate(first, 1);
+    auto second = allocator.allocate(1);
+    allocator.deallocate(second, 1);
+
+    CHECK(first == second);
+    CHECK(BlockPoolStatistics::getAllocatedBlocks() - before == 1u);
+  }
+
+  SUBCASE("Small callables are stored inline") {
+    auto small = [&counter]() { ++counter; };
+    auto large = [&counter, data = std::array<uint8_t, 64>()]() { counter += data[0]; };
+
+    // This resembles the wrapper which is created by enqueue().
+    auto promise = [p = std::promise<uint32_t>(), i = 0u]() mutable { p.set_value(i); };
+
+    CHECK(Task::isInline<decltype(small)>());
+    CHECK(Task::isInline<decltype(promise)>());
+    CHECK(!Task::isInline<decltype(large)>());
+  }
+
+  SUBCASE("Exceptions are stored in the futures") {
+    auto result = pool.enqueue([]() -> int { throw std::runtime_error("Failure!"); });
+    CHECK_THROWS(result.get());
+  }
+}
+
 } // namespace Illusion::Core
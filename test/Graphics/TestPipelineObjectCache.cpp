@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//    _)  |  |            _)                This code may be used and modified under the terms    //
+//     |  |  |  |  | (_-<  |   _ \    \     of the MIT license. See the LICENSE file for details. //
+//    _| _| _| \_,_| ___/ _| \___/ _| _|    Copyright (c) 2018-2019 Simon Schneegans              //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <Illusion/Graphics/PipelineObjectCache.hpp>
+
+#include <doctest.h>
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace Illusion::Graphics {
+
+namespace {
+Core::BitHash makeHash(uint32_t value) {
+  Core::BitHash hash;
+  hash.push<32>(value);
+  return hash;
+}
+
+// The PipelineObjectCache never accesses the Vulkan objects, so empty handles are sufficient.
+vk::PipelinePtr makePipeline() {
+  return std::make_shared<const vk::Pipeline>();
+}
+} // namespace
+
+TEST_CASE("Illusion::Graphics::PipelineObjectCache") {
+  auto             cache = std::make_shared<PipelineObjectCache>();
+  Core::ThreadPool pool(2);
+
+  // Redirect cout to a ostringstream as failed pipelines generate errors.
+  std::ostringstream oss;
+  auto               coutBuffer = std::cout.rdbuf();
+  std::cout.rdbuf(oss.rdbuf());
+
+  SUBCASE("Creating pipelines asynchronously") {
+    auto             hash = makeHash(1);
+    std::atomic_uint calls{0};
+    std::atomic_bool finish{false};
+
+    auto create = [&]() {
+      ++calls;
+      while (!finish) {
+        std::this_thread::yield();
+      }
+      return makePipeline();
+    };
+
+    // While the pipeline is created, it is not submitted again.
+    CHECK(!cache->createAsync(hash, pool, create, {}));
+    CHECK(!cache->createAsync(hash, pool, create, {}));
+    CHECK(cache->isPending(hash));
+    CHECK(cache->getPendingCount() == 1);
+    CHECK(cache->contains(hash));
+    CHECK(!cache->get(hash));
+
+    finish = true;
+    pool.waitIdle();
+
+    CHECK(calls == 1u);
+    CHECK(!cache->isPending(hash));
+
+    // The pipeline is kept alive until it has been retrieved once.
+    auto pipeline = cache->get(hash);
+    CHECK(pipeline);
+    CHECK(cache->createAsync(hash, pool, create, {}) == pipeline);
+    CHECK(cache->getSize() == 1);
+
+    pipeline.reset();
+    CHECK(cache->getSize() == 0);
+    CHECK(!cache->contains(hash));
+  }
+
+  SUBCASE("Failed pipelines are not created again") {
+    auto             hash   = makeHash(2);
+    auto             module = std::make_shared<const vk::ShaderModule>();
+    std::atomic_uint calls{0};
+
+    // Exceptions which are not derived from std::exception have to be caught as well.
+    auto fail = [&]() -> vk::PipelinePtr {
+      ++calls;
+      throw 42;
+    };
+
+    CHECK(!cache->createAsync(hash, pool, fail, {module}));
+    pool.waitIdle();
+
+    CHECK(!cache->isPending(hash));
+    CHECK(cache->isFailed(hash));
+    CHECK(cache->contains(hash));
+    CHECK(!cache->get(hash));
+
+    CHECK(!cache->createAsync(hash, pool, fail, {module}));
+    pool.waitIdle();
+    CHECK(calls == 1u);
+
+    // Once the ShaderModule is deleted, the failure is forgotten.
+    module.reset();
+    CHECK(!cache->isFailed(hash));
+    CHECK(!cache->contains(hash));
+
+    CHECK(!cache->createAsync(hash, pool, makePipeline, {}));
+    pool.waitIdle();
+    CHECK(cache->get(hash));
+  }
+
+  SUBCASE("Preparing pipelines") {
+    auto hash     = makeHash(3);
+    auto pipeline = makePipeline();
+
+    CHECK(!cache->contains(hash));
+    CHECK(cache->prepare(hash, pipeline, {}));
+    CHECK(!cache->prepare(hash, makePipeline(), {}));
+
+    // The prepared pipeline is kept alive by the cache.
+    auto const* address = pipeline.get();
+    pipeline.reset();
+    CHECK(cache->contains(hash));
+    CHECK(cache->getSize() == 1);
+
+    pipeline = cache->get(hash);
+    CHECK(pipeline.get() == address);
+
+    pipeline.reset();
+    CHECK(!cache->contains(hash));
+  }
+
+  SUBCASE("Prepared pipelines of deleted ShaderModules are removed") {
+    auto module = std::make_shared<const vk::ShaderModule>();
+
+    // Expired entries are removed whenever the number of entries has doubled.
+    for (uint32_t i(0); i < 100; ++i) {
+      CHECK(cache->prepare(makeHash(i), makePipeline(), {module}));
+    }
+    CHECK(cache->getSize() == 100);
+
+    module.reset();
+
+    auto other = std::make_shared<const vk::ShaderModule>();
+    for (uint32_t i(100); i < 200; ++i) {
+      CHECK(cache->prepare(makeHash(i), makePipeline(), {other}));
+    }
+    CHECK(cache->getSize() == 100);
+    CHECK(!cache->contains(makeHash(0)));
+    CHECK(cache->contains(makeHash(100)));
+  }
+
+  SUBCASE("Concurrent access") {
+    std::vector<std::thread> threads;
+    for (uint32_t t(0); t < 4; ++t) {
+      threads.emplace_back([&cache, &pool]() {
+        std::vector<vk::PipelinePtr> pipelines;
+        for (uint32_t i(0); i < 2000; ++i) {
+          auto hash = makeHash(i % 37);
+          if (auto pipeline = cache->createAsync(hash, pool, makePipeline, {})) {
+            pipelines.push_back(pipeline);
+          }
+          cache->prepare(makeHash(100 + i % 37), makePipeline(), {});
+          cache->add(makeHash(200 + i % 37), makePipeline());
+          cache->contains(hash);
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    pool.waitIdle();
+
+    CHECK(cache->getPendingCount() == 0);
+    for (uint32_t i(0); i < 37; ++i) {
+      CHECK(!cache->isPending(makeHash(i)));
+      CHECK(!cache->isFailed(makeHash(i)));
+    }
+  }
+
+  // Restore normal cout behavior.
+  std::cout.rdbuf(coutBuffer);
+}
+
+} // namespace Illusion::Graphics